@@ -24,6 +24,172 @@ static unsigned int dummy_keyboard_underglow_map[3][10] =
       {   10,  11,  12,  13,  14,  15,  16,  17,  18,  19 },
       {   20,  21,  22,  23,  24,  25,  26,  27,  28,  29 } };
 
+/*-----------------------------------------------------*\
+| Device types cycled through by the device farm        |
+\*-----------------------------------------------------*/
+static const device_type debug_farm_types[] =
+{
+    DEVICE_TYPE_MOTHERBOARD,
+    DEVICE_TYPE_DRAM,
+    DEVICE_TYPE_GPU,
+    DEVICE_TYPE_COOLER,
+    DEVICE_TYPE_LEDSTRIP,
+    DEVICE_TYPE_KEYBOARD,
+    DEVICE_TYPE_MOUSE,
+    DEVICE_TYPE_LIGHT,
+};
+
+static unsigned int GetFarmSetting(const json& farm_settings, const char* key, unsigned int default_value)
+{
+    if(farm_settings.contains(key) && farm_settings[key].is_number_unsigned())
+    {
+        return(farm_settings[key]);
+    }
+
+    return(default_value);
+}
+
+/******************************************************************************************\
+*                                                                                          *
+*   DetectDebugFarm                                                                        *
+*                                                                                          *
+*       Add a large number of synthetic controllers for load testing, based on the farm    *
+*       key in the DebugDevices settings:                                                  *
+*                                                                                          *
+*       "farm":                                                                            *
+*       {                                                                                  *
+*           "count"             : 1000,     number of controllers                          *
+*           "zones"             : 4,        linear zones per controller                    *
+*           "leds_per_zone"     : 16,       LEDs per linear zone                           *
+*           "matrix_width"      : 0,        adds a matrix zone of this size if both        *
+*           "matrix_height"     : 0,        are non-zero                                   *
+*           "modes"             : 1,        Direct plus modes - 1 effect modes             *
+*           "update_latency_us" : 0         time spent in each device update               *
+*       }                                                                                  *
+*                                                                                          *
+\******************************************************************************************/
+
+static void DetectDebugFarm(const json& farm_settings)
+{
+    unsigned int count              = GetFarmSetting(farm_settings, "count",             0);
+    unsigned int zone_count         = GetFarmSetting(farm_settings, "zones",             1);
+    unsigned int leds_per_zone      = GetFarmSetting(farm_settings, "leds_per_zone",     10);
+    unsigned int matrix_width       = GetFarmSetting(farm_settings, "matrix_width",      0);
+    unsigned int matrix_height      = GetFarmSetting(farm_settings, "matrix_height",     0);
+    unsigned int mode_count         = GetFarmSetting(farm_settings, "modes",             1);
+    unsigned int update_latency_us  = GetFarmSetting(farm_settings, "update_latency_us", 0);
+
+    for(unsigned int device_idx = 0; device_idx < count; device_idx++)
+    {
+        RGBController_Debug* dummy_farm = new RGBController_Debug();
+
+        std::string device_number   = std::to_string(device_idx);
+
+        dummy_farm->name            = "Debug Farm Device " + device_number;
+        dummy_farm->type            = debug_farm_types[device_idx % (sizeof(debug_farm_types) / sizeof(debug_farm_types[0]))];
+        dummy_farm->description     = "Debug Farm Device";
+        dummy_farm->location        = "Debug Farm Location " + device_number;
+        dummy_farm->version         = "Debug Farm Version";
+        dummy_farm->serial          = "Debug Farm Serial " + device_number;
+
+        /*---------------------------------------------------------*\
+        | Create a direct mode followed by the effect modes         |
+        \*---------------------------------------------------------*/
+        mode dummy_farm_direct_mode;
+
+        dummy_farm_direct_mode.name         = "Direct";
+        dummy_farm_direct_mode.value        = 0;
+        dummy_farm_direct_mode.flags        = MODE_FLAG_HAS_PER_LED_COLOR;
+        dummy_farm_direct_mode.color_mode   = MODE_COLORS_PER_LED;
+
+        dummy_farm->modes.push_back(dummy_farm_direct_mode);
+
+        for(unsigned int mode_idx = 1; mode_idx < mode_count; mode_idx++)
+        {
+            mode dummy_farm_effect_mode;
+
+            dummy_farm_effect_mode.name         = "Debug Effect " + std::to_string(mode_idx);
+            dummy_farm_effect_mode.value        = mode_idx;
+            dummy_farm_effect_mode.flags        = MODE_FLAG_HAS_SPEED | MODE_FLAG_HAS_MODE_SPECIFIC_COLOR;
+            dummy_farm_effect_mode.speed_min    = 0;
+            dummy_farm_effect_mode.speed_max    = 100;
+            dummy_farm_effect_mode.speed        = 50;
+            dummy_farm_effect_mode.colors_min   = 1;
+            dummy_farm_effect_mode.colors_max   = 1;
+            dummy_farm_effect_mode.color_mode   = MODE_COLORS_MODE_SPECIFIC;
+            dummy_farm_effect_mode.colors.resize(1);
+
+            dummy_farm->modes.push_back(dummy_farm_effect_mode);
+        }
+
+        /*---------------------------------------------------------*\
+        | Create the linear zones                                   |
+        \*---------------------------------------------------------*/
+        for(unsigned int zone_idx = 0; zone_idx < zone_count; zone_idx++)
+        {
+            zone dummy_farm_linear_zone;
+
+            dummy_farm_linear_zone.name         = "Linear Zone " + std::to_string(zone_idx);
+            dummy_farm_linear_zone.type         = ZONE_TYPE_LINEAR;
+            dummy_farm_linear_zone.leds_min     = leds_per_zone;
+            dummy_farm_linear_zone.leds_max     = leds_per_zone;
+            dummy_farm_linear_zone.leds_count   = leds_per_zone;
+            dummy_farm_linear_zone.matrix_map   = NULL;
+
+            dummy_farm->zones.push_back(dummy_farm_linear_zone);
+
+            for(unsigned int led_idx = 0; led_idx < leds_per_zone; led_idx++)
+            {
+                led dummy_farm_linear_led;
+
+                dummy_farm_linear_led.name      = "Linear LED " + std::to_string(led_idx);
+
+                dummy_farm->leds.push_back(dummy_farm_linear_led);
+            }
+        }
+
+        /*---------------------------------------------------------*\
+        | Create the matrix zone, if configured                     |
+        \*---------------------------------------------------------*/
+        if(matrix_width > 0 && matrix_height > 0)
+        {
+            zone dummy_farm_matrix_zone;
+
+            dummy_farm_matrix_zone.name         = "Matrix Zone";
+            dummy_farm_matrix_zone.type         = ZONE_TYPE_MATRIX;
+            dummy_farm_matrix_zone.leds_min     = matrix_width * matrix_height;
+            dummy_farm_matrix_zone.leds_max     = matrix_width * matrix_height;
+            dummy_farm_matrix_zone.leds_count   = matrix_width * matrix_height;
+            dummy_farm_matrix_zone.matrix_map   = new matrix_map_type;
+
+            dummy_farm_matrix_zone.matrix_map->width    = matrix_width;
+            dummy_farm_matrix_zone.matrix_map->height   = matrix_height;
+            dummy_farm_matrix_zone.matrix_map->map      = new unsigned int[matrix_width * matrix_height];
+
+            for(unsigned int led_idx = 0; led_idx < matrix_width * matrix_height; led_idx++)
+            {
+                led dummy_farm_matrix_led;
+
+                dummy_farm_matrix_led.name      = "Matrix LED " + std::to_string(led_idx);
+
+                dummy_farm->leds.push_back(dummy_farm_matrix_led);
+
+                dummy_farm_matrix_zone.matrix_map->map[led_idx] = led_idx;
+            }
+
+            dummy_farm->zones.push_back(dummy_farm_matrix_zone);
+        }
+
+        dummy_farm->SetupColors();
+        dummy_farm->SetUpdateLatency(update_latency_us);
+
+        /*---------------------------------------------------------*\
+        | Push the farm device onto the controller list             |
+        \*---------------------------------------------------------*/
+        ResourceManager::get()->RegisterRGBController(dummy_farm);
+    }
+}
+
 /******************************************************************************************\
 *                                                                                          *
 *   DetectDebugControllers                                                                 *
@@ -729,6 +895,15 @@ void DetectDebugControllers()
         }
     }
 
+    /*-------------------------------------------------*\
+    | If the Debug settings contains a device farm,     |
+    | create the synthetic controllers                  |
+    \*-------------------------------------------------*/
+    if(debug_settings.contains("farm"))
+    {
+        DetectDebugFarm(debug_settings["farm"]);
+    }
+
 }   /* DetectDebugControllers() */
 
 REGISTER_DETECTOR("Debug Controllers", DetectDebugControllers);
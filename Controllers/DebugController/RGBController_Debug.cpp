@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <thread>
 
 /**------------------------------------------------------------------*\
     @name Debug
@@ -16,7 +17,9 @@
 
 RGBController_Debug::RGBController_Debug()
 {
-
+    update_latency      = std::chrono::microseconds(0);
+    update_count        = 0;
+    last_update_time    = std::chrono::steady_clock::time_point();
 }
 
 void RGBController_Debug::ResizeZone(int index, int new_size)
@@ -58,3 +61,49 @@ void RGBController_Debug::ResizeZone(int index, int new_size)
 
     SetupColors();
 }
+
+void RGBController_Debug::DeviceUpdateLEDs()
+{
+    SimulateUpdate();
+}
+
+void RGBController_Debug::UpdateZoneLEDs(int /*zone*/)
+{
+    SimulateUpdate();
+}
+
+void RGBController_Debug::UpdateSingleLED(int /*led*/)
+{
+    SimulateUpdate();
+}
+
+void RGBController_Debug::DeviceUpdateMode()
+{
+    SimulateUpdate();
+}
+
+void RGBController_Debug::SetUpdateLatency(unsigned int latency_us)
+{
+    update_latency = std::chrono::microseconds(latency_us);
+}
+
+unsigned int RGBController_Debug::GetUpdateCount()
+{
+    return(update_count.load());
+}
+
+std::chrono::steady_clock::time_point RGBController_Debug::GetLastUpdateTime()
+{
+    return(last_update_time.load());
+}
+
+void RGBController_Debug::SimulateUpdate()
+{
+    last_update_time = std::chrono::steady_clock::now();
+    update_count++;
+
+    if(update_latency.count() > 0)
+    {
+        std::this_thread::sleep_for(update_latency);
+    }
+}
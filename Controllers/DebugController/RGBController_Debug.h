@@ -2,6 +2,8 @@
 #define RGBCONTROLLER_DEBUG_H
 
 #include "RGBController_Dummy.h"
+#include <atomic>
+#include <chrono>
 
 // A variation of Dummy controller that allows the zones to be resized
 
@@ -10,6 +12,25 @@ class RGBController_Debug : public RGBController_Dummy
 public:
     RGBController_Debug();
     void ResizeZone(int zone, int newSize) override;
+
+    void DeviceUpdateLEDs() override;
+    void UpdateZoneLEDs(int zone) override;
+    void UpdateSingleLED(int led) override;
+    void DeviceUpdateMode() override;
+
+    // Artificial time spent in each device update, to simulate a slow bus
+    void SetUpdateLatency(unsigned int latency_us);
+
+    // Number of device updates and the time the last one started
+    unsigned int                            GetUpdateCount();
+    std::chrono::steady_clock::time_point   GetLastUpdateTime();
+
+private:
+    std::chrono::microseconds                           update_latency;
+    std::atomic<unsigned int>                           update_count;
+    std::atomic<std::chrono::steady_clock::time_point>  last_update_time;
+
+    void SimulateUpdate();
 };
 
 #endif // RGBCONTROLLER_DEBUG_H
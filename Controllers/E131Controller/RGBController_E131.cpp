@@ -8,8 +8,13 @@
 \*-----------------------------------------*/
 
 #include "RGBController_E131.h"
+#include "RGBColorPack.h"
+#include "LogManager.h"
 #include <e131.h>
 #include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
 
 using namespace std::chrono_literals;
 
@@ -294,6 +299,11 @@ RGBController_E131::RGBController_E131(std::vector<E131Device> device_list)
         }
     }
 
+    /*-----------------------------------------*\
+    | Build the LED to packet channel mapping   |
+    \*-----------------------------------------*/
+    SetupPackTable();
+
     if(keepalive_delay.count() > 0)
     {
         keepalive_thread_run = 1;
@@ -376,78 +386,280 @@ void RGBController_E131::ResizeZone(int /*zone*/, int /*new_size*/)
     \*---------------------------------------------------------*/
 }
 
-void RGBController_E131::DeviceUpdateLEDs()
+void RGBController_E131::SetupPackTable()
 {
-    int color_idx = 0;
+    /*-----------------------------------------*\
+    | Map each universe to its packet index     |
+    \*-----------------------------------------*/
+    std::map<unsigned int, unsigned int> universe_packets;
+
+    for(std::size_t packet_idx = 0; packet_idx < packets.size(); packet_idx++)
+    {
+        universe_packets[universes[packet_idx]] = (unsigned int)packet_idx;
+    }
 
-    last_update_time = std::chrono::steady_clock::now();
+    pack_runs.clear();
+    pack_bytes.clear();
+
+    unsigned int color_idx = 0;
 
     for(std::size_t device_idx = 0; device_idx < devices.size(); device_idx++)
     {
-        float universe_size = devices[device_idx].universe_size;
-        unsigned int total_universes = ceil( ( ( devices[device_idx].num_leds * 3 ) + devices[device_idx].start_channel ) / universe_size );
-        unsigned int channel_idx = devices[device_idx].start_channel;
-        unsigned int led_idx = 0;
-        unsigned int rgb_idx = 0;
-        bool         done = false;
+        unsigned int universe_size  = devices[device_idx].universe_size;
+        unsigned int universe       = devices[device_idx].start_universe;
+        unsigned int channel_idx    = devices[device_idx].start_channel;
+        unsigned int led_idx        = 0;
 
-        for (unsigned int univ_idx = 0; univ_idx < total_universes; univ_idx++)
+        while(led_idx < devices[device_idx].num_leds)
         {
-            unsigned int universe = devices[device_idx].start_universe + univ_idx;
+            /*-------------------------------------*\
+            | Move on to the next universe when the |
+            | current one is full                   |
+            \*-------------------------------------*/
+            if(channel_idx > universe_size)
+            {
+                universe++;
+                channel_idx = 1;
+            }
 
-            for(std::size_t packet_idx = 0; packet_idx < packets.size(); packet_idx++)
+            std::map<unsigned int, unsigned int>::iterator packet_it = universe_packets.find(universe);
+
+            /*-------------------------------------*\
+            | Pack as many whole LEDs as fit in the |
+            | remainder of this universe as one run |
+            \*-------------------------------------*/
+            unsigned int leds_fit   = (universe_size + 1 - channel_idx) / 3;
+            unsigned int leds_run   = std::min(leds_fit, devices[device_idx].num_leds - led_idx);
+
+            if(leds_run > 0)
             {
-                if(!done && (universes[packet_idx] == universe))
+                /*---------------------------------*\
+                | LEDs in a universe without a      |
+                | packet are skipped                |
+                \*---------------------------------*/
+                if(packet_it != universe_packets.end())
                 {
-                    while(!done && (channel_idx <= universe_size))
-                    {
-                        switch(rgb_idx)
-                        {
-                            case 0:
-                                packets[packet_idx].dmp.prop_val[channel_idx] = RGBGetRValue( colors[color_idx] );
-                                rgb_idx = 1;
-                                break;
-                            case 1:
-                                packets[packet_idx].dmp.prop_val[channel_idx] = RGBGetGValue( colors[color_idx] );
-                                rgb_idx = 2;
-                                break;
-                            case 2:
-                                packets[packet_idx].dmp.prop_val[channel_idx] = RGBGetBValue( colors[color_idx] );
-                                rgb_idx = 0;
-                                led_idx++;
-                                color_idx++;
-                                break;
-                        }
+                    E131PackRun run;
 
-                        if(led_idx >= devices[device_idx].num_leds)
-                        {
-                            done = true;
-                        }
+                    run.packet_idx  = packet_it->second;
+                    run.channel     = channel_idx;
+                    run.color_idx   = color_idx;
+                    run.leds_count  = leds_run;
 
-                        channel_idx++;
-                    }
+                    pack_runs.push_back(run);
+                }
+
+                channel_idx    += leds_run * 3;
+                color_idx      += leds_run;
+                led_idx        += leds_run;
+
+                continue;
+            }
+
+            /*-------------------------------------*\
+            | This LED straddles the universe       |
+            | boundary, place it byte by byte       |
+            \*-------------------------------------*/
+            for(unsigned int component = 0; component < 3; component++)
+            {
+                if(channel_idx > universe_size)
+                {
+                    universe++;
+                    channel_idx = 1;
+                    packet_it   = universe_packets.find(universe);
+                }
+
+                if(packet_it != universe_packets.end())
+                {
+                    E131PackByte byte;
+
+                    byte.packet_idx = packet_it->second;
+                    byte.channel    = channel_idx;
+                    byte.color_idx  = color_idx;
+                    byte.shift      = component * 8;
+
+                    pack_bytes.push_back(byte);
                 }
+
+                channel_idx++;
             }
 
-            channel_idx = 1;
+            color_idx++;
+            led_idx++;
         }
     }
 
-    for(std::size_t packet_idx = 0; packet_idx < packets.size(); packet_idx++)
+    /*-----------------------------------------*\
+    | Start with every universe dirty so the    |
+    | first frame is sent in full               |
+    \*-----------------------------------------*/
+    last_colors.clear();
+    packet_dirty.assign(packets.size(), 1);
+    packet_send_time.assign(packets.size(), std::chrono::steady_clock::time_point());
+
+    if(keepalive_delay.count() > 0)
     {
-        e131_send(sockfd, &packets[packet_idx], &dest_addrs[packet_idx]);
-        packets[packet_idx].frame.seq_number++;
+        refresh_delay = std::min(keepalive_delay, std::chrono::milliseconds(E131_REFRESH_INTERVAL_MS));
+    }
+    else
+    {
+        refresh_delay = std::chrono::milliseconds(E131_REFRESH_INTERVAL_MS);
     }
+
+    send_datagrams.reserve(packets.size());
+    send_packets.reserve(packets.size());
+
+    stats_start_time    = std::chrono::steady_clock::now();
+    stats_transmit_time = std::chrono::nanoseconds(0);
+    stats_frames        = 0;
+    stats_packets       = 0;
+}
+
+void RGBController_E131::DeviceUpdateLEDs()
+{
+    std::lock_guard<std::mutex> lock(packet_mutex);
+
+    PackColors();
+    SendPackets(refresh_delay);
 }
 
 void RGBController_E131::UpdateZoneLEDs(int /*zone*/)
 {
-    DeviceUpdateLEDs();
+    std::lock_guard<std::mutex> lock(packet_mutex);
+
+    PackColors();
+    SendPackets(refresh_delay);
 }
 
 void RGBController_E131::UpdateSingleLED(int /*led*/)
 {
-    DeviceUpdateLEDs();
+    std::lock_guard<std::mutex> lock(packet_mutex);
+
+    PackColors();
+    SendPackets(refresh_delay);
+}
+
+void RGBController_E131::PackColors()
+{
+    /*-----------------------------------------*\
+    | If the color buffer changed size, treat   |
+    | every LED as changed                      |
+    \*-----------------------------------------*/
+    bool all_dirty = (last_colors.size() != colors.size());
+
+    /*-----------------------------------------*\
+    | Pack whole-LED runs, skipping runs whose  |
+    | colors are unchanged since the last frame |
+    \*-----------------------------------------*/
+    for(const E131PackRun& run : pack_runs)
+    {
+        const RGBColor* src = &colors[run.color_idx];
+
+        if(!all_dirty && memcmp(src, &last_colors[run.color_idx], run.leds_count * sizeof(RGBColor)) == 0)
+        {
+            continue;
+        }
+
+        uint8_t* dst = &packets[run.packet_idx].dmp.prop_val[run.channel];
+
+        RGBColorPack(src, run.leds_count, dst, RGB_PACK_ORDER_RGB);
+
+        packet_dirty[run.packet_idx] = 1;
+    }
+
+    /*-----------------------------------------*\
+    | Pack LEDs that straddle universes         |
+    \*-----------------------------------------*/
+    for(const E131PackByte& byte : pack_bytes)
+    {
+        if(!all_dirty && colors[byte.color_idx] == last_colors[byte.color_idx])
+        {
+            continue;
+        }
+
+        packets[byte.packet_idx].dmp.prop_val[byte.channel] = (colors[byte.color_idx] >> byte.shift) & 0xFF;
+
+        packet_dirty[byte.packet_idx] = 1;
+    }
+
+    last_colors = colors;
+}
+
+void RGBController_E131::SendPackets(std::chrono::milliseconds max_age)
+{
+    std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+    /*-----------------------------------------*\
+    | Collect changed universes, and unchanged  |
+    | ones last sent at least max_age ago       |
+    \*-----------------------------------------*/
+    send_datagrams.clear();
+    send_packets.clear();
+
+    for(std::size_t packet_idx = 0; packet_idx < packets.size(); packet_idx++)
+    {
+        if(!packet_dirty[packet_idx] && ((now - packet_send_time[packet_idx]) < max_age))
+        {
+            continue;
+        }
+
+        net_port_datagram datagram;
+
+        datagram.buffer     = (const char *)packets[packet_idx].raw;
+        datagram.length     = (int)(sizeof(packets[packet_idx].raw) - sizeof(packets[packet_idx].dmp.prop_val) + ntohs(packets[packet_idx].dmp.prop_val_cnt));
+        datagram.addr       = (const sockaddr *)&dest_addrs[packet_idx];
+        datagram.addr_len   = sizeof(dest_addrs[packet_idx]);
+
+        send_datagrams.push_back(datagram);
+        send_packets.push_back(packet_idx);
+    }
+
+    if(send_datagrams.empty())
+    {
+        return;
+    }
+
+    /*-----------------------------------------*\
+    | Send the whole frame as one batch         |
+    \*-----------------------------------------*/
+    std::chrono::time_point<std::chrono::steady_clock> transmit_start = std::chrono::steady_clock::now();
+
+    int sent = net_port::udp_send_batch(sockfd, send_datagrams);
+
+    std::chrono::time_point<std::chrono::steady_clock> transmit_end = std::chrono::steady_clock::now();
+
+    for(std::size_t send_idx = 0; send_idx < send_packets.size(); send_idx++)
+    {
+        std::size_t packet_idx = send_packets[send_idx];
+
+        packets[packet_idx].frame.seq_number++;
+
+        packet_dirty[packet_idx]     = 0;
+        packet_send_time[packet_idx] = transmit_start;
+    }
+
+    /*-----------------------------------------*\
+    | Periodically report transmit statistics   |
+    \*-----------------------------------------*/
+    stats_transmit_time += (transmit_end - transmit_start);
+    stats_frames++;
+    stats_packets       += sent;
+
+    std::chrono::milliseconds stats_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(transmit_end - stats_start_time);
+
+    if(stats_elapsed.count() >= E131_STATS_INTERVAL_MS)
+    {
+        LOG_TRACE("[E1.31] %s: %u frames, %.1f packets/s, average frame transmit time %.1f us",
+                  name.c_str(),
+                  stats_frames,
+                  (stats_packets * 1000.0) / stats_elapsed.count(),
+                  std::chrono::duration<double, std::micro>(stats_transmit_time).count() / stats_frames);
+
+        stats_start_time    = transmit_end;
+        stats_transmit_time = std::chrono::nanoseconds(0);
+        stats_frames        = 0;
+        stats_packets       = 0;
+    }
 }
 
 void RGBController_E131::DeviceUpdateMode()
@@ -459,10 +671,29 @@ void RGBController_E131::KeepaliveThreadFunction()
 {
     while(keepalive_thread_run.load())
     {
-        if((std::chrono::steady_clock::now() - last_update_time) > ( keepalive_delay * 0.95f ) )
+        std::chrono::time_point<std::chrono::steady_clock> next_keepalive;
+
         {
-            UpdateLEDs();
+            std::lock_guard<std::mutex> lock(packet_mutex);
+
+            /*-------------------------------------*\
+            | Resend every universe that has not    |
+            | been sent within the keepalive time   |
+            \*-------------------------------------*/
+            SendPackets(keepalive_delay);
+
+            /*-------------------------------------*\
+            | Wake again when the oldest universe   |
+            | next reaches the keepalive time       |
+            \*-------------------------------------*/
+            next_keepalive = std::chrono::steady_clock::now() + keepalive_delay;
+
+            for(std::size_t packet_idx = 0; packet_idx < packets.size(); packet_idx++)
+            {
+                next_keepalive = std::min(next_keepalive, packet_send_time[packet_idx] + keepalive_delay);
+            }
         }
-        std::this_thread::sleep_for(keepalive_delay / 2);
+
+        std::this_thread::sleep_until(next_keepalive);
     }
 }
@@ -9,8 +9,10 @@
 
 #pragma once
 #include "RGBController.h"
+#include "net_port.h"
 #include <e131.h>
 #include <chrono>
+#include <mutex>
 #include <thread>
 
 typedef unsigned int e131_rgb_order;
@@ -55,6 +57,40 @@ struct E131Device
     e131_matrix_order matrix_order;
 };
 
+/*---------------------------------------------------------*\
+| Precomputed packing table entries.  A run copies whole    |
+| LEDs into consecutive channels of one universe packet.    |
+| A split byte places a single color component of an LED    |
+| that straddles a universe boundary.                       |
+\*---------------------------------------------------------*/
+struct E131PackRun
+{
+    unsigned int    packet_idx;
+    unsigned int    channel;
+    unsigned int    color_idx;
+    unsigned int    leds_count;
+};
+
+struct E131PackByte
+{
+    unsigned int    packet_idx;
+    unsigned int    channel;
+    unsigned int    color_idx;
+    unsigned int    shift;
+};
+
+/*---------------------------------------------------------*\
+| Unchanged universes are still retransmitted at least this |
+| often so receivers do not hit the E1.31 data loss timeout |
+| (2.5 seconds)                                             |
+\*---------------------------------------------------------*/
+#define E131_REFRESH_INTERVAL_MS    1000
+
+/*---------------------------------------------------------*\
+| Interval between transmit statistics log entries          |
+\*---------------------------------------------------------*/
+#define E131_STATS_INTERVAL_MS      10000
+
 class RGBController_E131 : public RGBController
 {
 public:
@@ -74,6 +110,10 @@ public:
     void        KeepaliveThreadFunction();
 
 private:
+    void        SetupPackTable();
+    void        PackColors();
+    void        SendPackets(std::chrono::milliseconds max_age);
+
 	std::vector<E131Device> 	devices;
     std::vector<e131_packet_t> 	packets;
 	std::vector<e131_addr_t> 	dest_addrs;
@@ -82,5 +122,26 @@ private:
     std::thread *               keepalive_thread;
     std::atomic<bool>           keepalive_thread_run;
     std::chrono::milliseconds                           keepalive_delay;
-    std::chrono::time_point<std::chrono::steady_clock>  last_update_time;
+
+    std::vector<E131PackRun>                            pack_runs;
+    std::vector<E131PackByte>                           pack_bytes;
+    std::vector<RGBColor>                               last_colors;
+    std::vector<unsigned char>                          packet_dirty;
+    std::vector<std::chrono::time_point<std::chrono::steady_clock>> packet_send_time;
+    std::chrono::milliseconds                           refresh_delay;
+
+    /*---------------------------------------------------------*\
+    | Guards the packet buffers, packing state and socket,      |
+    | which are shared by the device thread, direct zone and    |
+    | LED updates and the keepalive thread                      |
+    \*---------------------------------------------------------*/
+    std::mutex                                          packet_mutex;
+
+    std::vector<net_port_datagram>                      send_datagrams;
+    std::vector<std::size_t>                            send_packets;
+
+    std::chrono::time_point<std::chrono::steady_clock>  stats_start_time;
+    std::chrono::nanoseconds                            stats_transmit_time;
+    unsigned int                                        stats_frames;
+    unsigned int                                        stats_packets;
 };
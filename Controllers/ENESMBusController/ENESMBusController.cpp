@@ -34,6 +34,8 @@ ENESMBusController::ENESMBusController(ENESMBusInterface* interface, ene_dev_id
     this->interface = interface;
     this->dev       = dev;
 
+    direct_shadow_valid = false;
+
     UpdateDeviceName();
 
     // Read the device configuration table
@@ -185,6 +187,16 @@ std::string ENESMBusController::GetDeviceLocation()
     return(return_string);
 }
 
+ene_dev_id ENESMBusController::GetDeviceAddress()
+{
+    return(dev);
+}
+
+i2c_smbus_scheduler* ENESMBusController::GetScheduler()
+{
+    return(interface->GetScheduler());
+}
+
 const char * ENESMBusController::GetChannelName(unsigned int cfg_zone)
 {
     switch(config_table[channel_cfg + cfg_zone])
@@ -278,31 +290,82 @@ void ENESMBusController::SaveMode()
 
 void ENESMBusController::SetAllColorsDirect(RGBColor* colors)
 {
-    unsigned char* color_buf   = new unsigned char[led_count * 3];
-    unsigned int   bytes_sent  = 0;
+    unsigned int max_block  = interface->GetMaxBlock();
+    unsigned int buf_size   = led_count * 3;
 
-    for(unsigned int i = 0; i < (led_count * 3); i += 3)
+    direct_buf.resize(buf_size);
+
+    for(unsigned int i = 0; i < buf_size; i += 3)
     {
-        color_buf[i + 0] = RGBGetRValue(colors[i / 3]);
-        color_buf[i + 1] = RGBGetBValue(colors[i / 3]);
-        color_buf[i + 2] = RGBGetGValue(colors[i / 3]);
+        direct_buf[i + 0] = RGBGetRValue(colors[i / 3]);
+        direct_buf[i + 1] = RGBGetBValue(colors[i / 3]);
+        direct_buf[i + 2] = RGBGetGValue(colors[i / 3]);
     }
 
-    while(bytes_sent < (led_count * 3))
+    /*-----------------------------------------------------*\
+    | Rewrite everything if nothing has been written yet or |
+    | the refresh interval has passed, in case the device   |
+    | lost state                                            |
+    \*-----------------------------------------------------*/
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    bool full_refresh = !direct_shadow_valid
+                     || (direct_shadow.size() != buf_size)
+                     || (now - direct_refresh_time >= std::chrono::milliseconds(ENE_DIRECT_REFRESH_INTERVAL_MS));
+
+    if(full_refresh)
     {
-        int bytes_to_send = (led_count * 3) - bytes_sent;
+        direct_shadow.assign(buf_size, 0);
+        direct_refresh_time = now;
+    }
 
-        if(bytes_to_send > interface->GetMaxBlock())
+    /*-----------------------------------------------------*\
+    | Start a block at each changed LED and extend it over  |
+    | the following LEDs that fit in the bus's max block,   |
+    | ending it after the last changed LED it covers        |
+    \*-----------------------------------------------------*/
+    unsigned int led = 0;
+
+    while(led < led_count)
+    {
+        if(!full_refresh && memcmp(&direct_buf[led * 3], &direct_shadow[led * 3], 3) == 0)
         {
-            bytes_to_send = interface->GetMaxBlock();
+            led++;
+            continue;
         }
 
-        ENERegisterWriteBlock(direct_reg + bytes_sent, &color_buf[bytes_sent], bytes_to_send);
+        unsigned int start  = led * 3;
+        unsigned int end    = start + 3;
 
-        bytes_sent += bytes_to_send;
+        for(unsigned int next = led + 1; (next < led_count) && ((next * 3) + 3 - start <= max_block); next++)
+        {
+            if(full_refresh || memcmp(&direct_buf[next * 3], &direct_shadow[next * 3], 3) != 0)
+            {
+                end = (next * 3) + 3;
+            }
+        }
+
+        unsigned int bytes_sent = start;
+
+        while(bytes_sent < end)
+        {
+            unsigned int bytes_to_send = end - bytes_sent;
+
+            if(bytes_to_send > max_block)
+            {
+                bytes_to_send = max_block;
+            }
+
+            ENERegisterWriteBlock(direct_reg + bytes_sent, &direct_buf[bytes_sent], bytes_to_send);
+
+            bytes_sent += bytes_to_send;
+        }
+
+        led = end / 3;
     }
 
-    delete[] color_buf;
+    direct_shadow       = direct_buf;
+    direct_shadow_valid = true;
 }
 
 void ENESMBusController::SetAllColorsEffect(RGBColor* colors)
@@ -339,6 +402,8 @@ void ENESMBusController::SetAllColorsEffect(RGBColor* colors)
 
 void ENESMBusController::SetDirect(unsigned char direct)
 {
+    direct_shadow_valid = false;
+
     ENERegisterWrite(ENE_REG_DIRECT, direct);
     ENERegisterWrite(ENE_REG_APPLY, ENE_APPLY_VAL);
 }
@@ -348,6 +413,11 @@ void ENESMBusController::SetLEDColorDirect(unsigned int led, unsigned char red,
     unsigned char colors[3] = { red, blue, green };
 
     ENERegisterWriteBlock(direct_reg + ( 3 * led ), colors, 3);
+
+    if(direct_shadow_valid && (led < led_count))
+    {
+        memcpy(&direct_shadow[led * 3], colors, 3);
+    }
 }
 
 void ENESMBusController::SetLEDColorEffect(unsigned int led, unsigned char red, unsigned char green, unsigned char blue)
@@ -10,7 +10,9 @@
 |  Adam Honse (CalcProgrammer1) 8/19/2018   |
 \*-----------------------------------------*/
 
+#include <chrono>
 #include <string>
+#include <vector>
 #include "ENESMBusInterface.h"
 #include "RGBController.h"
 
@@ -19,6 +21,7 @@
 #define ENE_APPLY_VAL                   0x01        /* Value for Apply Changes Register     */
 #define ENE_SAVE_VAL                    0xAA        /* Value for Save Changes               */
 #define ENE_NUM_ZONES                   8           /* Number of ENE config table zones     */
+#define ENE_DIRECT_REFRESH_INTERVAL_MS  1000        /* Rewrite all direct colors this often */
 enum
 {
     ENE_REG_DEVICE_NAME                 = 0x1000,   /* Device String 16 bytes               */
@@ -103,6 +106,8 @@ public:
 
     std::string   GetDeviceName();
     std::string   GetDeviceLocation();
+    ene_dev_id    GetDeviceAddress();
+    i2c_smbus_scheduler* GetScheduler();
     const char*   GetChannelName(unsigned int cfg_zone);
     unsigned int  GetLEDCount(unsigned int cfg_zone);
     unsigned char GetLEDRed(unsigned int led);
@@ -135,4 +140,13 @@ private:
     ENESMBusInterface*      interface;
     ene_dev_id              dev;
 
+    /*-----------------------------------------------------*\
+    | Last direct color register contents written, used to  |
+    | write only the LEDs that changed                      |
+    \*-----------------------------------------------------*/
+    std::vector<unsigned char>              direct_buf;
+    std::vector<unsigned char>              direct_shadow;
+    bool                                    direct_shadow_valid;
+    std::chrono::steady_clock::time_point   direct_refresh_time;
+
 };
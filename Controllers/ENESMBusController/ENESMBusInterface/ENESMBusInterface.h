@@ -13,6 +13,8 @@
 typedef unsigned short	ene_register;
 typedef unsigned char	ene_dev_id;
 
+class i2c_smbus_scheduler;
+
 class ENESMBusInterface
 {
 public:
@@ -23,4 +25,9 @@ public:
     virtual unsigned char ENERegisterRead(ene_dev_id dev, ene_register reg) = 0;
     virtual void          ENERegisterWrite(ene_dev_id dev, ene_register reg, unsigned char val) = 0;
     virtual void          ENERegisterWriteBlock(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz) = 0;
+
+    /*-----------------------------------------------------*\
+    | Frame scheduler of the underlying bus, if it has one  |
+    \*-----------------------------------------------------*/
+    virtual i2c_smbus_scheduler* GetScheduler() { return(nullptr); }
 };
@@ -7,6 +7,7 @@
 \*-----------------------------------------*/
 
 #include "ENESMBusInterface_i2c_smbus.h"
+#include <cstring>
 
 ENESMBusInterface_i2c_smbus::ENESMBusInterface_i2c_smbus(i2c_smbus_interface* bus)
 {
@@ -40,18 +41,47 @@ unsigned char ENESMBusInterface_i2c_smbus::ENERegisterRead(ene_dev_id dev, ene_r
 
 void ENESMBusInterface_i2c_smbus::ENERegisterWrite(ene_dev_id dev, ene_register reg, unsigned char val)
 {
+    i2c_smbus_write_msg writes[2];
+
     //Write ENE register
-    bus->i2c_smbus_write_word_data(dev, 0x00, ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF));
+    writes[0].command       = 0x00;
+    writes[0].size          = I2C_SMBUS_WORD_DATA;
+    writes[0].data.word     = ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF);
 
     //Write ENE value
-    bus->i2c_smbus_write_byte_data(dev, 0x01, val);
+    writes[1].command       = 0x01;
+    writes[1].size          = I2C_SMBUS_BYTE_DATA;
+    writes[1].data.byte     = val;
+
+    //The register read already relies on a repeated start after the
+    //address write, so the value write may follow the same way
+    bus->i2c_smbus_write_batch(dev, 2, writes, true);
 }
 
 void ENESMBusInterface_i2c_smbus::ENERegisterWriteBlock(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz)
 {
+    i2c_smbus_write_msg writes[2];
+
+    if(sz > I2C_SMBUS_BLOCK_MAX)
+    {
+        sz = I2C_SMBUS_BLOCK_MAX;
+    }
+
     //Write ENE register
-    bus->i2c_smbus_write_word_data(dev, 0x00, ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF));
+    writes[0].command       = 0x00;
+    writes[0].size          = I2C_SMBUS_WORD_DATA;
+    writes[0].data.word     = ((reg << 8) & 0xFF00) | ((reg >> 8) & 0x00FF);
 
     //Write ENE block data
-    bus->i2c_smbus_write_block_data(dev, 0x03, sz, data);
+    writes[1].command       = 0x03;
+    writes[1].size          = I2C_SMBUS_BLOCK_DATA;
+    writes[1].data.block[0] = sz;
+    memcpy(&writes[1].data.block[1], data, sz);
+
+    bus->i2c_smbus_write_batch(dev, 2, writes, true);
+}
+
+i2c_smbus_scheduler* ENESMBusInterface_i2c_smbus::GetScheduler()
+{
+    return(bus->i2c_smbus_get_scheduler());
 }
@@ -24,6 +24,8 @@ public:
     void          ENERegisterWrite(ene_dev_id dev, ene_register reg, unsigned char val);
     void          ENERegisterWriteBlock(ene_dev_id dev, ene_register reg, unsigned char * data, unsigned char sz);
 
+    i2c_smbus_scheduler* GetScheduler();
+
 private:
     i2c_smbus_interface *   bus;
 };
@@ -145,10 +145,27 @@ RGBController_ENESMBus::RGBController_ENESMBus(ENESMBusController * controller_p
     | Initialize active mode                            |
     \*-------------------------------------------------*/
     active_mode = GetDeviceMode();
+
+    /*-------------------------------------------------*\
+    | If the bus has a frame scheduler, write the LEDs  |
+    | from the scheduler in lock-step with the other    |
+    | devices on the bus                                |
+    \*-------------------------------------------------*/
+    scheduler   = controller->GetScheduler();
+
+    if(scheduler != nullptr)
+    {
+        scheduler->add_device(this, controller->GetDeviceAddress(), [this]{ WriteAllLEDs(); });
+    }
 }
 
 RGBController_ENESMBus::~RGBController_ENESMBus()
 {
+    if(scheduler != nullptr)
+    {
+        scheduler->remove_device(this);
+    }
+
     delete controller;
 }
 
@@ -244,6 +261,20 @@ int RGBController_ENESMBus::GetDeviceMode()
 
 void RGBController_ENESMBus::DeviceUpdateLEDs()
 {
+    if(scheduler != nullptr)
+    {
+        scheduler->request_update(this);
+    }
+    else
+    {
+        WriteAllLEDs();
+    }
+}
+
+void RGBController_ENESMBus::WriteAllLEDs()
+{
+    std::lock_guard<std::mutex> lock(write_mutex);
+
     if(GetMode() == 0)
     {
         controller->SetAllColorsDirect(&colors[0]);
@@ -252,11 +283,12 @@ void RGBController_ENESMBus::DeviceUpdateLEDs()
     {
         controller->SetAllColorsEffect(&colors[0]);
     }
-
 }
 
 void RGBController_ENESMBus::UpdateZoneLEDs(int zone)
 {
+    std::lock_guard<std::mutex> lock(write_mutex);
+
     for(std::size_t led_idx = 0; led_idx < zones[zone].leds_count; led_idx++)
     {
         int           led   = zones[zone].leds[led_idx].value;
@@ -278,6 +310,8 @@ void RGBController_ENESMBus::UpdateZoneLEDs(int zone)
 
 void RGBController_ENESMBus::UpdateSingleLED(int led)
 {
+    std::lock_guard<std::mutex> lock(write_mutex);
+
     RGBColor color    = colors[led];
     unsigned char red = RGBGetRValue(color);
     unsigned char grn = RGBGetGValue(color);
@@ -409,6 +443,8 @@ void RGBController_ENESMBus::ResizeZone(int /*zone*/, int /*new_size*/)
 
 void RGBController_ENESMBus::DeviceUpdateMode()
 {
+    std::lock_guard<std::mutex> lock(write_mutex);
+
     if (modes[active_mode].value == 0xFFFF)
     {
         controller->SetDirect(true);
@@ -462,5 +498,8 @@ void RGBController_ENESMBus::DeviceUpdateMode()
 void RGBController_ENESMBus::DeviceSaveMode()
 {
     DeviceUpdateMode();
+
+    std::lock_guard<std::mutex> lock(write_mutex);
+
     controller->SaveMode();
 }
@@ -10,6 +10,8 @@
 
 #include "RGBController.h"
 #include "ENESMBusController.h"
+#include "i2c_smbus_scheduler.h"
+#include <mutex>
 
 class RGBController_ENESMBus : public RGBController
 {
@@ -29,7 +31,10 @@ public:
     void        DeviceSaveMode();
 
 private:
-    ENESMBusController* controller;
+    ENESMBusController*     controller;
+    i2c_smbus_scheduler*    scheduler;
+    std::mutex              write_mutex;
 
     int         GetDeviceMode();
+    void        WriteAllLEDs();
 };
@@ -1,8 +1,12 @@
 #include "LinuxLEDController.h"
 
+#include <cstdio>
+
 LinuxLEDController::LinuxLEDController()
 {
-
+    led_r_last = -1;
+    led_g_last = -1;
+    led_b_last = -1;
 }
 
 LinuxLEDController::~LinuxLEDController()
@@ -45,8 +49,6 @@ void LinuxLEDController::OpenBluePath(std::string blue_path)
 
 void LinuxLEDController::SetRGB(unsigned char red, unsigned char grn, unsigned char blu)
 {
-    std::string brightness_str;
-
     /*-------------------------------------------------------------*\
     | My phone LED that I tested this on shuts down if you set zero |
     \*-------------------------------------------------------------*/
@@ -54,18 +56,27 @@ void LinuxLEDController::SetRGB(unsigned char red, unsigned char grn, unsigned c
     if(grn == 0) grn = 1;
     if(blu == 0) blu = 1;
 
-    brightness_str = std::to_string((unsigned int)red);
-
-    led_r_brightness.write(brightness_str.c_str(), brightness_str.length());
-    led_r_brightness.flush();
-
-    brightness_str = std::to_string((unsigned int)grn);
-
-    led_g_brightness.write(brightness_str.c_str(), brightness_str.length());
-    led_g_brightness.flush();
-
-    brightness_str = std::to_string((unsigned int)blu);
+    WriteBrightness(led_r_brightness, led_r_last, red);
+    WriteBrightness(led_g_brightness, led_g_last, grn);
+    WriteBrightness(led_b_brightness, led_b_last, blu);
+}
 
-    led_b_brightness.write(brightness_str.c_str(), brightness_str.length());
-    led_b_brightness.flush();
+void LinuxLEDController::WriteBrightness(sysfs_attr& brightness, int& last, unsigned char value)
+{
+    /*-------------------------------------------------------------*\
+    | Each channel is a separate LED class device, so skip the      |
+    | write entirely if the channel has not changed                 |
+    \*-------------------------------------------------------------*/
+    if(last == value)
+    {
+        return;
+    }
+
+    char brightness_str[4];
+    int  brightness_len = snprintf(brightness_str, sizeof(brightness_str), "%u", (unsigned int)value);
+
+    if(brightness.write(brightness_str, brightness_len) == brightness_len)
+    {
+        last = value;
+    }
 }
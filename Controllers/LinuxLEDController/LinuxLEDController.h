@@ -1,7 +1,8 @@
 
 #pragma once
 
-#include <fstream>
+#include <string>
+#include "sysfs_attr.h"
 
 class LinuxLEDController
 {
@@ -22,7 +23,13 @@ private:
     std::string     led_r_path;
     std::string     led_g_path;
     std::string     led_b_path;
-    std::ofstream   led_r_brightness;
-    std::ofstream   led_g_brightness;
-    std::ofstream   led_b_brightness;
+    sysfs_attr      led_r_brightness;
+    sysfs_attr      led_g_brightness;
+    sysfs_attr      led_b_brightness;
+
+    int             led_r_last;
+    int             led_g_last;
+    int             led_b_last;
+
+    void            WriteBrightness(sysfs_attr& brightness, int& last, unsigned char value);
 };
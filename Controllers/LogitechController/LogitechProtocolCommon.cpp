@@ -8,6 +8,8 @@
 \*-------------------------------------------------------------------*/
 
 #include <LogitechProtocolCommon.h>
+#include "ResourceManager.h"
+#include <fstream>
 
 const char* logitech_led_locations[] =
 {
@@ -26,6 +28,72 @@ static std::vector<uint16_t> logitech_RGB_pages =
     LOGITECH_HIDPP_PAGE_RGB_EFFECTS2
 };
 
+/*-----------------------------------------------------------------*\
+| Feature tables are cached in the configuration directory keyed on |
+|   device location and index. The cache file is shared by all      |
+|   Logitech devices, so access is serialised                       |
+\*-----------------------------------------------------------------*/
+static std::mutex logitech_cache_mutex;
+
+static filesystem::path getFeatureCachePath()
+{
+    return ResourceManager::get()->GetConfigurationDirectory() / LOGITECH_FEATURE_CACHE_FILENAME;
+}
+
+static json readFeatureCache()
+{
+    std::lock_guard<std::mutex> lock(logitech_cache_mutex);
+
+    json            cache       = json::object();
+    std::ifstream   cache_file(getFeatureCachePath());
+
+    if(cache_file)
+    {
+        try
+        {
+            cache_file >> cache;
+        }
+        catch(const std::exception& e)
+        {
+            LOG_WARNING("Logitech feature cache could not be read: %s", e.what());
+            cache = json::object();
+        }
+    }
+
+    return cache;
+}
+
+static void writeFeatureCache(const std::string& key, const json& entry)
+{
+    std::lock_guard<std::mutex> lock(logitech_cache_mutex);
+
+    json            cache       = json::object();
+    std::ifstream   cache_in(getFeatureCachePath());
+
+    if(cache_in)
+    {
+        try
+        {
+            cache_in >> cache;
+        }
+        catch(const std::exception&)
+        {
+            cache = json::object();
+        }
+    }
+
+    cache_in.close();
+
+    cache[key] = entry;
+
+    std::ofstream cache_out(getFeatureCachePath(), std::ios::out | std::ios::binary);
+
+    if(cache_out)
+    {
+        cache_out << cache.dump(4);
+    }
+}
+
 int getWirelessDevice(usages device_usages, uint16_t pid, wireless_map *wireless_devices)
 {
     hid_device* dev_use1;
@@ -125,6 +193,8 @@ logitech_device::logitech_device(char *path, usages _usages, uint8_t _device_ind
     device_usages       = _usages;
     wireless            = _wireless;
     RGB_feature_index   = 0;
+    info_feature_index  = 0;
+    discovery_complete  = true;
     mutex               = nullptr;
 
     initialiseDevice();
@@ -137,6 +207,8 @@ logitech_device::logitech_device(char *path, usages _usages, uint8_t _device_ind
     device_usages       = _usages;
     wireless            = _wireless;
     RGB_feature_index   = 0;
+    info_feature_index  = 0;
+    discovery_complete  = true;
     mutex               = mutex_ptr;
 
     initialiseDevice();
@@ -157,7 +229,18 @@ void logitech_device::initialiseDevice()
 
     if(is_connected)
     {
-        getDeviceName();
+        /*-----------------------------------------------------------------*\
+        | Use the cached feature table if the firmware has not changed      |
+        \*-----------------------------------------------------------------*/
+        discovery_complete = true;
+
+        bool cached = loadFeatureCache();
+
+        if(!cached)
+        {
+            getFeatureIndexes();
+            getDeviceName();
+        }
 
         /*-----------------------------------------------------------------*\
         | If this is running with DEBUG or higher loglevel then             |
@@ -168,16 +251,21 @@ void logitech_device::initialiseDevice()
             getDeviceFeatureList();     //This will populate the feature list
         }
 
+        if(cached)
+        {
+            return;
+        }
+
         /*-----------------------------------------------------------------*\
         | Check device for known RGB Effects Feature pages & save the index |
         \*-----------------------------------------------------------------*/
         for(std::vector<uint16_t>::iterator page = logitech_RGB_pages.begin(); page != logitech_RGB_pages.end(); page++)
         {
-            int feature_index = getFeatureIndex(*page);
-            if(feature_index > 0)
+            features::iterator find_page = feature_list.find(*page);
+
+            if(find_page != feature_list.end() && find_page->second > 0)
             {
-                feature_list.emplace(*page, feature_index);
-                RGB_feature_index = feature_index;
+                RGB_feature_index = find_page->second;
                 break;
             }
         }
@@ -193,6 +281,18 @@ void logitech_device::initialiseDevice()
         else
         {
             getRGBconfig();
+
+            /*-----------------------------------------------------------------*\
+            | Only cache a feature table built from a full set of responses     |
+            \*-----------------------------------------------------------------*/
+            if(discovery_complete)
+            {
+                saveFeatureCache();
+            }
+            else
+            {
+                LOG_INFO("[%s] Discovery was incomplete, not caching the feature table", device_name.c_str());
+            }
         }
     }
 }
@@ -335,6 +435,16 @@ uint8_t logitech_device::getFeatureIndex(uint16_t feature_page)
     uint8_t     feature_index   = 0;
     hid_device* dev_use2        = getDevice(2);
 
+    /*-----------------------------------------------------------------*\
+    | Use the index found during discovery if there is one              |
+    \*-----------------------------------------------------------------*/
+    features::iterator find_page = feature_list.find(feature_page);
+
+    if(find_page != feature_list.end())
+    {
+        return find_page->second;
+    }
+
     if(dev_use2)
     {
         blankFAPmessage response;
@@ -388,12 +498,6 @@ int logitech_device::getDeviceFeatureList()
 
     if(dev_use2)
     {
-        /*-----------------------------------------------------------------*\
-        | Create a buffer for reads                                         |
-        \*-----------------------------------------------------------------*/
-        blankFAPmessage response;
-        response.init();
-
         /*-----------------------------------------------------------------*\
         | Query the root index for the index of the feature list            |
         |   This is done for safety as it is generaly at feature index 0x01 |
@@ -403,22 +507,33 @@ int logitech_device::getDeviceFeatureList()
         /*-----------------------------------------------------------------*\
         | Get the count of Features                                         |
         \*-----------------------------------------------------------------*/
-        longFAPrequest get_count;
-        get_count.init(device_index, feature_index, LOGITECH_CMD_FEATURE_SET_GET_COUNT);
+        std::vector<longFAPrequest>     requests(1);
+        std::vector<blankFAPmessage>    responses;
 
-        hid_write(dev_use2, get_count.buffer, get_count.size());
-        hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-        unsigned int feature_count = response.data[0];
+        requests[0].init(device_index, feature_index, LOGITECH_CMD_FEATURE_SET_GET_COUNT);
+        pipelineRequests(requests, responses);
 
-        longFAPrequest get_features;
-        get_features.init(device_index, feature_index, LOGITECH_CMD_FEATURE_SET_GET_ID);
-        for(std::size_t i = 1; feature_list.size() < feature_count; i++ )
+        unsigned int feature_count = responses[0].data[0];
+
+        /*-----------------------------------------------------------------*\
+        | Get the page of every feature index at once                       |
+        \*-----------------------------------------------------------------*/
+        requests.resize(feature_count);
+
+        for(std::size_t i = 1; i <= feature_count; i++)
         {
-            get_features.data[0] = i;
-            hid_write(dev_use2, get_features.buffer, get_features.size());
-            hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-            LOG_DEBUG("[%s] Feature %04X @ index: %02X", device_name.c_str(), (response.data[0] << 8) | response.data[1], i);
-            feature_list.emplace((response.data[0] << 8) | response.data[1], i);
+            requests[i - 1].init(device_index, feature_index, LOGITECH_CMD_FEATURE_SET_GET_ID);
+            requests[i - 1].data[0] = i;
+        }
+
+        pipelineRequests(requests, responses);
+
+        for(std::size_t i = 1; i <= feature_count; i++)
+        {
+            uint16_t feature_page = (responses[i - 1].data[0] << 8) | responses[i - 1].data[1];
+
+            LOG_DEBUG("[%s] Feature %04X @ index: %02X", device_name.c_str(), feature_page, i);
+            feature_list.emplace(feature_page, i);
         }
     }
     else
@@ -439,52 +554,58 @@ int logitech_device::getDeviceName()
 
     if(dev_use2)
     {
-        /*-----------------------------------------------------------------*\
-        | Create a buffer for reads                                         |
-        \*-----------------------------------------------------------------*/
-        blankFAPmessage response;
-        response.init();
-
         /*-----------------------------------------------------------------*\
         | Query the root index for the index of the name feature            |
         \*-----------------------------------------------------------------*/
         int feature_index = getFeatureIndex(LOGITECH_HIDPP_PAGE_DEVICE_NAME_TYPE);
 
         /*-----------------------------------------------------------------*\
-        | Get the device name length                                        |
+        | Get the device name length and device type                        |
         \*-----------------------------------------------------------------*/
         if(feature_index > 0)
         {
-            longFAPrequest get_length;
-            get_length.init(device_index, feature_index, LOTITECH_CMD_DEVICE_NAME_TYPE_GET_COUNT);
-            hid_write(dev_use2, get_length.buffer, get_length.size());
-            hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-            unsigned int name_length = response.data[0];
-            LOG_DEBUG("[%s] Name Length %02i - %02X %02X %02X %02X %02X %02X %02X %02X   %02X %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(), name_length,
-                response.data[0], response.data[1],  response.data[2],  response.data[3],  response.data[4],  response.data[5],  response.data[6],  response.data[7],
-                response.data[8], response.data[9], response.data[10], response.data[11], response.data[12], response.data[13], response.data[14], response.data[15]);
-
-            longFAPrequest get_name;
-            get_name.init(device_index, feature_index, LOGITECH_CMD_DEVICE_NAME_TYPE_GET_DEVICE_NAME);
-            while(device_name.length() < name_length)
+            std::vector<longFAPrequest>     requests(2);
+            std::vector<blankFAPmessage>    responses;
+
+            requests[0].init(device_index, feature_index, LOTITECH_CMD_DEVICE_NAME_TYPE_GET_COUNT);
+            requests[1].init(device_index, feature_index, LOGITECH_CMD_DEVICE_NAME_TYPE_GET_TYPE);
+            pipelineRequests(requests, responses);
+
+            unsigned int name_length = responses[0].data[0];
+            logitech_device_type     = responses[1].data[0];
+            LOG_DEBUG("[%s] Name Length %02i Type %02i", device_name.c_str(), name_length, logitech_device_type);
+
+            /*-----------------------------------------------------------------*\
+            | Each name response carries up to a full long message of          |
+            |   characters, request every chunk at once                         |
+            \*-----------------------------------------------------------------*/
+            const unsigned int  chunk_size  = sizeof(requests[0].data);
+            unsigned int        chunk_count = (name_length + chunk_size - 1) / chunk_size;
+
+            requests.resize(chunk_count);
+
+            for(unsigned int chunk = 0; chunk < chunk_count; chunk++)
             {
-                get_name.data[0] = device_name.length();   //This sets the character index to get from the device
-                hid_write(dev_use2, get_name.buffer, get_name.size());
-                hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-                std::string temp = (char *)&response.data;
-                device_name.append(temp);
-                LOG_DEBUG("[%s] Get Name %02i - %02X %02X %02X %02X %02X %02X %02X %02X   %02X %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(), device_name.length(),
-                    response.data[0], response.data[1],  response.data[2],  response.data[3],  response.data[4],  response.data[5],  response.data[6],  response.data[7],
-                    response.data[8], response.data[9], response.data[10], response.data[11], response.data[12], response.data[13], response.data[14], response.data[15]);
+                requests[chunk].init(device_index, feature_index, LOGITECH_CMD_DEVICE_NAME_TYPE_GET_DEVICE_NAME);
+                requests[chunk].data[0] = chunk * chunk_size;   //This sets the character index to get from the device
             }
 
-            get_name.init(device_index, feature_index, LOGITECH_CMD_DEVICE_NAME_TYPE_GET_TYPE);
-            hid_write(dev_use2, get_name.buffer, get_name.size());
-            hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-            logitech_device_type = response.data[0];
-            LOG_DEBUG("[%s] Get Type %02i - %02X %02X %02X %02X %02X %02X %02X %02X   %02X %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(), logitech_device_type,
-                response.data[0], response.data[1],  response.data[2],  response.data[3],  response.data[4],  response.data[5],  response.data[6],  response.data[7],
-                response.data[8], response.data[9], response.data[10], response.data[11], response.data[12], response.data[13], response.data[14], response.data[15]);
+            pipelineRequests(requests, responses);
+
+            for(unsigned int chunk = 0; chunk < chunk_count; chunk++)
+            {
+                for(unsigned int i = 0; i < chunk_size && device_name.length() < name_length; i++)
+                {
+                    if(responses[chunk].data[i] == 0)
+                    {
+                        break;
+                    }
+
+                    device_name.push_back(responses[chunk].data[i]);
+                }
+            }
+
+            LOG_DEBUG("[%s] Get Name %02i", device_name.c_str(), device_name.length());
         }
     }
 
@@ -495,168 +616,475 @@ void logitech_device::getRGBconfig()
 {
     /*-----------------------------------------------------------------*\
     | Check the usage map for usage2 (0x11 Long FAP Message)            |
-    |   Then use it to get the name for this device                     |
+    |   Then use it to get the LED and effect list for this device      |
     \*-----------------------------------------------------------------*/
     hid_device* dev_use2    = getDevice(2);
     uint16_t feature_page   = getFeaturePage(RGB_feature_index);
     uint8_t led_response    = 0;
-    uint8_t led_counter     = 0;
 
     if(dev_use2)
     {
+        std::vector<longFAPrequest>     requests(1);
+        std::vector<blankFAPmessage>    responses;
+
         /*-----------------------------------------------------------------*\
-        | Create a buffer for reads                                         |
+        | Both feature pages use the same commands with different layouts   |
+        |   FP8070 - LED info from GET_INFO, effects from GET_CONTROL       |
+        |   FP8071 - LED info from GET_COUNT, effects from GET_INFO         |
         \*-----------------------------------------------------------------*/
-        blankFAPmessage response;
-        response.init();
-        int result;
+        bool    page_8070       = (feature_page == LOGITECH_HIDPP_PAGE_RGB_EFFECTS1);
+        uint8_t led_info_cmd    = page_8070 ? LOGITECH_CMD_RGB_EFFECTS_GET_INFO     : LOGITECH_CMD_RGB_EFFECTS_GET_COUNT;
+        uint8_t fx_info_cmd     = page_8070 ? LOGITECH_CMD_RGB_EFFECTS_GET_CONTROL  : LOGITECH_CMD_RGB_EFFECTS_GET_INFO;
+        uint8_t led_data_offset = page_8070 ? 1 : 2;
 
-        longFAPrequest get_count;
-        get_count.init(device_index, RGB_feature_index, LOGITECH_CMD_RGB_EFFECTS_GET_COUNT);
+        if(feature_page != LOGITECH_HIDPP_PAGE_RGB_EFFECTS1 && feature_page != LOGITECH_HIDPP_PAGE_RGB_EFFECTS2)
+        {
+            return;
+        }
+
+        requests[0].init(device_index, RGB_feature_index, LOGITECH_CMD_RGB_EFFECTS_GET_COUNT);
 
-        if(feature_page == LOGITECH_HIDPP_PAGE_RGB_EFFECTS1)
+        if(!page_8070)
         {
-            result = hid_write(dev_use2, get_count.buffer, get_count.size());
-            do
+            requests[0].data[0] = 0xFF;
+            requests[0].data[1] = 0xFF;
+        }
+
+        pipelineRequests(requests, responses);
+
+        led_response = page_8070 ? responses[0].data[0] : responses[0].data[2];
+        LOG_DEBUG("[%s] FP%04X - LED Count - %02X", device_name.c_str(), feature_page, led_response);
+
+        /*-----------------------------------------------------------------*\
+        | Request the info for every LED at once                            |
+        \*-----------------------------------------------------------------*/
+        requests.resize(led_response);
+
+        for(std::size_t i = 0; i < led_response; i++)
+        {
+            requests[i].init(device_index, RGB_feature_index, led_info_cmd);
+            requests[i].data[0] = i;
+
+            if(!page_8070)
             {
-                result = hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-                LOG_DEBUG("[%s] FP8070 - LED Count - %02X :   %04X %04X %04X %04X   %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(),
-                    response.data[0], (response.data[1] << 8 | response.data[2]), (response.data[3] << 8 | response.data[4]), (response.data[5] << 8 | response.data[6]),
-                    (response.data[7] << 8 | response.data[8]), response.data[9], response.data[10], response.data[11], response.data[12], response.data[13], response.data[14], response.data[15]);
-            } while ((result == 20) && (get_count.feature_index != response.feature_index) && (get_count.feature_command != response.feature_command));
+                requests[i].data[1] = 0xFF;
+            }
+        }
+
+        std::vector<blankFAPmessage> led_responses;
+        pipelineRequests(requests, led_responses);
+
+        std::vector<uint8_t>        led_indexes;
+        std::vector<logitech_led>   new_leds;
+
+        for(std::size_t i = 0; i < led_responses.size(); i++)
+        {
+            blankFAPmessage& response = led_responses[i];
 
-            led_response = response.data[0];
+            LOG_DEBUG("[%s] FP%04X - LED %02i - %02X %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(), feature_page, i,
+                response.data[0], response.data[1],  response.data[2],  response.data[3],  response.data[4],  response.data[5],  response.data[6],  response.data[7]);
 
-            get_count.feature_command = LOGITECH_CMD_RGB_EFFECTS_GET_INFO;
-            for(size_t i = 0; i < led_response; i++)
+            /*-----------------------------------------------------------------*\
+            | Skip LEDs without a valid response                                |
+            \*-----------------------------------------------------------------*/
+            if(response.report_id != LOGITECH_LONG_MESSAGE || response.feature_index != RGB_feature_index)
             {
-                get_count.data[0] = i;
-                result = hid_write(dev_use2, get_count.buffer, get_count.size());
-                result = hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-                LOG_DEBUG("[%s] FP8070 - LED %02i - %02X %02X %02X %02X %02X %02X %02X %02X   %02X %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(), get_count.data[0],
-                    response.data[0], response.data[1],  response.data[2],  response.data[3],  response.data[4],  response.data[5],  response.data[6],  response.data[7],
-                    response.data[8], response.data[9], response.data[10], response.data[11], response.data[12], response.data[13], response.data[14], response.data[15]);
-                if( result == 20 &&
-                    get_count.feature_index == response.feature_index &&
-                    get_count.feature_command == response.feature_command &&
-                    response.data[0] != 0x10 &&
-                    response.data[1] != 0x02
-                  )
-                {
-                    //If the response is the correct length (i.e. no USB error) and is for the RGB_feature_index and LOGITECH_CMD_RGB_EFFECTS_GET_INFO and no error occured with the led_counter then bump the counter
-                    logitech_led new_led;
+                continue;
+            }
 
-                    new_led.location    = response.data[1] << 8 | response.data[2];
-                    new_led.fx_count    = response.data[3];
+            if(page_8070 && (response.data[0] == 0x10 || response.data[1] == 0x02))
+            {
+                continue;
+            }
 
-                    for(uint8_t i = 0; i < new_led.fx_count; i++)
-                    {
-                        blankFAPmessage fx_response;
-                        fx_response.init();
+            logitech_led new_led;
 
-                        longFAPrequest get_effect;
-                        get_effect.init(device_index, RGB_feature_index, LOGITECH_CMD_RGB_EFFECTS_GET_CONTROL);
+            new_led.location    = response.data[led_data_offset] << 8 | response.data[led_data_offset + 1];
+            new_led.fx_count    = response.data[led_data_offset + 2];
 
-                        get_effect.data[0] = get_count.data[0];
-                        get_effect.data[1] = i;
-                        result = hid_write(dev_use2, get_effect.buffer, get_effect.size());
-                        result = hid_read_timeout(dev_use2, fx_response.buffer, fx_response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-                        LOG_DEBUG("[%s] FP8070 - LED %02i Effect %02X - %02X %02X %02X %02X %02X %02X %02X %02X   %02X %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(), get_count.data[0], i,
-                            fx_response.data[0], fx_response.data[1],  fx_response.data[2],  fx_response.data[3],  fx_response.data[4],  fx_response.data[5],  fx_response.data[6],  fx_response.data[7],
-                            fx_response.data[8], fx_response.data[9], fx_response.data[10], fx_response.data[11], fx_response.data[12], fx_response.data[13], fx_response.data[14], fx_response.data[15]);
+            led_indexes.push_back(response.data[0]);
+            new_leds.push_back(new_led);
+        }
 
-                        logitech_fx new_fx;
+        /*-----------------------------------------------------------------*\
+        | Request the info for every effect of every LED at once            |
+        \*-----------------------------------------------------------------*/
+        requests.clear();
 
-                        new_fx.index    = i;
-                        new_fx.mode     = static_cast<LOGITECH_DEVICE_MODE>(fx_response.data[2] << 8 | fx_response.data[3]);
-                        new_fx.speed    = fx_response.data[6] << 8 | fx_response.data[7];
+        for(std::size_t led_idx = 0; led_idx < new_leds.size(); led_idx++)
+        {
+            for(uint8_t fx_idx = 0; fx_idx < new_leds[led_idx].fx_count; fx_idx++)
+            {
+                longFAPrequest get_effect;
+                get_effect.init(device_index, RGB_feature_index, fx_info_cmd);
 
-                        new_led.fx.push_back(new_fx);
-                    }
+                get_effect.data[0] = led_indexes[led_idx];
+                get_effect.data[1] = fx_idx;
 
-                    leds.emplace(response.data[0], new_led);
-                }
+                requests.push_back(get_effect);
             }
         }
-        else if(feature_page == LOGITECH_HIDPP_PAGE_RGB_EFFECTS2)
+
+        pipelineRequests(requests, responses);
+
+        std::size_t fx_response_idx = 0;
+
+        for(std::size_t led_idx = 0; led_idx < new_leds.size(); led_idx++)
         {
-            get_count.data[0] = 0xFF;
-            get_count.data[1] = 0xFF;
-            get_count.data[2] = 0;
-            get_count.data[3] = 0;
-            get_count.data[4] = 0;
+            for(uint8_t fx_idx = 0; fx_idx < new_leds[led_idx].fx_count; fx_idx++)
+            {
+                blankFAPmessage& fx_response = responses[fx_response_idx++];
 
-            result = hid_write(dev_use2, get_count.buffer, get_count.size());
-            result = hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-            LOG_DEBUG("[%s] FP8071 - LED Count - %02X :   %02X %02X %04X %04X %04X   %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(),
-                response.data[2], response.data[0], response.data[1], (response.data[3] << 8 | response.data[4]), (response.data[5] << 8 | response.data[6]),
-                (response.data[7] << 8 | response.data[8]), response.data[9], response.data[10], response.data[11], response.data[12], response.data[13], response.data[14], response.data[15]);
+                LOG_DEBUG("[%s] FP%04X - LED %02i Effect %02X - %02X %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(), feature_page, led_indexes[led_idx], fx_idx,
+                    fx_response.data[0], fx_response.data[1],  fx_response.data[2],  fx_response.data[3],  fx_response.data[4],  fx_response.data[5],  fx_response.data[6],  fx_response.data[7]);
+
+                logitech_fx new_fx;
+
+                new_fx.index    = fx_idx;
+                new_fx.mode     = static_cast<LOGITECH_DEVICE_MODE>(fx_response.data[2] << 8 | fx_response.data[3]);
+                new_fx.speed    = fx_response.data[6] << 8 | fx_response.data[7];
+
+                new_leds[led_idx].fx.push_back(new_fx);
+            }
+
+            leds.emplace(led_indexes[led_idx], new_leds[led_idx]);
+        }
+    }
+
+    LOG_DEBUG("[%s] led_response returned %i : setting controller to %i LED%s", device_name.c_str(), led_response, leds.size(), ((leds.size() == 1) ? "" : "s"));
+}
+
+int logitech_device::pipelineRequests(std::vector<longFAPrequest>& requests, std::vector<blankFAPmessage>& responses)
+{
+    /*-----------------------------------------------------------------*\
+    | Keep up to LOGITECH_PROTOCOL_PIPELINE_DEPTH requests in flight    |
+    |   Each request is tagged with a software ID in the low nibble of  |
+    |   feature_command which the device echoes in its response (or in  |
+    |   data[0] of an error response) so replies can be matched even    |
+    |   if they arrive out of order. Software IDs are handed out in     |
+    |   rotation so a late reply can not match a newer request          |
+    \*-----------------------------------------------------------------*/
+    hid_device* dev_use2    = getDevice(2);
+    int         answered    = 0;
+
+    responses.resize(requests.size());
+
+    for(std::size_t i = 0; i < responses.size(); i++)
+    {
+        responses[i].init();
+    }
+
+    if(!dev_use2)
+    {
+        discovery_complete = false;
+        return answered;
+    }
+
+    int             inflight_request[16];
+    unsigned int    inflight        = 0;
+    unsigned int    depth           = LOGITECH_PROTOCOL_PIPELINE_DEPTH;
+    unsigned int    retries         = 0;
+    std::size_t     next_request    = 0;
+    uint8_t         next_sw_id      = 1;
 
-            led_response = response.data[2];
-            for(size_t i = 0; i < led_response; i++)
+    for(std::size_t sw_id = 0; sw_id < 16; sw_id++)
+    {
+        inflight_request[sw_id] = -1;
+    }
+
+    while(next_request < requests.size() || inflight > 0)
+    {
+        while(next_request < requests.size() && inflight < depth)
+        {
+            /*-------------------------------------------------------------*\
+            | Software ID 0 is reserved for notifications                   |
+            \*-------------------------------------------------------------*/
+            uint8_t sw_id = next_sw_id;
+
+            while(inflight_request[sw_id] >= 0)
             {
-                get_count.data[0] = i;
-                get_count.data[1] = 0xFF;
-                get_count.data[2] = 0;
+                sw_id = (sw_id % 15) + 1;
+            }
 
-                result = hid_write(dev_use2, get_count.buffer, get_count.size());
-                result = hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-                LOG_DEBUG("[%s] FP8071 - LED %02i - %02X %02X %02X %02X %02X %02X %02X %02X   %02X %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(), led_counter,
-                    response.data[0], response.data[1],  response.data[2],  response.data[3],  response.data[4],  response.data[5],  response.data[6],  response.data[7],
-                    response.data[8], response.data[9], response.data[10], response.data[11], response.data[12], response.data[13], response.data[14], response.data[15]);
+            next_sw_id                      = (sw_id % 15) + 1;
 
-                logitech_led new_led;
+            longFAPrequest& request         = requests[next_request];
+            request.feature_command         = (request.feature_command & 0xF0) | sw_id;
 
-                new_led.location    = response.data[2] << 8 | response.data[3];
-                new_led.fx_count    = response.data[4];
+            hid_write(dev_use2, request.buffer, request.size());
 
-                for(uint8_t i = 0; i < new_led.fx_count; i++)
-                {
-                    blankFAPmessage fx_response;
-                    fx_response.init();
+            inflight_request[sw_id]         = (int)next_request;
+            inflight++;
+            next_request++;
+        }
 
-                    longFAPrequest get_effect;
-                    get_effect.init(device_index, RGB_feature_index, LOGITECH_CMD_RGB_EFFECTS_GET_INFO);
+        blankFAPmessage response;
+        response.init();
 
-                    get_effect.data[0] = get_count.data[0];
-                    get_effect.data[1] = i;
-                    result = hid_write(dev_use2, get_effect.buffer, get_effect.size());
-                    result = hid_read_timeout(dev_use2, fx_response.buffer, fx_response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-                    LOG_DEBUG("[%s] FP8071 - LED %02i Effect %02X - %02X %02X %02X %02X %02X %02X %02X %02X   %02X %02X %02X %02X %02X %02X %02X %02X", device_name.c_str(), get_count.data[0], i,
-                        fx_response.data[0], fx_response.data[1],  fx_response.data[2],  fx_response.data[3],  fx_response.data[4],  fx_response.data[5],  fx_response.data[6],  fx_response.data[7],
-                        fx_response.data[8], fx_response.data[9], fx_response.data[10], fx_response.data[11], fx_response.data[12], fx_response.data[13], fx_response.data[14], fx_response.data[15]);
+        int result = hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
 
-                    logitech_fx new_fx;
+        if(result <= 0)
+        {
+            /*-------------------------------------------------------------*\
+            | Some receivers drop requests when several are in flight.      |
+            |   Resend the outstanding ones and finish the batch one        |
+            |   request at a time before giving up                          |
+            \*-------------------------------------------------------------*/
+            if(retries >= LOGITECH_PROTOCOL_RETRIES)
+            {
+                LOG_DEBUG("[%s] Pipelined discovery timed out with %i request%s outstanding", device_name.c_str(), inflight, ((inflight == 1) ? "" : "s"));
+                break;
+            }
 
-                    new_fx.index    = i;
-                    new_fx.mode     = static_cast<LOGITECH_DEVICE_MODE>(fx_response.data[2] << 8 | fx_response.data[3]);
-                    new_fx.speed    = fx_response.data[6] << 8 | fx_response.data[7];
+            LOG_DEBUG("[%s] Pipelined discovery timed out, resending %i request%s", device_name.c_str(), inflight, ((inflight == 1) ? "" : "s"));
 
-                    new_led.fx.push_back(new_fx);
-                }
+            retries++;
+            depth = 1;
+
+            for(std::size_t sw_id = 1; sw_id < 16; sw_id++)
+            {
+                if(inflight_request[sw_id] >= 0)
+                {
+                    longFAPrequest& request = requests[inflight_request[sw_id]];
 
-                leds.emplace(response.data[0], new_led);
+                    hid_write(dev_use2, request.buffer, request.size());
+                }
             }
+
+            continue;
         }
 
-        /*get_count.feature_command = LOGITECH_CMD_RGB_EFFECTS_GET_STATE;
-        for(std::size_t i = 0; i < feature_count; i++ )
+        if(response.report_id != LOGITECH_LONG_MESSAGE || response.device_index != device_index)
         {
-            get_count.data[0] = i;
-            result = hid_write(dev_use2, get_count.buffer, get_count.size());
-            result = hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
+            continue;
         }
 
-        get_count.feature_command = LOGITECH_CMD_RGB_EFFECTS_GET_CONFIG;
-        for(std::size_t i = 0; i < feature_count; i++ )
+        /*-----------------------------------------------------------------*\
+        | Error responses carry the original feature index and command     |
+        \*-----------------------------------------------------------------*/
+        bool    error           = (response.feature_index == 0xFF);
+        uint8_t feature_index   = error ? response.feature_command  : response.feature_index;
+        uint8_t feature_command = error ? response.data[0]          : response.feature_command;
+        int     request_idx     = inflight_request[feature_command & 0x0F];
+
+        if(request_idx < 0
+        || requests[request_idx].feature_index   != feature_index
+        || requests[request_idx].feature_command != feature_command)
         {
-            get_count.data[0] = i;
-            result = hid_write(dev_use2, get_count.buffer, get_count.size());
-            result = hid_read_timeout(dev_use2, response.buffer, response.size(), LOGITECH_PROTOCOL_TIMEOUT);
-        }*/
+            continue;
+        }
+
+        responses[request_idx]                   = response;
+        inflight_request[feature_command & 0x0F] = -1;
+        inflight--;
+        answered++;
+    }
+
+    /*-----------------------------------------------------------------*\
+    | Unanswered requests are left with a zeroed response and mark the  |
+    |   discovery as incomplete so the result is not cached             |
+    \*-----------------------------------------------------------------*/
+    if(answered < (int)requests.size())
+    {
+        discovery_complete = false;
+    }
+
+    return answered;
+}
+
+void logitech_device::getFeatureIndexes()
+{
+    /*-----------------------------------------------------------------*\
+    | Query the root index for all feature pages used during detection |
+    |   in one pipelined batch and store the ones that exist            |
+    \*-----------------------------------------------------------------*/
+    std::vector<uint16_t> pages =
+    {
+        LOGITECH_HIDPP_PAGE_DEVICE_INFORMATION,
+        LOGITECH_HIDPP_PAGE_DEVICE_NAME_TYPE
+    };
+
+    pages.insert(pages.end(), logitech_RGB_pages.begin(), logitech_RGB_pages.end());
+
+    std::vector<longFAPrequest>     requests(pages.size());
+    std::vector<blankFAPmessage>    responses;
+
+    for(std::size_t i = 0; i < pages.size(); i++)
+    {
+        requests[i].init(device_index, LOGITECH_HIDPP_PAGE_ROOT_IDX, LOGITECH_CMD_ROOT_GET_FEATURE);
+        requests[i].data[0] = pages[i] >> 8;
+        requests[i].data[1] = pages[i] & 0xFF;
+    }
+
+    pipelineRequests(requests, responses);
+
+    for(std::size_t i = 0; i < pages.size(); i++)
+    {
+        uint8_t feature_index = responses[i].data[0];
+
+        LOG_DEBUG("[%s] Feature Page %04X found @ index %02X", device_name.c_str(), pages[i], feature_index);
+
+        if(responses[i].feature_index != 0xFF && feature_index > 0)
+        {
+            feature_list[pages[i]] = feature_index;
+        }
+    }
+
+    features::iterator find_info = feature_list.find(LOGITECH_HIDPP_PAGE_DEVICE_INFORMATION);
+
+    if(find_info != feature_list.end())
+    {
+        info_feature_index = find_info->second;
+        getFirmwareInfo();
+    }
+}
+
+bool logitech_device::getFirmwareInfo()
+{
+    /*-----------------------------------------------------------------*\
+    | Read the firmware type, name, version and build of entity 0 from  |
+    |   the Device Information feature. This is used to validate the   |
+    |   cached feature table                                            |
+    \*-----------------------------------------------------------------*/
+    firmware_info.clear();
+
+    if(info_feature_index == 0)
+    {
+        return false;
+    }
+
+    std::vector<longFAPrequest>     requests(1);
+    std::vector<blankFAPmessage>    responses;
+
+    requests[0].init(device_index, info_feature_index, LOGITECH_CMD_DEVICE_INFORMATION_GET_FW_INFO);
+
+    if(pipelineRequests(requests, responses) != 1 || responses[0].feature_index == 0xFF)
+    {
+        return false;
+    }
+
+    firmware_info.assign(responses[0].data, responses[0].data + LOGITECH_FIRMWARE_INFO_LEN);
+
+    return true;
+}
+
+bool logitech_device::loadFeatureCache()
+{
+    std::string cache_key   = location + "@" + std::to_string(device_index);
+    json        cache       = readFeatureCache();
+
+    if(!cache.contains(cache_key))
+    {
+        return false;
+    }
+
+    json entry = cache[cache_key];
+
+    if(!entry.contains("info_index") || !entry.contains("firmware") || !entry["firmware"].is_array())
+    {
+        return false;
+    }
+
+    try
+    {
+        info_feature_index = entry["info_index"];
+
+        if(!getFirmwareInfo() || firmware_info != entry["firmware"].get<std::vector<uint8_t>>())
+        {
+            LOG_DEBUG("[%s] Feature cache entry is stale", cache_key.c_str());
+            info_feature_index = 0;
+            return false;
+        }
+
+        device_name             = entry["name"];
+        logitech_device_type    = entry["type"];
+        RGB_feature_index       = entry["rgb_index"];
+
+        for(std::size_t i = 0; i < entry["features"].size(); i++)
+        {
+            feature_list[entry["features"][i][0]] = entry["features"][i][1];
+        }
+
+        for(std::size_t i = 0; i < entry["leds"].size(); i++)
+        {
+            json&           led_entry = entry["leds"][i];
+            logitech_led    new_led;
+
+            new_led.location    = led_entry["location"];
+            new_led.fx_count    = led_entry["fx"].size();
+
+            for(std::size_t fx_idx = 0; fx_idx < led_entry["fx"].size(); fx_idx++)
+            {
+                logitech_fx new_fx;
+
+                new_fx.index    = led_entry["fx"][fx_idx][0];
+                new_fx.mode     = static_cast<LOGITECH_DEVICE_MODE>(led_entry["fx"][fx_idx][1].get<uint16_t>());
+                new_fx.speed    = led_entry["fx"][fx_idx][2];
+
+                new_led.fx.push_back(new_fx);
+            }
+
+            leds.emplace(led_entry["index"].get<uint8_t>(), new_led);
+        }
+    }
+    catch(const std::exception& e)
+    {
+        LOG_WARNING("[%s] Feature cache entry is invalid: %s", cache_key.c_str(), e.what());
+        feature_list.clear();
+        leds.clear();
+        device_name.clear();
+        RGB_feature_index   = 0;
+        info_feature_index  = 0;
+        return false;
+    }
+
+    LOG_DEBUG("[%s] Loaded feature table from cache - %i LED%s", device_name.c_str(), leds.size(), ((leds.size() == 1) ? "" : "s"));
+
+    return true;
+}
+
+void logitech_device::saveFeatureCache()
+{
+    /*-----------------------------------------------------------------*\
+    | Devices without firmware info can not be validated, skip them    |
+    \*-----------------------------------------------------------------*/
+    if(firmware_info.empty() || leds.empty())
+    {
+        return;
+    }
+
+    json entry;
+
+    entry["name"]       = device_name;
+    entry["type"]       = logitech_device_type;
+    entry["rgb_index"]  = RGB_feature_index;
+    entry["info_index"] = info_feature_index;
+    entry["firmware"]   = firmware_info;
+    entry["features"]   = json::array();
+    entry["leds"]       = json::array();
+
+    for(features::iterator feature = feature_list.begin(); feature != feature_list.end(); feature++)
+    {
+        entry["features"].push_back({ feature->first, feature->second });
+    }
+
+    for(std::map<uint8_t, logitech_led>::iterator led = leds.begin(); led != leds.end(); led++)
+    {
+        json led_entry;
+
+        led_entry["index"]      = led->first;
+        led_entry["location"]   = led->second.location;
+        led_entry["fx"]         = json::array();
+
+        for(std::size_t fx_idx = 0; fx_idx < led->second.fx.size(); fx_idx++)
+        {
+            led_entry["fx"].push_back({ led->second.fx[fx_idx].index, (uint16_t)led->second.fx[fx_idx].mode, led->second.fx[fx_idx].speed });
+        }
+
+        entry["leds"].push_back(led_entry);
     }
 
-    LOG_DEBUG("[%s] led_response returned %i led_counter returned %i : setting controller to %i LED%s", device_name.c_str(), led_response, led_counter, leds.size(), ((leds.size() == 1) ? "" : "s"));
+    writeFeatureCache(location + "@" + std::to_string(device_index), entry);
 }
 
 uint8_t logitech_device::setDirectMode(bool direct)
@@ -8,13 +8,21 @@
 \*-------------------------------------------------------------------*/
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <hidapi/hidapi.h>
 #include "LogManager.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
 
 #pragma once
 
 #define LOGITECH_PROTOCOL_TIMEOUT                       300     //Timeout in ms
+#define LOGITECH_PROTOCOL_PIPELINE_DEPTH                4       //Requests in flight during discovery
+#define LOGITECH_PROTOCOL_RETRIES                       3       //Timeouts allowed per discovery batch
+#define LOGITECH_FEATURE_CACHE_FILENAME                 "LogitechFeatureCache.json"
 #define LOGITECH_HEADER_SIZE                            3
 #define LOGITECH_SHORT_MESSAGE                          0x10
 #define LOGITECH_SHORT_MESSAGE_LEN                      7
@@ -35,6 +43,10 @@
 #define LOGITECH_CMD_FEATURE_SET_GET_COUNT              0x01
 #define LOGITECH_CMD_FEATURE_SET_GET_ID                 0x11
 
+#define LOGITECH_HIDPP_PAGE_DEVICE_INFORMATION          0x0003
+#define LOGITECH_CMD_DEVICE_INFORMATION_GET_FW_INFO     0x11
+#define LOGITECH_FIRMWARE_INFO_LEN                      9       //Type, name prefix, number, revision and build
+
 #define LOGITECH_HIDPP_PAGE_DEVICE_NAME_TYPE            0x0005
 #define LOTITECH_CMD_DEVICE_NAME_TYPE_GET_COUNT         0x01
 #define LOGITECH_CMD_DEVICE_NAME_TYPE_GET_DEVICE_NAME	0x11
@@ -242,6 +254,8 @@ public:
     features                    feature_list;
     uint8_t                     device_index;
     uint8_t                     RGB_feature_index;      //Stored for quick use
+    uint8_t                     info_feature_index;     //Device Information, used to validate the feature cache
+    bool                        discovery_complete;     //Cleared when a discovery request goes unanswered
     uint8_t                     logitech_device_type;
     bool                        wireless;
     std::string                 device_name;
@@ -260,10 +274,16 @@ public:
 private:
     std::map<uint8_t, logitech_led> leds;
     std::shared_ptr<std::mutex> mutex;
+    std::vector<uint8_t>        firmware_info;
 
     hid_device*                 getDevice(uint8_t usage_index);
     uint16_t                    getFeaturePage(uint8_t feature_index);
     int                         getDeviceFeatureList();
+    void                        getFeatureIndexes();
+    bool                        getFirmwareInfo();
     void                        getRGBconfig();
     void                        initialiseDevice();
+    int                         pipelineRequests(std::vector<longFAPrequest>& requests, std::vector<blankFAPmessage>& responses);
+    bool                        loadFeatureCache();
+    void                        saveFeatureCache();
 };
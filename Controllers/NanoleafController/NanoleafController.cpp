@@ -169,7 +169,7 @@ void NanoleafController::UpdateLEDs(std::vector<RGBColor>& colors)
         \*---------------------------------------------------------*/
         uint8_t size        = panel_ids.size();
 
-        uint8_t* message    = (uint8_t*)malloc((size * 7) + 1);
+        message.resize((size * 7) + 1);
 
         message[0]          = (uint8_t)size;                                /* nPanels          */
 
@@ -184,9 +184,7 @@ void NanoleafController::UpdateLEDs(std::vector<RGBColor>& colors)
             message[(7 * i) + 6 + 1] = (uint8_t)0;                          /* transitionTime   */
         }
 
-        external_control_socket.udp_write((char*)message, (size * 7) + 1);
-
-        free(message);
+        external_control_socket.udp_write((char *)message.data(), (int)message.size());
     }
     else if((model == NANOLEAF_CANVAS_MODEL)
          || (model == NANOLEAF_SHAPES_MODEL))
@@ -207,7 +205,7 @@ void NanoleafController::UpdateLEDs(std::vector<RGBColor>& colors)
         \*---------------------------------------------------------*/
         uint8_t size        = panel_ids.size();
 
-        uint8_t* message    = (uint8_t*)malloc((size * 8) + 2);
+        message.resize((size * 8) + 2);
 
         message[0]          = (uint8_t)(size >> 8);                         /* nPanels H        */
         message[1]          = (uint8_t)(size & 0xFF);                       /* nPanels L        */
@@ -224,9 +222,7 @@ void NanoleafController::UpdateLEDs(std::vector<RGBColor>& colors)
             message[(8 * i) + 7 + 2] = (uint8_t)0;                          /* transitionTime L */
         }
 
-        external_control_socket.udp_write((char *)message, (size * 8) + 2);
-
-        free(message);
+        external_control_socket.udp_write((char *)message.data(), (int)message.size());
     }
 }
 
@@ -56,6 +56,7 @@ private:
 
     std::vector<std::string>    effects;
     std::vector<int>            panel_ids;
+    std::vector<uint8_t>        message;
 
     std::string                 selectedEffect;
     int                         brightness;
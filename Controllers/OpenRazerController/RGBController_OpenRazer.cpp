@@ -17,74 +17,62 @@ using namespace std::chrono_literals;
 
 void RGBController_OpenRazer::DeviceUpdateLEDs()
 {
-
     switch(matrix_type)
     {
         case RAZER_TYPE_MATRIX_FRAME:
-        case RAZER_TYPE_MATRIX_NOFRAME:
-        case RAZER_TYPE_MATRIX_STATIC:
             {
-                char update_value = 1;
+                /*---------------------------------------------*\
+                | The OpenRazer driver parses any number of     |
+                | row_index, start_col, stop_col, RGB... rows   |
+                | from a single matrix_custom_frame write, so   |
+                | build the whole frame and write it at once    |
+                \*---------------------------------------------*/
+                unsigned int row_size = 3 + (matrix_cols * 3);
 
-                for (unsigned int row = 0; row < matrix_rows; row++)
-                {
-                    unsigned int output_array_size;
-                    unsigned int output_offset;
-                    unsigned int row_offset = (row * matrix_cols);
+                frame_buffer.resize(matrix_rows * row_size);
 
-                    if(matrix_type == RAZER_TYPE_MATRIX_FRAME)
-                    {
-                        output_array_size = 3 + (matrix_cols* 3);
-                        output_offset = 3;
-                    }
-                    else
-                    {
-                        output_array_size = 3;
-                        output_offset = 0;
-                    }
-
-                    char* output_array = new char[output_array_size];
+                for(unsigned int row = 0; row < matrix_rows; row++)
+                {
+                    char*        output_array = &frame_buffer[row * row_size];
+                    unsigned int row_offset   = (row * matrix_cols);
 
-                    if(matrix_type == RAZER_TYPE_MATRIX_FRAME)
-                    {
-                        output_array[0] = row;
-                        output_array[1] = 0;
-                        output_array[2] = matrix_cols - 1;
-                    }
+                    output_array[0] = row;
+                    output_array[1] = 0;
+                    output_array[2] = matrix_cols - 1;
 
                     for(unsigned int col = 0; col < matrix_cols; col++)
                     {
                         unsigned int color_idx = col + row_offset;
-                        output_array[(col * 3) + 0 + output_offset] = (char)RGBGetRValue(colors[color_idx]);
-                        output_array[(col * 3) + 1 + output_offset] = (char)RGBGetGValue(colors[color_idx]);
-                        output_array[(col * 3) + 2 + output_offset] = (char)RGBGetBValue(colors[color_idx]);
+                        output_array[(col * 3) + 3] = (char)RGBGetRValue(colors[color_idx]);
+                        output_array[(col * 3) + 4] = (char)RGBGetGValue(colors[color_idx]);
+                        output_array[(col * 3) + 5] = (char)RGBGetBValue(colors[color_idx]);
                     }
+                }
 
-                    if(matrix_type == RAZER_TYPE_MATRIX_FRAME)
-                    {
-                        matrix_custom_frame.write(output_array, output_array_size);
-                        matrix_custom_frame.flush();
-                    }
-                    else if(matrix_type == RAZER_TYPE_MATRIX_NOFRAME)
-                    {
-                        matrix_effect_custom.write(output_array, output_array_size);
-                        matrix_effect_custom.flush();
-                    }
-                    else
-                    {
-                        matrix_effect_static.write(output_array, output_array_size);
-                        matrix_effect_static.flush();
-                    }
+                matrix_custom_frame.write(frame_buffer.data(), frame_buffer.size());
 
-                    delete[] output_array;
+                char update_value = 1;
 
-                    std::this_thread::sleep_for(1ms);
-                }
+                matrix_effect_custom.write(&update_value, 1);
+            }
+            break;
+
+        case RAZER_TYPE_MATRIX_NOFRAME:
+        case RAZER_TYPE_MATRIX_STATIC:
+            {
+                char output_array[3];
+
+                output_array[0] = (char)RGBGetRValue(colors[0]);
+                output_array[1] = (char)RGBGetGValue(colors[0]);
+                output_array[2] = (char)RGBGetBValue(colors[0]);
 
-                if(matrix_type == RAZER_TYPE_MATRIX_FRAME)
+                if(matrix_type == RAZER_TYPE_MATRIX_NOFRAME)
+                {
+                    matrix_effect_custom.write(output_array, 3);
+                }
+                else
                 {
-                    matrix_effect_custom.write(&update_value, 1);
-                    matrix_effect_custom.flush();
+                    matrix_effect_static.write(output_array, 3);
                 }
             }
             break;
@@ -206,7 +194,6 @@ void RGBController_OpenRazer::OpenFunctions(std::string dev_path)
     if((logo_matrix_effect_none || scroll_matrix_effect_none) && matrix_effect_custom)
     {
         matrix_effect_custom.close();
-        matrix_effect_custom.setstate(std::ios::failbit);
     }
 }
 
@@ -612,7 +599,6 @@ void RGBController_OpenRazer::DeviceUpdateMode()
             if(matrix_effect_custom)
             {
                 matrix_effect_custom.write(update_value, 1);
-                matrix_effect_custom.flush();
             }
             break;
 
@@ -620,52 +606,44 @@ void RGBController_OpenRazer::DeviceUpdateMode()
             if(matrix_effect_none)
             {
                 matrix_effect_none.write(update_value, 1);
-                matrix_effect_none.flush();
             }
 
             if(logo_matrix_effect_none)
             {
                 logo_matrix_effect_none.write(update_value, 1);
-                logo_matrix_effect_none.flush();
             }
 
             if(scroll_matrix_effect_none)
             {
                 scroll_matrix_effect_none.write(update_value, 1);
-                scroll_matrix_effect_none.flush();
             }
 
             if(left_matrix_effect_none)
             {
                 left_matrix_effect_none.write(update_value, 1);
-                left_matrix_effect_none.flush();
             }
 
             if(right_matrix_effect_none)
             {
                 right_matrix_effect_none.write(update_value, 1);
-                right_matrix_effect_none.flush();
             }
 
             if(backlight_led_state)
             {
                 update_value[0] = '0';
                 backlight_led_state.write(update_value, 1);
-                backlight_led_state.flush();
             }
 
             if(logo_led_state)
             {
                 update_value[0] = '0';
                 logo_led_state.write(update_value, 1);
-                logo_led_state.flush();
             }
 
             if(scroll_led_state)
             {
                 update_value[0] = '0';
                 scroll_led_state.write(update_value, 1);
-                scroll_led_state.flush();
             }
             break;
 
@@ -676,21 +654,18 @@ void RGBController_OpenRazer::DeviceUpdateMode()
             {
                 update_value[0] = '1';
                 backlight_led_state.write(update_value, 1);
-                backlight_led_state.flush();
             }
 
             if(logo_led_state)
             {
                 update_value[0] = '1';
                 logo_led_state.write(update_value, 1);
-                logo_led_state.flush();
             }
 
             if(scroll_led_state)
             {
                 update_value[0] = '1';
                 scroll_led_state.write(update_value, 1);
-                scroll_led_state.flush();
             }
 
             update_value[0] = RGBGetRValue(modes[active_mode].colors[0]);
@@ -700,55 +675,44 @@ void RGBController_OpenRazer::DeviceUpdateMode()
             if(matrix_effect_static)
             {
                 matrix_effect_static.write(update_value, 3);
-                matrix_effect_static.flush();
             }
 
             if(logo_matrix_effect_static)
             {
                 logo_matrix_effect_static.write(update_value, 3);
-                logo_matrix_effect_static.flush();
             }
 
             if(scroll_matrix_effect_static)
             {
                 scroll_matrix_effect_static.write(update_value, 3);
-                scroll_matrix_effect_static.flush();
             }
 
             if(left_matrix_effect_static)
             {
                 left_matrix_effect_static.write(update_value, 3);
-                left_matrix_effect_static.flush();
             }
 
             if(right_matrix_effect_static)
             {
                 right_matrix_effect_static.write(update_value, 3);
-                right_matrix_effect_static.flush();
             }
 
             if(backlight_led_effect && backlight_led_rgb)
             {
                 backlight_led_rgb.write(update_value, 3);
-                backlight_led_rgb.flush();
                 backlight_led_effect.write(effect_value, 1);
-                backlight_led_effect.flush();
             }
 
             if(logo_led_effect && logo_led_rgb)
             {
                 logo_led_rgb.write(update_value, 3);
-                logo_led_rgb.flush();
                 logo_led_effect.write(effect_value, 1);
-                logo_led_effect.flush();
             }
 
             if(scroll_led_effect && scroll_led_rgb)
             {
                 scroll_led_rgb.write(update_value, 3);
-                scroll_led_rgb.flush();
                 scroll_led_effect.write(effect_value, 1);
-                scroll_led_effect.flush();
             }
             break;
 
@@ -759,21 +723,18 @@ void RGBController_OpenRazer::DeviceUpdateMode()
             {
                 update_value[0] = '1';
                 backlight_led_state.write(update_value, 1);
-                backlight_led_state.flush();
             }
 
             if(logo_led_state)
             {
                 update_value[0] = '1';
                 logo_led_state.write(update_value, 1);
-                logo_led_state.flush();
             }
 
             if(scroll_led_state)
             {
                 update_value[0] = '1';
                 scroll_led_state.write(update_value, 1);
-                scroll_led_state.flush();
             }
 
             update_value[0] = RGBGetRValue(modes[active_mode].colors[0]);
@@ -783,25 +744,19 @@ void RGBController_OpenRazer::DeviceUpdateMode()
             if(backlight_led_effect && backlight_led_rgb)
             {
                 backlight_led_rgb.write(update_value, 3);
-                backlight_led_rgb.flush();
                 backlight_led_effect.write(effect_value, 1);
-                backlight_led_effect.flush();
             }
 
             if(logo_led_effect && logo_led_rgb)
             {
                 logo_led_rgb.write(update_value, 3);
-                logo_led_rgb.flush();
                 logo_led_effect.write(effect_value, 1);
-                logo_led_effect.flush();
             }
 
             if(scroll_led_effect && scroll_led_rgb)
             {
                 scroll_led_rgb.write(update_value, 3);
-                scroll_led_rgb.flush();
                 scroll_led_effect.write(effect_value, 1);
-                scroll_led_effect.flush();
             }
             break;
 
@@ -815,21 +770,18 @@ void RGBController_OpenRazer::DeviceUpdateMode()
                     {
                         update_value[0] = '1';
                         backlight_led_state.write(update_value, 1);
-                        backlight_led_state.flush();
                     }
 
                     if(logo_led_state)
                     {
                         update_value[0] = '1';
                         logo_led_state.write(update_value, 1);
-                        logo_led_state.flush();
                     }
 
                     if(scroll_led_state)
                     {
                         update_value[0] = '1';
                         scroll_led_state.write(update_value, 1);
-                        scroll_led_state.flush();
                     }
 
                     update_value[0] = RGBGetRValue(modes[active_mode].colors[0]);
@@ -845,31 +797,26 @@ void RGBController_OpenRazer::DeviceUpdateMode()
                         if(matrix_effect_breath)
                         {
                             matrix_effect_breath.write(update_value, 6);
-                            matrix_effect_breath.flush();
                         }
 
                         if(logo_matrix_effect_breath)
                         {
                             logo_matrix_effect_breath.write(update_value, 6);
-                            logo_matrix_effect_breath.flush();
                         }
 
                         if(scroll_matrix_effect_breath)
                         {
                             scroll_matrix_effect_breath.write(update_value, 6);
-                            scroll_matrix_effect_breath.flush();
                         }
 
                         if(left_matrix_effect_breath)
                         {
                             left_matrix_effect_breath.write(update_value, 6);
-                            left_matrix_effect_breath.flush();
                         }
 
                         if(right_matrix_effect_breath)
                         {
                             right_matrix_effect_breath.write(update_value, 6);
-                            right_matrix_effect_breath.flush();
                         }
                     }
                     else
@@ -877,55 +824,44 @@ void RGBController_OpenRazer::DeviceUpdateMode()
                         if(matrix_effect_breath)
                         {
                             matrix_effect_breath.write(update_value, 3);
-                            matrix_effect_breath.flush();
                         }
 
                         if(logo_matrix_effect_breath)
                         {
                             logo_matrix_effect_breath.write(update_value, 3);
-                            logo_matrix_effect_breath.flush();
                         }
 
                         if(scroll_matrix_effect_breath)
                         {
                             scroll_matrix_effect_breath.write(update_value, 3);
-                            scroll_matrix_effect_breath.flush();
                         }
 
                         if(left_matrix_effect_breath)
                         {
                             left_matrix_effect_breath.write(update_value, 3);
-                            left_matrix_effect_breath.flush();
                         }
 
                         if(right_matrix_effect_breath)
                         {
                             right_matrix_effect_breath.write(update_value, 3);
-                            right_matrix_effect_breath.flush();
                         }
 
                         if(backlight_led_effect && backlight_led_rgb)
                         {
                             backlight_led_rgb.write(update_value, 3);
-                            backlight_led_rgb.flush();
                             backlight_led_effect.write(effect_value, 1);
-                            backlight_led_effect.flush();
                         }
 
                         if(logo_led_effect && logo_led_rgb)
                         {
                             logo_led_rgb.write(update_value, 3);
-                            logo_led_rgb.flush();
                             logo_led_effect.write(effect_value, 1);
-                            logo_led_effect.flush();
                         }
 
                         if(scroll_led_effect && scroll_led_rgb)
                         {
                             scroll_led_rgb.write(update_value, 3);
-                            scroll_led_rgb.flush();
                             scroll_led_effect.write(effect_value, 1);
-                            scroll_led_effect.flush();
                         }
                     }
                     break;
@@ -934,31 +870,26 @@ void RGBController_OpenRazer::DeviceUpdateMode()
                     if(matrix_effect_breath)
                     {
                         matrix_effect_breath.write(update_value, 1);
-                        matrix_effect_breath.flush();
                     }
 
                     if(logo_matrix_effect_breath)
                     {
                         logo_matrix_effect_breath.write(update_value, 1);
-                        logo_matrix_effect_breath.flush();
                     }
 
                     if(scroll_matrix_effect_breath)
                     {
                         scroll_matrix_effect_breath.write(update_value, 1);
-                        scroll_matrix_effect_breath.flush();
                     }
 
                     if(left_matrix_effect_breath)
                     {
                         left_matrix_effect_breath.write(update_value, 1);
-                        left_matrix_effect_breath.flush();
                     }
 
                     if(right_matrix_effect_breath)
                     {
                         right_matrix_effect_breath.write(update_value, 1);
-                        right_matrix_effect_breath.flush();
                     }
 
                     break;
@@ -972,69 +903,58 @@ void RGBController_OpenRazer::DeviceUpdateMode()
             {
                 update_value[0] = '1';
                 backlight_led_state.write(update_value, 1);
-                backlight_led_state.flush();
             }
 
             if(logo_led_state)
             {
                 update_value[0] = '1';
                 logo_led_state.write(update_value, 1);
-                logo_led_state.flush();
             }
 
             if(scroll_led_state)
             {
                 update_value[0] = '1';
                 scroll_led_state.write(update_value, 1);
-                scroll_led_state.flush();
             }
 
             if(matrix_effect_spectrum)
             {
                 matrix_effect_spectrum.write(update_value, 1);
-                matrix_effect_spectrum.flush();
             }
 
             if(logo_matrix_effect_spectrum)
             {
                 logo_matrix_effect_spectrum.write(update_value, 1);
-                logo_matrix_effect_spectrum.flush();
             }
 
             if(scroll_matrix_effect_spectrum)
             {
                 scroll_matrix_effect_spectrum.write(update_value, 1);
-                scroll_matrix_effect_spectrum.flush();
             }
 
             if(left_matrix_effect_spectrum)
             {
                 left_matrix_effect_spectrum.write(update_value, 1);
-                left_matrix_effect_spectrum.flush();
             }
 
             if(right_matrix_effect_spectrum)
             {
                 right_matrix_effect_spectrum.write(update_value, 1);
-                right_matrix_effect_spectrum.flush();
             }
 
             if(backlight_led_effect)
             {
                 backlight_led_effect.write(effect_value, 1);
-                backlight_led_effect.flush();
             }
 
             if(logo_led_effect)
             {
                 logo_led_effect.write(effect_value, 1);
-                logo_led_effect.flush();
             }
 
             if(scroll_led_effect)
             {
                 scroll_led_effect.write(effect_value, 1);
-                scroll_led_effect.flush();
             }
             break;
 
@@ -1053,19 +973,16 @@ void RGBController_OpenRazer::DeviceUpdateMode()
             if(matrix_effect_wave)
             {
                 matrix_effect_wave.write(update_value, 1);
-                matrix_effect_wave.flush();
             }
 
             if(left_matrix_effect_wave)
             {
                 left_matrix_effect_wave.write(update_value, 1);
-                left_matrix_effect_wave.flush();
             }
 
             if(right_matrix_effect_wave)
             {
                 right_matrix_effect_wave.write(update_value, 1);
-                right_matrix_effect_wave.flush();
             }
             break;
 
@@ -1073,31 +990,26 @@ void RGBController_OpenRazer::DeviceUpdateMode()
             if(matrix_effect_reactive)
             {
                 matrix_effect_reactive.write(update_value, 1);
-                matrix_effect_reactive.flush();
             }
 
             if(logo_matrix_effect_reactive)
             {
                 logo_matrix_effect_reactive.write(update_value, 1);
-                logo_matrix_effect_reactive.flush();
             }
 
             if(scroll_matrix_effect_reactive)
             {
                 scroll_matrix_effect_reactive.write(update_value, 1);
-                scroll_matrix_effect_reactive.flush();
             }
 
             if(left_matrix_effect_reactive)
             {
                 left_matrix_effect_reactive.write(update_value, 1);
-                left_matrix_effect_reactive.flush();
             }
 
             if(right_matrix_effect_reactive)
             {
                 right_matrix_effect_reactive.write(update_value, 1);
-                right_matrix_effect_reactive.flush();
             }
             break;
     }
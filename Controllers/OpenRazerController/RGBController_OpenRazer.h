@@ -10,6 +10,7 @@
 #pragma once
 
 #include "RGBController.h"
+#include "sysfs_attr.h"
 
 #include <fstream>
 
@@ -63,62 +64,64 @@ private:
     unsigned int matrix_rows;
     unsigned int matrix_cols;
 
+    std::vector<char> frame_buffer;
+
     void OpenFunctions(std::string dev_path);
 
     std::ifstream device_type;
     std::ifstream device_serial;
     std::ifstream firmware_version;
 
-    std::ofstream matrix_custom_frame;
-    std::ofstream matrix_brightness;
-
-    std::ofstream matrix_effect_custom;
-    std::ofstream matrix_effect_none;
-    std::ofstream matrix_effect_static;
-    std::ofstream matrix_effect_breath;
-    std::ofstream matrix_effect_spectrum;
-    std::ofstream matrix_effect_reactive;
-    std::ofstream matrix_effect_wave;
-
-    std::ofstream logo_led_brightness;
-    std::ofstream logo_matrix_effect_none;
-    std::ofstream logo_matrix_effect_static;
-    std::ofstream logo_matrix_effect_breath;
-    std::ofstream logo_matrix_effect_spectrum;
-    std::ofstream logo_matrix_effect_reactive;
-
-    std::ofstream scroll_led_brightness;
-    std::ofstream scroll_matrix_effect_none;
-    std::ofstream scroll_matrix_effect_static;
-    std::ofstream scroll_matrix_effect_breath;
-    std::ofstream scroll_matrix_effect_spectrum;
-    std::ofstream scroll_matrix_effect_reactive;
-
-    std::ofstream left_led_brightness;
-    std::ofstream left_matrix_effect_none;
-    std::ofstream left_matrix_effect_static;
-    std::ofstream left_matrix_effect_breath;
-    std::ofstream left_matrix_effect_spectrum;
-    std::ofstream left_matrix_effect_reactive;
-    std::ofstream left_matrix_effect_wave;
-
-    std::ofstream right_led_brightness;
-    std::ofstream right_matrix_effect_none;
-    std::ofstream right_matrix_effect_static;
-    std::ofstream right_matrix_effect_breath;
-    std::ofstream right_matrix_effect_spectrum;
-    std::ofstream right_matrix_effect_reactive;
-    std::ofstream right_matrix_effect_wave;
-
-    std::ofstream backlight_led_effect;
-    std::ofstream backlight_led_rgb;
-    std::ofstream backlight_led_state;
+    sysfs_attr    matrix_custom_frame;
+    sysfs_attr    matrix_brightness;
+
+    sysfs_attr    matrix_effect_custom;
+    sysfs_attr    matrix_effect_none;
+    sysfs_attr    matrix_effect_static;
+    sysfs_attr    matrix_effect_breath;
+    sysfs_attr    matrix_effect_spectrum;
+    sysfs_attr    matrix_effect_reactive;
+    sysfs_attr    matrix_effect_wave;
+
+    sysfs_attr    logo_led_brightness;
+    sysfs_attr    logo_matrix_effect_none;
+    sysfs_attr    logo_matrix_effect_static;
+    sysfs_attr    logo_matrix_effect_breath;
+    sysfs_attr    logo_matrix_effect_spectrum;
+    sysfs_attr    logo_matrix_effect_reactive;
+
+    sysfs_attr    scroll_led_brightness;
+    sysfs_attr    scroll_matrix_effect_none;
+    sysfs_attr    scroll_matrix_effect_static;
+    sysfs_attr    scroll_matrix_effect_breath;
+    sysfs_attr    scroll_matrix_effect_spectrum;
+    sysfs_attr    scroll_matrix_effect_reactive;
+
+    sysfs_attr    left_led_brightness;
+    sysfs_attr    left_matrix_effect_none;
+    sysfs_attr    left_matrix_effect_static;
+    sysfs_attr    left_matrix_effect_breath;
+    sysfs_attr    left_matrix_effect_spectrum;
+    sysfs_attr    left_matrix_effect_reactive;
+    sysfs_attr    left_matrix_effect_wave;
+
+    sysfs_attr    right_led_brightness;
+    sysfs_attr    right_matrix_effect_none;
+    sysfs_attr    right_matrix_effect_static;
+    sysfs_attr    right_matrix_effect_breath;
+    sysfs_attr    right_matrix_effect_spectrum;
+    sysfs_attr    right_matrix_effect_reactive;
+    sysfs_attr    right_matrix_effect_wave;
+
+    sysfs_attr    backlight_led_effect;
+    sysfs_attr    backlight_led_rgb;
+    sysfs_attr    backlight_led_state;
     
-    std::ofstream logo_led_effect;
-    std::ofstream logo_led_rgb;
-    std::ofstream logo_led_state;
+    sysfs_attr    logo_led_effect;
+    sysfs_attr    logo_led_rgb;
+    sysfs_attr    logo_led_state;
     
-    std::ofstream scroll_led_effect;
-    std::ofstream scroll_led_rgb;
-    std::ofstream scroll_led_state;
+    sysfs_attr    scroll_led_effect;
+    sysfs_attr    scroll_led_rgb;
+    sysfs_attr    scroll_led_state;
 };
@@ -12,6 +12,7 @@
 #pragma once
 
 #include "QMKOpenRGBController.h"
+#include "hid_pacer.h"
 
 class QMKOpenRGBRev9Controller
 {
@@ -57,6 +58,7 @@ private:
     std::string     device_vendor;
 
     std::chrono::milliseconds   delay;
+    hid_pacer                   pacer;
 
     unsigned int    total_number_of_leds;
     unsigned int    total_number_of_leds_with_empty_space;
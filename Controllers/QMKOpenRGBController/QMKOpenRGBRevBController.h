@@ -10,6 +10,7 @@
 #pragma once
 
 #include "QMKOpenRGBController.h"
+#include "hid_pacer.h"
 
 class QMKOpenRGBRevBController
 {
@@ -55,6 +56,7 @@ private:
     std::string     device_vendor;
 
     std::chrono::milliseconds   delay;
+    hid_pacer                   pacer;
 
     unsigned int    total_number_of_leds;
     unsigned int    total_number_of_leds_with_empty_space;
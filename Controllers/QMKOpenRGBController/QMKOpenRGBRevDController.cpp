@@ -96,6 +96,12 @@ QMKOpenRGBRevDController::QMKOpenRGBRevDController(hid_device *dev_handle, const
         delay = 0ms;
     }
 
+    /*-----------------------------------------------------*\
+    | QMK does not acknowledge direct mode packets, so pace |
+    | them at the configured delay on a per-frame deadline  |
+    \*-----------------------------------------------------*/
+    pacer.set_limits(delay, delay, delay);
+
     dev         = dev_handle;
     location    = path;
 
@@ -486,6 +492,8 @@ void QMKOpenRGBRevDController::DirectModeSetLEDs(std::vector<RGBColor> colors, u
     unsigned int leds_sent           = 0;
     unsigned int tmp_leds_per_update = leds_per_update;
 
+    pacer.begin_frame();
+
     while (leds_sent < leds_count)
     {
         if ((leds_count - leds_sent) < tmp_leds_per_update)
@@ -515,12 +523,9 @@ void QMKOpenRGBRevDController::DirectModeSetLEDs(std::vector<RGBColor> colors, u
             usb_buf[(led_idx * 4) + 6] = RGBGetBValue(colors[led_idx + leds_sent]);
         }
 
-        hid_write(dev, usb_buf, 65);
+        pacer.wait();
 
-        if(delay > 0ms)
-        {
-            std::this_thread::sleep_for(delay);
-        }
+        hid_write(dev, usb_buf, 65);
 
         leds_sent += tmp_leds_per_update;
     }
@@ -23,6 +23,10 @@ RazerController::RazerController(hid_device* dev_handle, hid_device* dev_argb_ha
     name            = dev_name;
     device_index    = 0;
 
+    pacer_frame_count = 0;
+
+    pacer.set_limits(RAZER_PACER_INITIAL_INTERVAL, RAZER_PACER_MIN_INTERVAL, RAZER_PACER_MAX_INTERVAL);
+
     /*-----------------------------------------------------------------*\
     | Loop through all known devices to look for a name match           |
     \*-----------------------------------------------------------------*/
@@ -479,6 +483,11 @@ void RazerController::SetLEDs(RGBColor* colors)
     \*---------------------------------------------------------*/
     unsigned char* output_array = new unsigned char[matrix_cols * 3];
 
+    /*---------------------------------------------------------*\
+    | Start a new frame on the report pacer                     |
+    \*---------------------------------------------------------*/
+    pacer.begin_frame();
+
     /*---------------------------------------------------------*\
     | Send one row of the custom frame at a time                |
     \*---------------------------------------------------------*/
@@ -500,18 +509,31 @@ void RazerController::SetLEDs(RGBColor* colors)
         /*-----------------------------------------------------*\
         | Send the output array to the device                   |
         \*-----------------------------------------------------*/
-        std::this_thread::sleep_for(1ms);
+        pacer.wait();
 
         razer_set_custom_frame(row, 0, matrix_cols - 1, output_array);
     }
 
-    std::this_thread::sleep_for(1ms);
+    pacer.wait();
 
     /*---------------------------------------------------------*\
     | Set custom mode to apply frame                            |
     \*---------------------------------------------------------*/
     razer_set_mode_custom();
 
+    /*---------------------------------------------------------*\
+    | Periodically read back the device status to tune the      |
+    | inter-report interval                                     |
+    \*---------------------------------------------------------*/
+    pacer_frame_count++;
+
+    if(pacer_frame_count >= RAZER_PACER_STATUS_FRAMES)
+    {
+        pacer_frame_count = 0;
+
+        pacer.report_status(razer_get_pacer_status());
+    }
+
     /*---------------------------------------------------------*\
     | Delete the output array                                   |
     \*---------------------------------------------------------*/
@@ -1250,6 +1272,46 @@ void RazerController::razer_get_keyboard_info(unsigned char* layout, unsigned ch
     *variant = response_report.arguments[1];
 }
 
+int RazerController::razer_get_pacer_status()
+{
+    /*---------------------------------------------------------*\
+    | ARGB devices do not return a status for custom frames     |
+    \*---------------------------------------------------------*/
+    if(matrix_type == RAZER_MATRIX_TYPE_EXTENDED_ARGB)
+    {
+        return(HID_PACER_STATUS_UNKNOWN);
+    }
+
+    struct razer_report response_report = razer_create_response();
+
+    /*---------------------------------------------------------*\
+    | Read the status one pacer interval after the last report, |
+    | otherwise it still reads BUSY                             |
+    \*---------------------------------------------------------*/
+    pacer.wait();
+
+    if(razer_usb_receive(&response_report) < 0)
+    {
+        return(HID_PACER_STATUS_FAILED);
+    }
+
+    switch(response_report.status)
+    {
+        case RAZER_STATUS_SUCCESSFUL:
+            return(HID_PACER_STATUS_OK);
+
+        case RAZER_STATUS_BUSY:
+            return(HID_PACER_STATUS_BUSY);
+
+        case RAZER_STATUS_FAILURE:
+        case RAZER_STATUS_TIMEOUT:
+            return(HID_PACER_STATUS_FAILED);
+
+        default:
+            return(HID_PACER_STATUS_UNKNOWN);
+    }
+}
+
 unsigned char RazerController::GetKeyboardLayoutType()
 {
     unsigned char layout;
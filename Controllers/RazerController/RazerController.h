@@ -7,6 +7,7 @@
 \*-----------------------------------------*/
 
 #include "RGBController.h"
+#include "hid_pacer.h"
 
 #include <string>
 #include <hidapi/hidapi.h>
@@ -54,6 +55,34 @@ enum
     RAZER_COMMAND_ID_GET_KEYBOARD_INFO          = 0x86,
 };
 
+/*---------------------------------------------------------*\
+| Razer Report Status (taken from OpenRazer)                |
+\*---------------------------------------------------------*/
+enum
+{
+    RAZER_STATUS_NEW_COMMAND                    = 0x00,
+    RAZER_STATUS_BUSY                           = 0x01,
+    RAZER_STATUS_SUCCESSFUL                     = 0x02,
+    RAZER_STATUS_FAILURE                        = 0x03,
+    RAZER_STATUS_TIMEOUT                        = 0x04,
+    RAZER_STATUS_NOT_SUPPORTED                  = 0x05,
+};
+
+/*---------------------------------------------------------*\
+| Number of frames between status polls used to tune the    |
+| inter-report pacing                                       |
+\*---------------------------------------------------------*/
+#define RAZER_PACER_STATUS_FRAMES               4
+
+/*---------------------------------------------------------*\
+| Inter-report pacing limits.  Frames start at the 1ms gap  |
+| used before the pacer and may be shortened down to the    |
+| minimum while the device keeps reporting success          |
+\*---------------------------------------------------------*/
+#define RAZER_PACER_INITIAL_INTERVAL            std::chrono::microseconds(1000)
+#define RAZER_PACER_MIN_INTERVAL                std::chrono::microseconds(250)
+#define RAZER_PACER_MAX_INTERVAL                std::chrono::microseconds(10000)
+
 /*---------------------------------------------------------*\
 | Razer Storage Flags                                       |
 \*---------------------------------------------------------*/
@@ -280,6 +309,12 @@ private:
     \*---------------------------------------------------------*/
     unsigned char           matrix_type;
 
+    /*---------------------------------------------------------*\
+    | Inter-report pacing for custom frames                     |
+    \*---------------------------------------------------------*/
+    hid_pacer               pacer;
+    unsigned int            pacer_frame_count;
+
     /*---------------------------------------------------------*\
     | Private functions based on OpenRazer                      |
     \*---------------------------------------------------------*/
@@ -318,6 +353,7 @@ private:
     std::string             razer_get_firmware();
     std::string             razer_get_serial();
     void                    razer_get_keyboard_info(unsigned char* layout, unsigned char* variant);
+    int                     razer_get_pacer_status();
 
     void                    razer_set_brightness(unsigned char brightness);
     void                    razer_set_custom_frame(unsigned char row_index, unsigned char start_col, unsigned char stop_col, unsigned char* rgb_data);
@@ -0,0 +1,439 @@
+/*-----------------------------------------*\
+|  EffectsEngine.cpp                        |
+|                                           |
+|  Server-side software effects for devices |
+|  with a Direct mode                       |
+\*-----------------------------------------*/
+
+#include "EffectsEngine.h"
+#include "LogManager.h"
+#include "hsv.h"
+
+#include <math.h>
+
+/*---------------------------------------------------------*\
+| Effect cycles per second at speed 1                       |
+\*---------------------------------------------------------*/
+#define EFFECTS_ENGINE_SPEED_SCALE      0.02f
+#define EFFECTS_ENGINE_SPEED_MIN        1
+#define EFFECTS_ENGINE_SPEED_MAX        100
+#define EFFECTS_ENGINE_SPEED_DEFAULT    20
+#define EFFECTS_ENGINE_TWO_PI           6.28318531f
+
+static const char* effect_names[EFFECTS_ENGINE_NUM_EFFECTS] =
+{
+    "Software Spectrum Cycle",
+    "Software Rainbow Wave",
+    "Software Breathing",
+    "Software Gradient",
+    "Software Wave",
+    "Software Room Wave",
+};
+
+static RGBColor ScaleColor(RGBColor color, float scale)
+{
+    return(ToRGBColor((unsigned char)(RGBGetRValue(color) * scale),
+                      (unsigned char)(RGBGetGValue(color) * scale),
+                      (unsigned char)(RGBGetBValue(color) * scale)));
+}
+
+static RGBColor BlendColors(RGBColor color_1, RGBColor color_2, float amount)
+{
+    return(ToRGBColor((unsigned char)(RGBGetRValue(color_1) + (((int)RGBGetRValue(color_2) - (int)RGBGetRValue(color_1)) * amount)),
+                      (unsigned char)(RGBGetGValue(color_1) + (((int)RGBGetGValue(color_2) - (int)RGBGetGValue(color_1)) * amount)),
+                      (unsigned char)(RGBGetBValue(color_1) + (((int)RGBGetBValue(color_2) - (int)RGBGetBValue(color_1)) * amount))));
+}
+
+static RGBColor HueColor(float hue)
+{
+    hsv_t hsv;
+
+    hsv.hue         = ((unsigned int)(hue * 360.0f)) % 360;
+    hsv.saturation  = 255;
+    hsv.value       = 255;
+
+    return(hsv2rgb(&hsv));
+}
+
+EffectsEngine::EffectsEngine(unsigned int fps, const json& scene_settings)
+{
+    SceneSettings       = scene_settings;
+    SceneDirty          = true;
+
+    if(fps == 0)
+    {
+        fps = EFFECTS_ENGINE_DEFAULT_FPS;
+    }
+
+    if(fps > EFFECTS_ENGINE_MAX_FPS)
+    {
+        fps = EFFECTS_ENGINE_MAX_FPS;
+    }
+
+    FrameInterval       = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::microseconds(1000000 / fps));
+    StartTime           = std::chrono::steady_clock::now();
+
+    FrameThreadRunning  = true;
+    FrameThread         = new std::thread(&EffectsEngine::FrameThreadFunction, this);
+}
+
+EffectsEngine::~EffectsEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock(FrameThreadMutex);
+        FrameThreadRunning = false;
+    }
+
+    FrameThreadCV.notify_all();
+    FrameThread->join();
+    delete FrameThread;
+}
+
+void EffectsEngine::RegisterController(RGBController* controller)
+{
+    /*-----------------------------------------------------*\
+    | Effects are rendered through the device's per-LED     |
+    | Direct mode, skip devices without one                 |
+    \*-----------------------------------------------------*/
+    int direct_mode = -1;
+
+    for(std::size_t mode_idx = 0; mode_idx < controller->modes.size(); mode_idx++)
+    {
+        if(controller->modes[mode_idx].flags & MODE_FLAG_SOFTWARE_EFFECT)
+        {
+            return;
+        }
+
+        if((controller->modes[mode_idx].name == "Direct")
+        && (controller->modes[mode_idx].color_mode == MODE_COLORS_PER_LED))
+        {
+            direct_mode = (int)mode_idx;
+        }
+    }
+
+    if(direct_mode < 0)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(DevicesMutex);
+
+    EffectsEngineDevice device;
+
+    device.controller   = controller;
+    device.first_mode   = controller->modes.size();
+
+    /*-----------------------------------------------------*\
+    | Append one software mode per effect.  The mode value  |
+    | holds the hardware mode used while it is active       |
+    \*-----------------------------------------------------*/
+    for(unsigned int effect_idx = 0; effect_idx < EFFECTS_ENGINE_NUM_EFFECTS; effect_idx++)
+    {
+        mode Effect;
+        Effect.name         = effect_names[effect_idx];
+        Effect.value        = direct_mode;
+        Effect.flags        = MODE_FLAG_SOFTWARE_EFFECT | MODE_FLAG_HAS_SPEED;
+        Effect.speed_min    = EFFECTS_ENGINE_SPEED_MIN;
+        Effect.speed_max    = EFFECTS_ENGINE_SPEED_MAX;
+        Effect.speed        = EFFECTS_ENGINE_SPEED_DEFAULT;
+        Effect.color_mode   = MODE_COLORS_NONE;
+
+        switch(effect_idx)
+        {
+            case EFFECTS_ENGINE_EFFECT_RAINBOW_WAVE:
+            case EFFECTS_ENGINE_EFFECT_ROOM_WAVE:
+                Effect.flags       |= MODE_FLAG_HAS_DIRECTION_LR;
+                Effect.direction    = MODE_DIRECTION_RIGHT;
+                break;
+
+            case EFFECTS_ENGINE_EFFECT_BREATHING:
+                Effect.flags       |= MODE_FLAG_HAS_MODE_SPECIFIC_COLOR;
+                Effect.color_mode   = MODE_COLORS_MODE_SPECIFIC;
+                Effect.colors_min   = 1;
+                Effect.colors_max   = 1;
+                Effect.colors.push_back(ToRGBColor(255, 0, 0));
+                break;
+
+            case EFFECTS_ENGINE_EFFECT_GRADIENT:
+                Effect.flags       |= MODE_FLAG_HAS_DIRECTION_LR | MODE_FLAG_HAS_MODE_SPECIFIC_COLOR;
+                Effect.direction    = MODE_DIRECTION_RIGHT;
+                Effect.color_mode   = MODE_COLORS_MODE_SPECIFIC;
+                Effect.colors_min   = 2;
+                Effect.colors_max   = 2;
+                Effect.colors.push_back(ToRGBColor(255, 0, 0));
+                Effect.colors.push_back(ToRGBColor(0, 0, 255));
+                break;
+
+            case EFFECTS_ENGINE_EFFECT_WAVE:
+                Effect.flags       |= MODE_FLAG_HAS_DIRECTION_LR | MODE_FLAG_HAS_MODE_SPECIFIC_COLOR;
+                Effect.direction    = MODE_DIRECTION_RIGHT;
+                Effect.color_mode   = MODE_COLORS_MODE_SPECIFIC;
+                Effect.colors_min   = 1;
+                Effect.colors_max   = 1;
+                Effect.colors.push_back(ToRGBColor(0, 0, 255));
+                break;
+        }
+
+        controller->modes.push_back(Effect);
+    }
+
+    Devices.push_back(device);
+    SceneDirty = true;
+
+    LOG_DEBUG("[EffectsEngine] Added software effects to %s", controller->name.c_str());
+}
+
+void EffectsEngine::UnregisterController(RGBController* controller)
+{
+    std::lock_guard<std::mutex> lock(DevicesMutex);
+
+    for(std::size_t device_idx = 0; device_idx < Devices.size(); device_idx++)
+    {
+        if(Devices[device_idx].controller == controller)
+        {
+            Devices.erase(Devices.begin() + device_idx);
+            SceneDirty = true;
+            break;
+        }
+    }
+}
+
+void EffectsEngine::ClearControllers()
+{
+    std::lock_guard<std::mutex> lock(DevicesMutex);
+
+    Devices.clear();
+    SceneDirty = true;
+}
+
+void EffectsEngine::FrameThreadFunction()
+{
+    std::chrono::steady_clock::time_point next_frame = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> frame_lock(FrameThreadMutex);
+
+    while(FrameThreadRunning.load())
+    {
+        std::chrono::duration<float> time = std::chrono::steady_clock::now() - StartTime;
+
+        frame_lock.unlock();
+        RenderFrame(time.count());
+        frame_lock.lock();
+
+        /*-------------------------------------------------*\
+        | Keep a fixed frame rate, skipping frames rather   |
+        | than bursting if rendering falls behind           |
+        \*-------------------------------------------------*/
+        next_frame += FrameInterval;
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if(next_frame < now)
+        {
+            next_frame = now;
+        }
+
+        FrameThreadCV.wait_until(frame_lock, next_frame, [this]{ return(!FrameThreadRunning.load()); });
+    }
+}
+
+void EffectsEngine::RenderFrame(float time)
+{
+    std::lock_guard<std::mutex> lock(DevicesMutex);
+
+    Palettes.clear();
+
+    if(SceneDirty || Scene.IsStale())
+    {
+        std::vector<RGBController*> controllers;
+
+        for(std::size_t device_idx = 0; device_idx < Devices.size(); device_idx++)
+        {
+            controllers.push_back(Devices[device_idx].controller);
+        }
+
+        Scene.Build(controllers, SceneSettings);
+        SceneDirty = false;
+    }
+
+    for(std::size_t device_idx = 0; device_idx < Devices.size(); device_idx++)
+    {
+        RenderDevice(Devices[device_idx], time);
+    }
+}
+
+void EffectsEngine::RenderDevice(EffectsEngineDevice& device, float time)
+{
+    RGBController*  controller  = device.controller;
+    int             active_mode = controller->GetMode();
+
+    if((active_mode < (int)device.first_mode)
+    || (active_mode >= (int)(device.first_mode + EFFECTS_ENGINE_NUM_EFFECTS))
+    || (active_mode >= (int)controller->modes.size()))
+    {
+        return;
+    }
+
+    unsigned int    effect  = active_mode - device.first_mode;
+
+    /*-----------------------------------------------------*\
+    | Scene effects sample the rainbow palette by position  |
+    | across the whole scene rather than within each zone   |
+    \*-----------------------------------------------------*/
+    if(effect == EFFECTS_ENGINE_EFFECT_ROOM_WAVE)
+    {
+        RenderScene(controller, GetPalette(EFFECTS_ENGINE_EFFECT_RAINBOW_WAVE, controller->modes[active_mode], time));
+        controller->UpdateLEDs();
+        return;
+    }
+
+    const RGBColor* palette = GetPalette(effect, controller->modes[active_mode], time);
+
+    /*-----------------------------------------------------*\
+    | Map each LED to a palette position.  Matrix zones use |
+    | the column in the matrix map, other zones use the LED |
+    | index within the zone                                 |
+    \*-----------------------------------------------------*/
+    for(std::size_t zone_idx = 0; zone_idx < controller->zones.size(); zone_idx++)
+    {
+        zone&           led_zone    = controller->zones[zone_idx];
+        RGBColor*       zone_colors = led_zone.colors;
+
+        if((zone_colors == NULL) || (led_zone.leds_count == 0))
+        {
+            continue;
+        }
+
+        if((led_zone.type == ZONE_TYPE_MATRIX) && (led_zone.matrix_map != NULL) && (led_zone.matrix_map->width > 0))
+        {
+            unsigned int width  = led_zone.matrix_map->width;
+            unsigned int height = led_zone.matrix_map->height;
+
+            for(unsigned int y = 0; y < height; y++)
+            {
+                for(unsigned int x = 0; x < width; x++)
+                {
+                    unsigned int led_idx = led_zone.matrix_map->map[(y * width) + x];
+
+                    if(led_idx < led_zone.leds_count)
+                    {
+                        zone_colors[led_idx] = palette[(x * (EFFECTS_ENGINE_PALETTE_SIZE - 1)) / (width > 1 ? (width - 1) : 1)];
+                    }
+                }
+            }
+        }
+        else
+        {
+            unsigned int span = (led_zone.leds_count > 1) ? (led_zone.leds_count - 1) : 1;
+
+            for(unsigned int led_idx = 0; led_idx < led_zone.leds_count; led_idx++)
+            {
+                zone_colors[led_idx] = palette[(led_idx * (EFFECTS_ENGINE_PALETTE_SIZE - 1)) / span];
+            }
+        }
+    }
+
+    controller->UpdateLEDs();
+}
+
+void EffectsEngine::RenderScene(RGBController* controller, const RGBColor* palette)
+{
+    const SceneGraphRange* range = Scene.GetRange(controller);
+
+    if((range == nullptr) || (range->count != controller->colors.size()))
+    {
+        return;
+    }
+
+    float min[3];
+    float max[3];
+
+    Scene.GetBounds(min, max);
+
+    float           scale   = (max[0] > min[0]) ? ((EFFECTS_ENGINE_PALETTE_SIZE - 1) / (max[0] - min[0])) : 0.0f;
+    const float*    x       = Scene.GetX() + range->first;
+    RGBColor*       colors  = controller->colors.data();
+
+    for(unsigned int led_idx = 0; led_idx < range->count; led_idx++)
+    {
+        colors[led_idx] = palette[(unsigned int)((x[led_idx] - min[0]) * scale)];
+    }
+}
+
+const RGBColor* EffectsEngine::GetPalette(unsigned int effect, const mode& effect_mode, float time)
+{
+    RGBColor color_1 = (effect_mode.colors.size() > 0) ? effect_mode.colors[0] : 0;
+    RGBColor color_2 = (effect_mode.colors.size() > 1) ? effect_mode.colors[1] : 0;
+
+    /*-----------------------------------------------------*\
+    | Reuse a palette already computed this frame           |
+    \*-----------------------------------------------------*/
+    for(std::size_t palette_idx = 0; palette_idx < Palettes.size(); palette_idx++)
+    {
+        EffectsEnginePalette& palette = Palettes[palette_idx];
+
+        if((palette.effect    == effect               )
+        && (palette.speed     == effect_mode.speed    )
+        && (palette.direction == effect_mode.direction)
+        && (palette.color_1   == color_1              )
+        && (palette.color_2   == color_2              ))
+        {
+            return(palette.colors);
+        }
+    }
+
+    Palettes.emplace_back();
+
+    EffectsEnginePalette& palette = Palettes.back();
+
+    palette.effect      = effect;
+    palette.speed       = effect_mode.speed;
+    palette.direction   = effect_mode.direction;
+    palette.color_1     = color_1;
+    palette.color_2     = color_2;
+
+    /*-----------------------------------------------------*\
+    | phase is the effect position in cycles, positions     |
+    | move against the direction so the effect travels in   |
+    | the selected direction                                |
+    \*-----------------------------------------------------*/
+    float phase = time * effect_mode.speed * EFFECTS_ENGINE_SPEED_SCALE;
+
+    if(effect_mode.direction == MODE_DIRECTION_LEFT)
+    {
+        phase = -phase;
+    }
+
+    for(unsigned int pos_idx = 0; pos_idx < EFFECTS_ENGINE_PALETTE_SIZE; pos_idx++)
+    {
+        float pos       = (float)pos_idx / EFFECTS_ENGINE_PALETTE_SIZE;
+        float offset    = pos - phase;
+
+        offset         -= floorf(offset);
+
+        switch(effect)
+        {
+            case EFFECTS_ENGINE_EFFECT_SPECTRUM_CYCLE:
+                palette.colors[pos_idx] = HueColor(fabsf(phase) - floorf(fabsf(phase)));
+                break;
+
+            case EFFECTS_ENGINE_EFFECT_RAINBOW_WAVE:
+                palette.colors[pos_idx] = HueColor(offset);
+                break;
+
+            case EFFECTS_ENGINE_EFFECT_BREATHING:
+                palette.colors[pos_idx] = ScaleColor(color_1, 0.5f - (0.5f * cosf(EFFECTS_ENGINE_TWO_PI * phase)));
+                break;
+
+            case EFFECTS_ENGINE_EFFECT_GRADIENT:
+                palette.colors[pos_idx] = BlendColors(color_1, color_2, 1.0f - fabsf((2.0f * offset) - 1.0f));
+                break;
+
+            case EFFECTS_ENGINE_EFFECT_WAVE:
+                palette.colors[pos_idx] = ScaleColor(color_1, 0.5f + (0.5f * sinf(EFFECTS_ENGINE_TWO_PI * offset)));
+                break;
+        }
+    }
+
+    return(palette.colors);
+}
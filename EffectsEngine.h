@@ -0,0 +1,98 @@
+/*-----------------------------------------*\
+|  EffectsEngine.h                          |
+|                                           |
+|  Server-side software effects for devices |
+|  with a Direct mode.  Effects are offered |
+|  as extra modes on each controller and    |
+|  rendered on a single shared frame clock  |
+\*-----------------------------------------*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "RGBController.h"
+#include "SceneGraph.h"
+
+/*---------------------------------------------------------*\
+| Number of positions sampled across a zone per effect      |
+\*---------------------------------------------------------*/
+#define EFFECTS_ENGINE_PALETTE_SIZE     256
+#define EFFECTS_ENGINE_DEFAULT_FPS      30
+#define EFFECTS_ENGINE_MAX_FPS          120
+
+enum
+{
+    EFFECTS_ENGINE_EFFECT_SPECTRUM_CYCLE,   /* Whole device cycles through hues         */
+    EFFECTS_ENGINE_EFFECT_RAINBOW_WAVE,     /* Hues travel across each zone             */
+    EFFECTS_ENGINE_EFFECT_BREATHING,        /* Whole device fades one color in and out  */
+    EFFECTS_ENGINE_EFFECT_GRADIENT,         /* Two color gradient travels across zones  */
+    EFFECTS_ENGINE_EFFECT_WAVE,             /* Brightness wave of one color             */
+    EFFECTS_ENGINE_EFFECT_ROOM_WAVE,        /* Hues travel across the whole scene       */
+    EFFECTS_ENGINE_NUM_EFFECTS
+};
+
+struct EffectsEngineDevice
+{
+    RGBController*  controller;
+    unsigned int    first_mode;             /* Index of the first software mode         */
+};
+
+/*---------------------------------------------------------*\
+| A palette is one frame of an effect sampled across zone   |
+| positions.  Palettes are computed once per frame for each |
+| distinct set of effect parameters and shared by all       |
+| devices using them                                        |
+\*---------------------------------------------------------*/
+struct EffectsEnginePalette
+{
+    unsigned int    effect;
+    unsigned int    speed;
+    unsigned int    direction;
+    RGBColor        color_1;
+    RGBColor        color_2;
+    RGBColor        colors[EFFECTS_ENGINE_PALETTE_SIZE];
+};
+
+class EffectsEngine
+{
+public:
+    EffectsEngine(unsigned int fps, const json& scene_settings);
+    ~EffectsEngine();
+
+    void RegisterController(RGBController* controller);
+    void UnregisterController(RGBController* controller);
+    void ClearControllers();
+
+private:
+    std::mutex                          DevicesMutex;
+    std::vector<EffectsEngineDevice>    Devices;
+    std::vector<EffectsEnginePalette>   Palettes;
+
+    /*---------------------------------------------------------*\
+    | Scene of all registered devices, rebuilt on the frame     |
+    | thread when devices are added, removed or resized         |
+    \*---------------------------------------------------------*/
+    SceneGraph                          Scene;
+    json                                SceneSettings;
+    bool                                SceneDirty;
+
+    std::chrono::steady_clock::duration FrameInterval;
+    std::chrono::steady_clock::time_point StartTime;
+
+    std::thread*                        FrameThread;
+    std::atomic<bool>                   FrameThreadRunning;
+    std::mutex                          FrameThreadMutex;
+    std::condition_variable             FrameThreadCV;
+
+    void                    FrameThreadFunction();
+    void                    RenderFrame(float time);
+    void                    RenderDevice(EffectsEngineDevice& device, float time);
+    void                    RenderScene(RGBController* controller, const RGBColor* palette);
+    const RGBColor*         GetPalette(unsigned int effect, const mode& effect_mode, float time);
+};
@@ -290,11 +290,18 @@ KeyboardLayoutManager::KeyboardLayoutManager(KEYBOARD_LAYOUT layout, KEYBOARD_SI
 {
 }
 
+KeyboardLayoutManager::KeyboardLayoutManager()
+{
+    layout          = KEYBOARD_LAYOUT_DEFAULT;
+    physical_size   = KEYBOARD_SIZE_EMPTY;
+}
+
 KeyboardLayoutManager::KeyboardLayoutManager(KEYBOARD_LAYOUT layout, KEYBOARD_SIZE size, layout_values values)
 {
     /*---------------------------------------------------------------------*\
-    | Store given size bitfield                                             |
+    | Store given layout and size bitfield                                  |
     \*---------------------------------------------------------------------*/
+    this->layout  = layout;
     physical_size = size;
 
     /*---------------------------------------------------------------------*\
@@ -307,39 +314,36 @@ KeyboardLayoutManager::KeyboardLayoutManager(KEYBOARD_LAYOUT layout, KEYBOARD_SI
     }
 
     /*---------------------------------------------------------------------*\
-    | Add sections to the keymap based on KEYBOARD_SIZE bitfield            |
+    | Copy the resolved base keymap for this layout and size                |
     \*---------------------------------------------------------------------*/
-    if(physical_size & KEYBOARD_ZONE_MAIN)
-    {
-        InsertKeys(keyboard_zone_main);
-    }
+    const keyboard_base_keymap& base = GetBaseKeymap(layout, size);
 
-    if(physical_size & KEYBOARD_ZONE_FN_ROW)
-    {
-        InsertKeys(keyboard_zone_fn_row);
-    }
-
-    if(physical_size & KEYBOARD_ZONE_EXTRA)
-    {
-        InsertKeys(keyboard_zone_extras);
-    }
-
-    if(physical_size & KEYBOARD_ZONE_NUMPAD)
-    {
-        InsertKeys(keyboard_zone_numpad);
-    }
+    keymap = base.keymap;
+    index_dirty = true;
 
     /*---------------------------------------------------------------------*\
-    | Add any values passed into the constructor before switching layouts   |
-    |   and declare a value set for any changes afterwards                  |
+    | Apply any values passed into the constructor to the keys that came    |
+    |   from the base zones, by their index before the layout was applied  |
     \*---------------------------------------------------------------------*/
-    for(size_t key_idx = 0; key_idx < values.ansi.size() && key_idx < keymap.size(); key_idx++)
+    for(size_t key_idx = 0; key_idx < keymap.size(); key_idx++)
     {
-        keymap[key_idx].value = values.ansi[key_idx];
+        if(keymap[key_idx].value & KLM_BASE_KEY_FLAG)
+        {
+            unsigned int base_idx = keymap[key_idx].value & ~KLM_BASE_KEY_FLAG;
+
+            if(base_idx < values.ansi.size())
+            {
+                keymap[key_idx].value = values.ansi[base_idx];
+            }
+            else
+            {
+                keymap[key_idx].value = base.base_values[base_idx];
+            }
+        }
     }
 
     /*---------------------------------------------------------------------*\
-    | Modify the base default QWERTY layout to the desired regional layout  |
+    | Name the regional layout                                              |
     \*---------------------------------------------------------------------*/
     std::string tmp_name;
 
@@ -351,29 +355,24 @@ KeyboardLayoutManager::KeyboardLayoutManager(KEYBOARD_LAYOUT layout, KEYBOARD_SI
             break;
 
         case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_ANSI_QWERTY:
-            ChangeKeys(ansi_qwerty);
             tmp_name = KEYBOARD_NAME_ANSI;
             tmp_name.append(KEYBOARD_NAME_QWERTY);
             break;
 
         case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_ISO_AZERTY:
-            ChangeKeys(iso_azerty);
             tmp_name = KEYBOARD_NAME_AZERTY;
             break;
 
         case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_ISO_QWERTY:
-            ChangeKeys(iso_qwerty);
             tmp_name = KEYBOARD_NAME_ISO;
             tmp_name.append(KEYBOARD_NAME_QWERTY);
             break;
 
         case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_ISO_QWERTZ:
-            ChangeKeys(iso_qwertz);
             tmp_name = KEYBOARD_NAME_QWERTZ;
             break;
 
         case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_JIS:
-            ChangeKeys(jis);
             tmp_name = KEYBOARD_NAME_JIS;
             break;
     }
@@ -401,6 +400,7 @@ KeyboardLayoutManager::KeyboardLayoutManager(KEYBOARD_LAYOUT layout, KEYBOARD_SI
             | Remove the empty Function row and swap in the Escape key      |
             \*-------------------------------------------------------------*/
             name = KEYBOARD_NAME_SIXTY;
+            UpdateDimensions();
             RemoveRow(0);
             SwapKey(keyboard_zone_fn_row[0]);
             break;
@@ -425,6 +425,105 @@ KeyboardLayoutManager::KeyboardLayoutManager(KEYBOARD_LAYOUT layout, KEYBOARD_SI
     LOG_INFO(LOG_MSG_CREATED_NEW, KLM_CLASS_NAME, name.c_str(), tmp_name.c_str(), rows, cols, keymap.size());
 }
 
+const keyboard_base_keymap& KeyboardLayoutManager::GetBaseKeymap(KEYBOARD_LAYOUT layout, KEYBOARD_SIZE size)
+{
+    /*---------------------------------------------------------------------*\
+    | Base keymaps are resolved on first use and kept for the lifetime of   |
+    |   the process, so each further layout is a table lookup and a copy    |
+    \*---------------------------------------------------------------------*/
+    static std::mutex                                                               base_keymaps_mutex;
+    static std::map<std::pair<KEYBOARD_LAYOUT, KEYBOARD_SIZE>, keyboard_base_keymap> base_keymaps;
+
+    std::lock_guard<std::mutex> lock(base_keymaps_mutex);
+
+    std::pair<KEYBOARD_LAYOUT, KEYBOARD_SIZE> base_key(layout, size);
+
+    std::map<std::pair<KEYBOARD_LAYOUT, KEYBOARD_SIZE>, keyboard_base_keymap>::iterator it = base_keymaps.find(base_key);
+
+    if(it == base_keymaps.end())
+    {
+        KeyboardLayoutManager builder;
+
+        keyboard_base_keymap& base = base_keymaps[base_key];
+
+        builder.BuildBaseKeymap(layout, size, base.base_values);
+
+        base.keymap = builder.keymap;
+
+        return(base);
+    }
+
+    return(it->second);
+}
+
+void KeyboardLayoutManager::BuildBaseKeymap(KEYBOARD_LAYOUT layout, KEYBOARD_SIZE size, std::vector<unsigned int>& base_values)
+{
+    physical_size = size;
+
+    /*---------------------------------------------------------------------*\
+    | Add sections to the keymap based on KEYBOARD_SIZE bitfield            |
+    \*---------------------------------------------------------------------*/
+    if(physical_size & KEYBOARD_ZONE_MAIN)
+    {
+        InsertKeys(keyboard_zone_main);
+    }
+
+    if(physical_size & KEYBOARD_ZONE_FN_ROW)
+    {
+        InsertKeys(keyboard_zone_fn_row);
+    }
+
+    if(physical_size & KEYBOARD_ZONE_EXTRA)
+    {
+        InsertKeys(keyboard_zone_extras);
+    }
+
+    if(physical_size & KEYBOARD_ZONE_NUMPAD)
+    {
+        InsertKeys(keyboard_zone_numpad);
+    }
+
+    /*---------------------------------------------------------------------*\
+    | Tag each base key with its index so its value can be filled in from   |
+    |   the constructor values once the layout has been resolved            |
+    \*---------------------------------------------------------------------*/
+    for(size_t key_idx = 0; key_idx < keymap.size(); key_idx++)
+    {
+        base_values.push_back(keymap[key_idx].value);
+        keymap[key_idx].value = KLM_BASE_KEY_FLAG | (unsigned int)key_idx;
+    }
+
+    /*---------------------------------------------------------------------*\
+    | Modify the base default QWERTY layout to the desired regional layout  |
+    \*---------------------------------------------------------------------*/
+    switch(layout)
+    {
+        case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_DEFAULT:
+        default:
+            break;
+
+        case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_ANSI_QWERTY:
+            ChangeKeys(ansi_qwerty);
+            break;
+
+        case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_ISO_AZERTY:
+            ChangeKeys(iso_azerty);
+            break;
+
+        case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_ISO_QWERTY:
+            ChangeKeys(iso_qwerty);
+            break;
+
+        case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_ISO_QWERTZ:
+            ChangeKeys(iso_qwertz);
+            break;
+
+        case KEYBOARD_LAYOUT::KEYBOARD_LAYOUT_JIS:
+            ChangeKeys(jis);
+            break;
+    }
+}
+
 KeyboardLayoutManager::~KeyboardLayoutManager()
 {
 
@@ -485,6 +584,8 @@ void KeyboardLayoutManager::OpCodeSwitch(key_set change_keys)
 
 void KeyboardLayoutManager::InsertKey(keyboard_led ins_key)
 {
+    index_dirty = true;
+
     /*---------------------------------------------------------------------*\
     | Get the insertion point                                               |
     \*---------------------------------------------------------------------*/
@@ -579,6 +680,8 @@ void KeyboardLayoutManager::InsertKeys(std::vector<keyboard_led> ins_keys)
 
 void KeyboardLayoutManager::SwapKey(keyboard_led swp_key)
 {
+    index_dirty = true;
+
     /*---------------------------------------------------------------------*\
     | Get the swap point                                                    |
     \*---------------------------------------------------------------------*/
@@ -674,6 +777,8 @@ void KeyboardLayoutManager::SwapKeys(std::vector<keyboard_led> swp_keys)
 
 void KeyboardLayoutManager::RemoveKey(keyboard_led rmv_key)
 {
+    index_dirty = true;
+
     /*---------------------------------------------------------------------*\
     | Get the remove point                                                  |
     \*---------------------------------------------------------------------*/
@@ -731,6 +836,8 @@ void KeyboardLayoutManager::RemoveKey(keyboard_led rmv_key)
 
 void KeyboardLayoutManager::RemoveRow(uint8_t rmv_row)
 {
+    index_dirty = true;
+
     /*---------------------------------------------------------------------*\
     | Check row is valid to remove                                          |
     \*---------------------------------------------------------------------*/
@@ -801,12 +908,11 @@ std::string KeyboardLayoutManager::GetKeyNameAt(unsigned int key_idx)
 
 std::string KeyboardLayoutManager::GetKeyNameAt(unsigned int row, unsigned int col)
 {
-    for(std::vector<keyboard_led>::iterator key = keymap.begin(); key != keymap.end(); ++key)
+    unsigned int key_idx = GetKeyIndexAt(row, col);
+
+    if(key_idx < keymap.size())
     {
-        if(key->row == row && key->col == col)
-        {
-            return key->name;
-        }
+        return keymap[key_idx].name;
     }
 
     return KEY_EN_UNUSED;
@@ -824,15 +930,78 @@ unsigned int KeyboardLayoutManager::GetKeyValueAt(unsigned int key_idx)
 
 unsigned int KeyboardLayoutManager::GetKeyValueAt(unsigned int row, unsigned int col)
 {
-    for(std::vector<keyboard_led>::iterator key = keymap.begin(); key != keymap.end(); ++key)
+    unsigned int key_idx = GetKeyIndexAt(row, col);
+
+    if(key_idx < keymap.size())
+    {
+        return keymap[key_idx].value;
+    }
+
+    return -1;
+}
+
+unsigned int KeyboardLayoutManager::GetKeyIndexAt(unsigned int row, unsigned int col)
+{
+    UpdateIndex();
+
+    if(row >= rows || col >= index_cols)
     {
-        if(key->row == row && key->col == col)
+        return -1;
+    }
+
+    return position_index[(row * index_cols) + col];
+}
+
+unsigned int KeyboardLayoutManager::GetKeyIndexByName(const std::string& key_name)
+{
+    UpdateIndex();
+
+    std::unordered_map<std::string, unsigned int>::const_iterator it = name_index.find(key_name);
+
+    if(it == name_index.end())
+    {
+        return -1;
+    }
+
+    return it->second;
+}
+
+void KeyboardLayoutManager::UpdateIndex()
+{
+    if(!index_dirty)
+    {
+        return;
+    }
+
+    /*---------------------------------------------------------------------*\
+    | Make sure the dimensions cover every key before sizing the table      |
+    \*---------------------------------------------------------------------*/
+    UpdateDimensions();
+
+    unsigned int no_key = -1;
+
+    index_cols = cols;
+    position_index.assign(rows * cols, no_key);
+    name_index.clear();
+    name_index.reserve(keymap.size());
+
+    /*---------------------------------------------------------------------*\
+    | The first key found at a position or with a name wins, matching the  |
+    |   order of the previous linear searches                               |
+    \*---------------------------------------------------------------------*/
+    for(unsigned int key_idx = 0; key_idx < keymap.size(); key_idx++)
+    {
+        unsigned int& position = position_index[(keymap[key_idx].row * index_cols) + keymap[key_idx].col];
+
+        if(position == no_key)
         {
-            return key->value;
+            position = key_idx;
         }
+
+        name_index.emplace(keymap[key_idx].name, key_idx);
     }
 
-    return -1;
+    index_dirty = false;
 }
 
 unsigned int KeyboardLayoutManager::GetRowCount()
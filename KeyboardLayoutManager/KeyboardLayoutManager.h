@@ -9,7 +9,9 @@
 #pragma once
 
 #include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "RGBControllerKeyNames.h"
 
@@ -96,6 +98,21 @@ typedef struct
     key_set                                 edit_keys;
 }   keyboard_keymap_overlay_values;
 
+/*---------------------------------------------------------------------*\
+| Resolved base keymap for a layout and size combination.  Built once   |
+|   per process and copied by each new KeyboardLayoutManager.  Keys     |
+|   taken from the base zones carry KLM_BASE_KEY_FLAG | base index in   |
+|   their value so constructor supplied values can be applied after     |
+|   the regional layout has been resolved                               |
+\*---------------------------------------------------------------------*/
+#define KLM_BASE_KEY_FLAG               0x80000000
+
+typedef struct
+{
+    std::vector<keyboard_led>               keymap;
+    std::vector<unsigned int>               base_values;
+}   keyboard_base_keymap;
+
 class KeyboardLayoutManager
 {
 public:
@@ -119,6 +136,9 @@ public:
     unsigned int                GetKeyValueAt(unsigned int key_idx);
     unsigned int                GetKeyValueAt(unsigned int row, unsigned int col);
 
+    unsigned int                GetKeyIndexAt(unsigned int row, unsigned int col);
+    unsigned int                GetKeyIndexByName(const std::string& key_name);
+
     unsigned int                GetRowCount();
     unsigned int                GetColumnCount();
 
@@ -128,6 +148,11 @@ public:
                                           uint8_t height, uint8_t width);
 
 private:
+    KeyboardLayoutManager();
+
+    static const keyboard_base_keymap&  GetBaseKeymap(KEYBOARD_LAYOUT layout, KEYBOARD_SIZE size);
+
+    void                        BuildBaseKeymap(KEYBOARD_LAYOUT layout, KEYBOARD_SIZE size, std::vector<unsigned int>& base_values);
     void                        OpCodeSwitch(key_set change_keys);
     void                        InsertKey(keyboard_led key);
     void                        InsertKeys(std::vector<keyboard_led> keys);
@@ -135,6 +160,7 @@ private:
     void                        SwapKeys(std::vector<keyboard_led> keys);
     void                        RemoveKey(keyboard_led keys);
     void                        RemoveRow(uint8_t row);
+    void                        UpdateIndex();
 
     KEYBOARD_LAYOUT             layout;
     KEYBOARD_SIZE               physical_size;
@@ -142,5 +168,15 @@ private:
     uint8_t                     rows            = 0;
     uint8_t                     cols            = 0;
     std::vector<keyboard_led>   keymap;
+
+    /*---------------------------------------------------------------------*\
+    | Lookup indexes into keymap, a dense row x column table and a name     |
+    |   hash.  Any keymap edit marks them dirty and they are rebuilt on     |
+    |   the next lookup                                                     |
+    \*---------------------------------------------------------------------*/
+    bool                                            index_dirty     = true;
+    uint8_t                                         index_cols      = 0;
+    std::vector<unsigned int>                       position_index;
+    std::unordered_map<std::string, unsigned int>   name_index;
 };
 
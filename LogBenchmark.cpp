@@ -0,0 +1,149 @@
+/*-----------------------------------------*\
+|  LogBenchmark.cpp                         |
+|                                           |
+|  Multi-threaded throughput benchmark of   |
+|  the LogManager append and writer path    |
+\*-----------------------------------------*/
+
+#include "LogBenchmark.h"
+#include "LogManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+static unsigned int GetBenchmarkSetting(const json& benchmark_settings, const char* key, unsigned int default_value)
+{
+    if(benchmark_settings.contains(key) && benchmark_settings[key].is_number_unsigned())
+    {
+        return(benchmark_settings[key]);
+    }
+
+    return(default_value);
+}
+
+LogBenchmark::LogBenchmark(const json& benchmark_settings)
+{
+    thread_count    = GetBenchmarkSetting(benchmark_settings, "threads",  LOG_BENCHMARK_DEFAULT_THREADS);
+    message_count   = GetBenchmarkSetting(benchmark_settings, "messages", LOG_BENCHMARK_DEFAULT_MESSAGES);
+
+    if(thread_count == 0)
+    {
+        thread_count = 1;
+    }
+
+    if(message_count == 0)
+    {
+        message_count = 1;
+    }
+}
+
+json LogBenchmark::Run()
+{
+    json            results;
+    unsigned int    saved_loglevel  = LogManager::get()->getLoglevel();
+
+    results["threads"]  = thread_count;
+    results["messages"] = message_count;
+
+    /*-----------------------------------------------------*\
+    | Filtered: trace messages below the file log level     |
+    | should return before any formatting                   |
+    \*-----------------------------------------------------*/
+    LogManager::get()->setLoglevel(LL_INFO);
+
+    results["filtered"] = MeasureAppend(LL_INFO);
+
+    /*-----------------------------------------------------*\
+    | Written: every message is formatted, queued and       |
+    | written to the log file by the writer thread          |
+    \*-----------------------------------------------------*/
+    LogManager::get()->setLoglevel(LL_TRACE);
+
+    results["written"]  = MeasureAppend(LL_TRACE);
+
+    LogManager::get()->setLoglevel(saved_loglevel);
+
+    return(results);
+}
+
+json LogBenchmark::MeasureAppend(unsigned int loglevel)
+{
+    std::vector<std::vector<unsigned int>>  append_ns(thread_count);
+    std::vector<std::thread*>               threads;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for(unsigned int thread_idx = 0; thread_idx < thread_count; thread_idx++)
+    {
+        threads.push_back(new std::thread(AppendThreadFunction, thread_idx, message_count, &append_ns[thread_idx]));
+    }
+
+    for(std::thread* thread : threads)
+    {
+        thread->join();
+        delete thread;
+    }
+
+    std::chrono::steady_clock::time_point appended = std::chrono::steady_clock::now();
+
+    /*-----------------------------------------------------*\
+    | Include draining the rings to the log file in the     |
+    | total so that the writer thread's cost is counted     |
+    \*-----------------------------------------------------*/
+    LogManager::get()->flush();
+
+    std::chrono::steady_clock::time_point flushed = std::chrono::steady_clock::now();
+
+    /*-----------------------------------------------------*\
+    | Merge the per-call timings                            |
+    \*-----------------------------------------------------*/
+    std::vector<unsigned int> samples_ns;
+
+    for(std::vector<unsigned int>& thread_ns : append_ns)
+    {
+        samples_ns.insert(samples_ns.end(), thread_ns.begin(), thread_ns.end());
+    }
+
+    std::sort(samples_ns.begin(), samples_ns.end());
+
+    double total_ns = 0.0;
+
+    for(unsigned int sample_ns : samples_ns)
+    {
+        total_ns += sample_ns;
+    }
+
+    double append_seconds   = std::chrono::duration<double>(appended - start).count();
+    double total_seconds    = std::chrono::duration<double>(flushed - start).count();
+    double total_messages   = (double)thread_count * message_count;
+
+    json result;
+
+    result["loglevel"]              = loglevel;
+    result["append_seconds"]        = append_seconds;
+    result["total_seconds"]         = total_seconds;
+    result["messages_per_second"]   = total_messages / total_seconds;
+    result["mean_append_ns"]        = total_ns / samples_ns.size();
+    result["p50_append_ns"]         = samples_ns[samples_ns.size() / 2];
+    result["p99_append_ns"]         = samples_ns[std::min(samples_ns.size() - 1, (samples_ns.size() * 99) / 100)];
+    result["max_append_ns"]         = samples_ns.back();
+
+    return(result);
+}
+
+void LogBenchmark::AppendThreadFunction(unsigned int thread_idx, unsigned int message_count, std::vector<unsigned int>* append_ns)
+{
+    append_ns->reserve(message_count);
+
+    for(unsigned int message_idx = 0; message_idx < message_count; message_idx++)
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        LOG_TRACE("[LogBenchmark] Thread %u message %u of %u", thread_idx, message_idx, message_count);
+
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        append_ns->push_back((unsigned int)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+}
@@ -0,0 +1,41 @@
+/*-----------------------------------------*\
+|  LogBenchmark.h                           |
+|                                           |
+|  Multi-threaded throughput benchmark of   |
+|  the LogManager append and writer path    |
+\*-----------------------------------------*/
+
+#pragma once
+
+#include <vector>
+
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+#define LOG_BENCHMARK_DEFAULT_THREADS               8
+#define LOG_BENCHMARK_DEFAULT_MESSAGES              100000
+
+class LogBenchmark
+{
+public:
+    /*-----------------------------------------------------*\
+    | Settings (all optional):                              |
+    |   threads, messages (per thread)                      |
+    \*-----------------------------------------------------*/
+    LogBenchmark(const json& benchmark_settings);
+
+    /*-----------------------------------------------------*\
+    | Run both measurements and return the results.  The    |
+    | log level is raised to trace for the written pass and |
+    | restored afterwards                                   |
+    \*-----------------------------------------------------*/
+    json                                Run();
+
+private:
+    unsigned int                        thread_count;
+    unsigned int                        message_count;
+
+    json                                MeasureAppend(unsigned int loglevel);
+    static void                         AppendThreadFunction(unsigned int thread_idx, unsigned int message_count, std::vector<unsigned int>* append_ns);
+};
@@ -1,9 +1,12 @@
 #include "LogManager.h"
 
 #include <stdarg.h>
+#include <stdlib.h>
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <chrono>
+#include <sstream>
 
 #include "ResourceManager.h"
 
@@ -11,27 +14,101 @@
 
 const char* LogManager::log_codes[] = {"FATAL:", "ERROR:", "Warning:", "Info:", "Verbose:", "Debug:", "Trace:", "Dialog:"};
 
+/*-------------------------------------------------*\
+| Each thread that logs owns a message ring.  When  |
+| the thread exits the ring is marked orphaned and  |
+| the writer thread releases it once it is drained  |
+\*-------------------------------------------------*/
+struct LogThreadRing
+{
+    PLogMessageRing ring;
+
+    ~LogThreadRing()
+    {
+        if(ring)
+        {
+            ring->orphaned = true;
+        }
+    }
+};
+
+static thread_local LogThreadRing thread_ring;
+
+static void LogManagerAtExit()
+{
+    LogManager::get()->shutdown();
+}
+
 LogManager::LogManager()
 {
     base_clock = std::chrono::steady_clock::now();
     log_console_enabled = false;
+    configured          = false;
+    writer_wake         = false;
+
+    /*-------------------------------------------------*\
+    | Start the writer thread and make sure queued      |
+    | messages are written out when the app exits       |
+    \*-------------------------------------------------*/
+    writer_run          = true;
+    writer_thread       = new std::thread(&LogManager::WriterThreadFunction, this);
+
+    atexit(LogManagerAtExit);
+}
+
+LogManager::~LogManager()
+{
+    shutdown();
 }
 
 LogManager* LogManager::get()
 {
-    static LogManager* _instance = nullptr;
-    static std::mutex instance_mutex;
-    std::lock_guard<std::mutex> grd(instance_mutex);
+    /*-------------------------------------------------*\
+    | Create the instance on first use.  Function-local |
+    | static initialization is thread safe, so no lock  |
+    | is taken on the logging path                      |
+    \*-------------------------------------------------*/
+    static LogManager* _instance = new LogManager();
 
+    return _instance;
+}
+
+void LogManager::shutdown()
+{
     /*-------------------------------------------------*\
-    | Create a new instance if one does not exist       |
+    | Stop the writer thread, then write out anything   |
+    | still queued                                      |
     \*-------------------------------------------------*/
-    if(!_instance)
+    if(writer_run.exchange(false))
     {
-        _instance = new LogManager();
+        writer_cv.notify_one();
+
+        if(writer_thread && writer_thread->joinable())
+        {
+            writer_thread->join();
+        }
+
+        delete writer_thread;
+        writer_thread = nullptr;
+    }
+
+    flush();
+}
+
+void LogManager::WriterThreadFunction()
+{
+    while(writer_run)
+    {
+        {
+            std::unique_lock<std::mutex> lock(writer_mutex);
+
+            writer_cv.wait_for(lock, std::chrono::milliseconds(LOG_WRITER_INTERVAL_MS), [this]{ return writer_wake.load() || !writer_run.load(); });
+
+            writer_wake = false;
+        }
+
+        flush();
     }
-    
-    return _instance;
 }
 
 unsigned int LogManager::getLoglevel()
@@ -138,6 +215,8 @@ void LogManager::configure(json config, const filesystem::path& defaultDir)
         log_console_enabled = config["log_console"];
     }
 
+    configured = true;
+
     /*-------------------------------------------------*\
     | Flush the log                                     |
     \*-------------------------------------------------*/
@@ -146,27 +225,120 @@ void LogManager::configure(json config, const filesystem::path& defaultDir)
 
 void LogManager::_flush()
 {
+    /*-------------------------------------------------*\
+    | Collect queued messages from every thread's ring  |
+    \*-------------------------------------------------*/
+    std::vector<PLogMessage> batch;
+
+    {
+        std::lock_guard<std::mutex> rings_grd(rings_mutex);
+
+        for(size_t ring_idx = 0; ring_idx < rings.size();)
+        {
+            LogMessageRing* ring = rings[ring_idx].get();
+
+            bool        orphaned = ring->orphaned;
+            std::size_t tail     = ring->tail.load(std::memory_order_relaxed);
+            std::size_t head     = ring->head.load(std::memory_order_acquire);
+
+            for(; tail != head; tail++)
+            {
+                batch.push_back(std::move(ring->slots[tail & (LOG_RING_SIZE - 1)]));
+            }
+
+            ring->tail.store(tail, std::memory_order_release);
+
+            /*-------------------------------------------------*\
+            | Release rings of exited threads once drained      |
+            \*-------------------------------------------------*/
+            if(orphaned)
+            {
+                rings.erase(rings.begin() + ring_idx);
+            }
+            else
+            {
+                ring_idx++;
+            }
+        }
+    }
+
+    /*-------------------------------------------------*\
+    | Restore the global order of messages coming from  |
+    | different threads                                 |
+    \*-------------------------------------------------*/
+    std::stable_sort(batch.begin(), batch.end(), [](const PLogMessage& a, const PLogMessage& b)
+    {
+        return(a->counted_second < b->counted_second);
+    });
+
+    /*-------------------------------------------------*\
+    | Print messages within the current verbosity on    |
+    | the screen and keep a bounded history for the     |
+    | console page                                      |
+    \*-------------------------------------------------*/
+    std::ostringstream console_text;
+    bool               console_written = false;
+
+    for(size_t msg = 0; msg < batch.size(); ++msg)
+    {
+        const PLogMessage& mes = batch[msg];
+
+        if(mes->level <= verbosity || mes->level == LL_DIALOG)
+        {
+            console_text << mes->buffer;
+
+            if(print_source)
+            {
+                console_text << " [" << mes->filename << ":" << mes->line << "]";
+            }
+
+            console_text << "\n";
+            console_written = true;
+        }
+
+        if(log_console_enabled)
+        {
+            all_messages.push_back(mes);
+
+            if(all_messages.size() > LOG_CONSOLE_HISTORY_MAX)
+            {
+                all_messages.pop_front();
+            }
+        }
+
+        temp_messages.push_back(mes);
+    }
+
+    if(console_written)
+    {
+        std::cout << console_text.str();
+        std::cout.flush();
+    }
+
     /*-------------------------------------------------*\
     | If the log is open, write out buffered messages   |
+    | as one block                                      |
     \*-------------------------------------------------*/
-    if(log_stream.is_open())
+    if(log_stream.is_open() && !temp_messages.empty())
     {
+        std::ostringstream log_text;
+
         for(size_t msg = 0; msg < temp_messages.size(); ++msg)
         {
             if(temp_messages[msg]->level <= loglevel || temp_messages[msg]->level == LL_DIALOG)
             {
                 // Put the timestamp here
                 std::chrono::milliseconds counter = std::chrono::duration_cast<std::chrono::milliseconds>(temp_messages[msg]->counted_second);
-                log_stream << std::left << std::setw(6) << counter.count()  << "|";
-                log_stream << std::left << std::setw(9) << log_codes[temp_messages[msg]->level];
-                log_stream << temp_messages[msg]->buffer;
-         
+                log_text << std::left << std::setw(6) << counter.count()  << "|";
+                log_text << std::left << std::setw(9) << log_codes[temp_messages[msg]->level];
+                log_text << temp_messages[msg]->buffer;
+
                 if(print_source)
                 {
-                    log_stream << " [" << temp_messages[msg]->filename << ":" << temp_messages[msg]->line << "]";
+                    log_text << " [" << temp_messages[msg]->filename << ":" << temp_messages[msg]->line << "]";
                 }
-                
-                log_stream << std::endl;
+
+                log_text << "\n";
             }
         }
 
@@ -174,12 +346,13 @@ void LogManager::_flush()
         | Clear temp message buffers after writing them out |
         \*-------------------------------------------------*/
         temp_messages.clear();
-    }
 
-    /*-------------------------------------------------*\
-    | Flush the stream                                  |
-    \*-------------------------------------------------*/
-    log_stream.flush();
+        /*-------------------------------------------------*\
+        | Write and flush the stream                        |
+        \*-------------------------------------------------*/
+        log_stream << log_text.str();
+        log_stream.flush();
+    }
 }
 
 void LogManager::flush()
@@ -188,6 +361,71 @@ void LogManager::flush()
     _flush();
 }
 
+bool LogManager::_wanted(unsigned int level)
+{
+    /*-------------------------------------------------*\
+    | Until the log is configured the file log level is |
+    | not known, so keep everything                     |
+    \*-------------------------------------------------*/
+    return(!configured
+        || log_console_enabled
+        || level <= loglevel
+        || level <= verbosity
+        || level == LL_FATAL
+        || level == LL_DIALOG);
+}
+
+LogMessageRing* LogManager::_thread_ring()
+{
+    if(!thread_ring.ring)
+    {
+        thread_ring.ring = std::make_shared<LogMessageRing>();
+
+        std::lock_guard<std::mutex> grd(rings_mutex);
+        rings.push_back(thread_ring.ring);
+    }
+
+    return(thread_ring.ring.get());
+}
+
+void LogManager::_enqueue(PLogMessage mes)
+{
+    LogMessageRing* ring = _thread_ring();
+
+    std::size_t head = ring->head.load(std::memory_order_relaxed);
+
+    /*-------------------------------------------------*\
+    | If the ring is full, wake the writer and wait for |
+    | it to make room.  Once the writer has stopped,    |
+    | drain the rings from this thread instead          |
+    \*-------------------------------------------------*/
+    while((head - ring->tail.load(std::memory_order_acquire)) >= LOG_RING_SIZE)
+    {
+        if(writer_run)
+        {
+            writer_wake = true;
+            writer_cv.notify_one();
+            std::this_thread::yield();
+        }
+        else
+        {
+            flush();
+        }
+    }
+
+    ring->slots[head & (LOG_RING_SIZE - 1)] = std::move(mes);
+    ring->head.store(head + 1, std::memory_order_release);
+
+    /*-------------------------------------------------*\
+    | Wake the writer early once the ring is half full  |
+    \*-------------------------------------------------*/
+    if((head + 1 - ring->tail.load(std::memory_order_relaxed)) >= (LOG_RING_SIZE / 2))
+    {
+        writer_wake = true;
+        writer_cv.notify_one();
+    }
+}
+
 void LogManager::_append(const char* filename, int line, unsigned int level, const char* fmt, va_list va)
 {
     /*-------------------------------------------------*\
@@ -207,13 +445,28 @@ void LogManager::_append(const char* filename, int line, unsigned int level, con
     PLogMessage mes = std::make_shared<LogMessage>();
 
     /*-------------------------------------------------*\
-    | Resize the buffer, then fill in the message text  |
+    | Format into a stack buffer first, only formatting |
+    | a second time if the message does not fit         |
     \*-------------------------------------------------*/
+    char    stack_buffer[512];
     va_list va2;
     va_copy(va2, va);
-    int len = vsnprintf(nullptr, 0, fmt, va);
-    mes->buffer.resize(len);
-    vsnprintf(&(mes->buffer[0]), len + 1, fmt, va2);
+    int len = vsnprintf(stack_buffer, sizeof(stack_buffer), fmt, va);
+
+    if(len < 0)
+    {
+        len = 0;
+    }
+
+    if(len < (int)sizeof(stack_buffer))
+    {
+        mes->buffer.assign(stack_buffer, len);
+    }
+    else
+    {
+        mes->buffer.resize(len);
+        vsnprintf(&(mes->buffer[0]), len + 1, fmt, va2);
+    }
     va_end(va2);
 
     /*-------------------------------------------------*\
@@ -230,6 +483,8 @@ void LogManager::_append(const char* filename, int line, unsigned int level, con
     \*-------------------------------------------------*/
     if(level == LL_DIALOG)
     {
+        std::lock_guard<std::mutex> grd(dialog_mutex);
+
         for(size_t idx = 0; idx < dialog_show_callbacks.size(); idx++)
         {
             dialog_show_callbacks[idx](dialog_show_callback_args[idx], mes);
@@ -237,52 +492,53 @@ void LogManager::_append(const char* filename, int line, unsigned int level, con
     }
 
     /*-------------------------------------------------*\
-    | If the message is within the current verbosity,   |
-    | print it on the screen                            |
-    | TODO: Put the timestamp here                      |
+    | Queue the message for the writer thread           |
     \*-------------------------------------------------*/
-    if(level <= verbosity || level == LL_DIALOG)
-    {
-        std::cout << mes->buffer;
-        if(print_source)
-        {
-            std::cout << " [" << mes->filename << ":" << mes->line << "]";
-        }
-        std::cout << std::endl;
-    }
+    _enqueue(mes);
 
     /*-------------------------------------------------*\
-    | Add the message to the logfile queue              |
+    | Write fatal messages out immediately as the app   |
+    | may not survive long enough for the writer, and   |
+    | wake the writer early for errors.  After shutdown |
+    | write everything out directly                     |
     \*-------------------------------------------------*/
-    temp_messages.push_back(mes);
-
-    if(log_console_enabled)
+    if(level == LL_FATAL || !writer_run)
     {
-        all_messages.push_back(mes);
+        flush();
+    }
+    else if(level == LL_ERROR || level == LL_DIALOG)
+    {
+        writer_wake = true;
+        writer_cv.notify_one();
     }
-
-    /*-------------------------------------------------*\
-    | Flush the queues                                  |
-    \*-------------------------------------------------*/
-    _flush();
 }
 
 std::vector<PLogMessage> LogManager::messages()
 {
-    return all_messages;
+    std::lock_guard<std::mutex> grd(entry_mutex);
+    return std::vector<PLogMessage>(all_messages.begin(), all_messages.end());
 }
 
 void LogManager::clearMessages()
 {
+    std::lock_guard<std::mutex> grd(entry_mutex);
     all_messages.clear();
 }
 
 void LogManager::append(const char* filename, int line, unsigned int level, const char* fmt, ...)
 {
+    /*-------------------------------------------------*\
+    | Skip messages that would not be written anywhere  |
+    | before doing any formatting                       |
+    \*-------------------------------------------------*/
+    if(!_wanted(level))
+    {
+        return;
+    }
+
     va_list va;
     va_start(va, fmt);
 
-    std::lock_guard<std::mutex> grd(entry_mutex);
     _append(filename, line, level, fmt, va);
 
     va_end(va);
@@ -336,12 +592,16 @@ void LogManager::setPrintSource(bool v)
 void LogManager::RegisterDialogShowCallback(LogDialogShowCallback callback, void* receiver)
 {
     LOG_DEBUG("dialog show callback registered");
+
+    std::lock_guard<std::mutex> grd(dialog_mutex);
     dialog_show_callbacks.push_back(callback);
     dialog_show_callback_args.push_back(receiver);
 }
 
 void LogManager::UnregisterDialogShowCallback(LogDialogShowCallback callback, void* receiver)
 {
+    std::lock_guard<std::mutex> grd(dialog_mutex);
+
     for(size_t idx = 0; idx < dialog_show_callbacks.size(); idx++)
     {
         if(dialog_show_callbacks[idx] == callback && dialog_show_callback_args[idx] == receiver)
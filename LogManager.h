@@ -1,8 +1,12 @@
 #ifndef LOGMANAGER_H
 #define LOGMANAGER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <mutex>
+#include <thread>
 #include <vector>
 #include <queue>
 #include <memory>
@@ -44,6 +48,37 @@ struct LogMessage
 typedef std::shared_ptr<LogMessage> PLogMessage;
 typedef void(*LogDialogShowCallback)(void*, PLogMessage);
 
+/*-------------------------------------------------*\
+| Size of each per-thread message ring, must be a   |
+| power of two                                      |
+\*-------------------------------------------------*/
+#define LOG_RING_SIZE               1024
+
+/*-------------------------------------------------*\
+| Maximum number of messages kept for the console   |
+\*-------------------------------------------------*/
+#define LOG_CONSOLE_HISTORY_MAX     10000
+
+/*-------------------------------------------------*\
+| Interval at which the writer thread drains the    |
+| message rings when not woken early                |
+\*-------------------------------------------------*/
+#define LOG_WRITER_INTERVAL_MS      50
+
+/*-------------------------------------------------*\
+| Single producer, single consumer message ring.    |
+| Each logging thread owns one, the writer thread   |
+| is the only consumer                              |
+\*-------------------------------------------------*/
+struct LogMessageRing
+{
+    PLogMessage                 slots[LOG_RING_SIZE];
+    std::atomic<std::size_t>    head{0};
+    std::atomic<std::size_t>    tail{0};
+    std::atomic<bool>           orphaned{false};
+};
+typedef std::shared_ptr<LogMessageRing> PLogMessageRing;
+
 class LogManager
 {
 private:
@@ -55,37 +90,64 @@ private:
     std::mutex section_mutex;
     std::ofstream log_stream;
 
+    std::mutex                          dialog_mutex;
     std::vector<LogDialogShowCallback>  dialog_show_callbacks;
     std::vector<void*>                  dialog_show_callback_args;
 
+    // Per-thread message rings, the mutex only guards registration
+    std::mutex                          rings_mutex;
+    std::vector<PLogMessageRing>        rings;
+
+    // Background writer thread
+    std::thread*                        writer_thread;
+    std::atomic<bool>                   writer_run;
+    std::mutex                          writer_mutex;
+    std::condition_variable             writer_cv;
+    std::atomic<bool>                   writer_wake;
+
     // A temporary log message storage to hold them until the stream opens
     std::vector<PLogMessage> temp_messages;
 
-    // A log message storage that will be displayed in the app
-    std::vector<PLogMessage> all_messages;
+    // A log message storage that will be displayed in the app, bounded to LOG_CONSOLE_HISTORY_MAX
+    std::deque<PLogMessage> all_messages;
+
+    // Set once configure() has opened the log file
+    std::atomic<bool> configured;
 
     // A flag that marks if the message source file name and line number should be printed on screen
-    bool print_source = false;
+    std::atomic<bool> print_source{false};
 
     // Logfile max level
-    unsigned int loglevel = LL_INFO;
-    
+    std::atomic<unsigned int> loglevel{LL_INFO};
+
     // Verbosity (stdout) max level
-    unsigned int verbosity = LL_WARNING;
+    std::atomic<unsigned int> verbosity{LL_WARNING};
 
     //Clock from LogManager creation
     std::chrono::time_point<std::chrono::steady_clock> base_clock;
 
+    // Returns true if a message at this level would be written anywhere
+    bool _wanted(unsigned int level);
+
+    // Returns the calling thread's message ring, registering it on first use
+    LogMessageRing* _thread_ring();
+
+    // Queue a message on the calling thread's ring
+    void _enqueue(PLogMessage mes);
+
     // A non-guarded append()
     void _append(const char* filename, int line, unsigned int level, const char* fmt, va_list va);
 
-    // A non-guarded flush()
+    // Drain all rings and write out the messages, entry_mutex must be held
     void _flush();
 
+    void WriterThreadFunction();
+
 public:
     static LogManager* get();
     void configure(json config, const filesystem::path & defaultDir);
     void flush();
+    void shutdown();
     void append(const char* filename, int line, unsigned int level, const char* fmt, ...);
     void setLoglevel(unsigned int);
     void setVerbosity(unsigned int);
@@ -97,7 +159,7 @@ public:
     void clearMessages();
     std::vector<PLogMessage> messages();
 
-    bool log_console_enabled;
+    std::atomic<bool> log_console_enabled;
     static const char* log_codes[];
 };
 
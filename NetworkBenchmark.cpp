@@ -0,0 +1,533 @@
+/*-----------------------------------------*\
+|  NetworkBenchmark.cpp                     |
+|                                           |
+|  End-to-end benchmark of the SDK path,    |
+|  running an in-process server with        |
+|  synthetic controllers and a number of    |
+|  loopback clients                         |
+\*-----------------------------------------*/
+
+#include "NetworkBenchmark.h"
+#include "LogManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace std::chrono_literals;
+
+static unsigned int GetBenchmarkSetting(const json& benchmark_settings, const char* key, unsigned int default_value)
+{
+    if(benchmark_settings.contains(key))
+    {
+        return(benchmark_settings[key]);
+    }
+
+    return(default_value);
+}
+
+NetworkBenchmark::NetworkBenchmark(const json& benchmark_settings)
+{
+    client_count    = GetBenchmarkSetting(benchmark_settings, "clients",         NETWORK_BENCHMARK_DEFAULT_CLIENTS);
+    device_count    = GetBenchmarkSetting(benchmark_settings, "devices",         NETWORK_BENCHMARK_DEFAULT_DEVICES);
+    led_count       = GetBenchmarkSetting(benchmark_settings, "leds",            NETWORK_BENCHMARK_DEFAULT_LEDS);
+    frame_count     = GetBenchmarkSetting(benchmark_settings, "frames",          NETWORK_BENCHMARK_DEFAULT_FRAMES);
+    latency_samples = GetBenchmarkSetting(benchmark_settings, "latency_samples", NETWORK_BENCHMARK_DEFAULT_LATENCY_SAMPLES);
+    port            = GetBenchmarkSetting(benchmark_settings, "port",            NETWORK_BENCHMARK_DEFAULT_PORT);
+    udp_stream      = GetBenchmarkSetting(benchmark_settings, "udp_stream",      0) != 0;
+    server          = nullptr;
+
+    if(benchmark_settings.contains("unix_socket"))
+    {
+        unix_socket = benchmark_settings["unix_socket"];
+    }
+
+    if(client_count == 0)
+    {
+        client_count = 1;
+    }
+
+    if(device_count == 0)
+    {
+        device_count = 1;
+    }
+
+    if(led_count == 0)
+    {
+        led_count = 1;
+    }
+}
+
+NetworkBenchmark::~NetworkBenchmark()
+{
+    /*-----------------------------------------------------*\
+    | The server's connection and listen threads are        |
+    | detached and may still touch the server and its       |
+    | controllers briefly after StopServer, so they are     |
+    | left allocated.  The benchmark exits once it is done  |
+    \*-----------------------------------------------------*/
+    for(unsigned int client_idx = 0; client_idx < clients.size(); client_idx++)
+    {
+        delete clients[client_idx];
+        delete client_controllers[client_idx];
+    }
+}
+
+json NetworkBenchmark::Run()
+{
+    json results;
+
+    results["config"]["clients"]            = client_count;
+    results["config"]["devices"]            = device_count;
+    results["config"]["leds"]               = led_count;
+    results["config"]["frames"]             = frame_count;
+    results["config"]["latency_samples"]    = latency_samples;
+    results["config"]["port"]               = port;
+    results["config"]["unix_socket"]        = unix_socket;
+    results["config"]["udp_stream"]         = udp_stream;
+
+    CreateControllers();
+
+    if(!StartServer())
+    {
+        results["error"] = "server failed to start listening on port " + std::to_string(port);
+        return(results);
+    }
+
+    results["sync"] = MeasureSync();
+
+    if(results["sync"].contains("error"))
+    {
+        results["error"] = results["sync"]["error"];
+        Stop();
+        return(results);
+    }
+
+    results["throughput"]   = MeasureThroughput();
+    results["latency"]      = MeasureLatency();
+
+    if(udp_stream)
+    {
+        results["stream"]   = GetStreamStats();
+    }
+
+    Stop();
+
+    return(results);
+}
+
+void NetworkBenchmark::CreateControllers()
+{
+    for(unsigned int device_idx = 0; device_idx < device_count; device_idx++)
+    {
+        RGBController_Debug* controller = new RGBController_Debug();
+
+        controller->name        = "Benchmark Device " + std::to_string(device_idx);
+        controller->type        = DEVICE_TYPE_LEDSTRIP;
+        controller->description = "SDK Benchmark Device";
+        controller->location    = "SDK Benchmark Location " + std::to_string(device_idx);
+
+        mode direct_mode;
+
+        direct_mode.name        = "Direct";
+        direct_mode.value       = 0;
+        direct_mode.flags       = MODE_FLAG_HAS_PER_LED_COLOR;
+        direct_mode.color_mode  = MODE_COLORS_PER_LED;
+
+        controller->modes.push_back(direct_mode);
+
+        zone linear_zone;
+
+        linear_zone.name        = "Linear Zone";
+        linear_zone.type        = ZONE_TYPE_LINEAR;
+        linear_zone.leds_min    = led_count;
+        linear_zone.leds_max    = led_count;
+        linear_zone.leds_count  = led_count;
+        linear_zone.matrix_map  = NULL;
+
+        controller->zones.push_back(linear_zone);
+
+        for(unsigned int led_idx = 0; led_idx < led_count; led_idx++)
+        {
+            led new_led;
+
+            new_led.name        = "LED " + std::to_string(led_idx);
+
+            controller->leds.push_back(new_led);
+        }
+
+        controller->SetupColors();
+
+        server_controllers.push_back(controller);
+        debug_controllers.push_back(controller);
+    }
+}
+
+bool NetworkBenchmark::StartServer()
+{
+    server = new NetworkServer(server_controllers);
+
+    server->SetHost("127.0.0.1");
+    server->SetPort(port);
+    server->SetUnixSocketPath(unix_socket);
+    server->SetUDPStreamEnabled(udp_stream);
+    server->StartServer();
+
+    for(unsigned int timeout = 0; timeout < 100; timeout++)
+    {
+        if(server->GetListening())
+        {
+            return(true);
+        }
+
+        std::this_thread::sleep_for(10ms);
+    }
+
+    return(server->GetListening());
+}
+
+json NetworkBenchmark::MeasureSync()
+{
+    json sync;
+
+    long long rss_before = GetResidentBytes();
+
+    /*-----------------------------------------------------*\
+    | Connect all clients at once and time how long each    |
+    | takes to receive the full controller list             |
+    \*-----------------------------------------------------*/
+    std::chrono::steady_clock::time_point sync_start = std::chrono::steady_clock::now();
+
+    for(unsigned int client_idx = 0; client_idx < client_count; client_idx++)
+    {
+        std::vector<RGBController *>* controllers = new std::vector<RGBController *>();
+        NetworkClient*                client      = new NetworkClient(*controllers);
+
+        client->SetIP("127.0.0.1");
+        client->SetName(("OpenRGB SDK Benchmark " + std::to_string(client_idx)).c_str());
+        client->SetPort(port);
+        client->SetUnixSocketPath(unix_socket);
+        client->SetUDPStream(udp_stream);
+        client->StartClient();
+
+        clients.push_back(client);
+        client_controllers.push_back(controllers);
+    }
+
+    std::vector<double> sync_ms(client_count, -1.0);
+    unsigned int        synced = 0;
+
+    while(synced < client_count)
+    {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if(now - sync_start > 60s)
+        {
+            sync["error"] = "timed out waiting for clients to receive the controller list";
+            return(sync);
+        }
+
+        for(unsigned int client_idx = 0; client_idx < client_count; client_idx++)
+        {
+            if(sync_ms[client_idx] < 0.0 && clients[client_idx]->GetOnline())
+            {
+                sync_ms[client_idx] = std::chrono::duration<double, std::milli>(now - sync_start).count();
+                synced++;
+            }
+        }
+
+        std::this_thread::sleep_for(1ms);
+    }
+
+    long long rss_after = GetResidentBytes();
+
+    sync["client_ms"]   = sync_ms;
+    sync["max_ms"]      = *std::max_element(sync_ms.begin(), sync_ms.end());
+
+    /*-----------------------------------------------------*\
+    | Memory is measured for the whole process, so it       |
+    | covers both the client and server side of each        |
+    | connection                                            |
+    \*-----------------------------------------------------*/
+    if(rss_before >= 0 && rss_after >= 0)
+    {
+        sync["memory_per_connection_bytes"] = (rss_after - rss_before) / (long long)client_count;
+    }
+    else
+    {
+        sync["memory_per_connection_bytes"] = nullptr;
+    }
+
+    return(sync);
+}
+
+json NetworkBenchmark::MeasureThroughput()
+{
+    json throughput;
+
+    WaitForServerIdle();
+
+    unsigned long long updates_before = GetServerUpdateCount();
+
+    /*-----------------------------------------------------*\
+    | Each client sends frame_count frames, a frame being   |
+    | one UpdateLEDs of every device, as fast as it can     |
+    \*-----------------------------------------------------*/
+    std::vector<std::thread *>  client_threads;
+    std::vector<double>         client_bytes(client_count, 0.0);
+
+    std::chrono::steady_clock::time_point send_start = std::chrono::steady_clock::now();
+
+    for(unsigned int client_idx = 0; client_idx < client_count; client_idx++)
+    {
+        client_threads.push_back(new std::thread([this, client_idx, &client_bytes]
+        {
+            std::vector<RGBController *>& controllers = clients[client_idx]->server_controllers;
+            std::size_t                   header_size = clients[client_idx]->GetUDPStreamActive() ? sizeof(NetStreamHeader) : sizeof(NetPacketHeader);
+
+            for(unsigned int frame_idx = 0; frame_idx < frame_count; frame_idx++)
+            {
+                RGBColor color = ToRGBColor(frame_idx & 0xFF, client_idx & 0xFF, 0x80);
+
+                for(unsigned int controller_idx = 0; controller_idx < controllers.size(); controller_idx++)
+                {
+                    controllers[controller_idx]->SetAllLEDs(color);
+                    controllers[controller_idx]->UpdateLEDs();
+
+                    client_bytes[client_idx] += header_size + sizeof(unsigned int) + sizeof(unsigned short) + (controllers[controller_idx]->colors.size() * sizeof(RGBColor));
+                }
+            }
+        }));
+    }
+
+    for(unsigned int client_idx = 0; client_idx < client_count; client_idx++)
+    {
+        client_threads[client_idx]->join();
+        delete client_threads[client_idx];
+    }
+
+    std::chrono::steady_clock::time_point send_end = std::chrono::steady_clock::now();
+
+    WaitForServerIdle();
+
+    std::chrono::steady_clock::time_point drain_end = std::chrono::steady_clock::now();
+
+    double send_seconds     = std::chrono::duration<double>(send_end - send_start).count();
+    double total_seconds    = std::chrono::duration<double>(drain_end - send_start).count();
+    double total_bytes      = 0.0;
+
+    for(unsigned int client_idx = 0; client_idx < client_count; client_idx++)
+    {
+        total_bytes += client_bytes[client_idx];
+    }
+
+    double frames_sent      = (double)client_count * (double)frame_count;
+
+    throughput["frames_sent"]                   = frames_sent;
+    throughput["send_seconds"]                  = send_seconds;
+    throughput["frames_per_second"]             = (send_seconds > 0.0) ? (frames_sent / send_seconds) : 0.0;
+    throughput["megabytes_per_second"]          = (send_seconds > 0.0) ? (total_bytes / send_seconds / 1000000.0) : 0.0;
+    throughput["drain_seconds"]                 = total_seconds;
+
+    /*-----------------------------------------------------*\
+    | The server coalesces updates that arrive while a      |
+    | device is busy, so count the ones that reached the    |
+    | devices separately                                    |
+    \*-----------------------------------------------------*/
+    unsigned long long device_updates           = GetServerUpdateCount() - updates_before;
+
+    throughput["device_updates"]                = device_updates;
+    throughput["device_updates_per_second"]     = (total_seconds > 0.0) ? ((double)device_updates / total_seconds) : 0.0;
+
+    return(throughput);
+}
+
+json NetworkBenchmark::MeasureLatency()
+{
+    json latency;
+
+    WaitForServerIdle();
+
+    /*-----------------------------------------------------*\
+    | Time from sending UpdateLEDs on the first client to   |
+    | DeviceUpdateLEDs being entered on the server device   |
+    \*-----------------------------------------------------*/
+    RGBController*          client_controller   = clients[0]->server_controllers[0];
+    RGBController_Debug*    server_controller   = debug_controllers[0];
+    std::vector<double>     samples_us;
+
+    for(unsigned int sample_idx = 0; sample_idx < latency_samples; sample_idx++)
+    {
+        unsigned int update_count = server_controller->GetUpdateCount();
+
+        client_controller->SetAllLEDs(ToRGBColor(sample_idx & 0xFF, 0x00, 0xFF));
+
+        std::chrono::steady_clock::time_point send_time = std::chrono::steady_clock::now();
+
+        client_controller->UpdateLEDs();
+
+        while(server_controller->GetUpdateCount() == update_count)
+        {
+            if(std::chrono::steady_clock::now() - send_time > 1s)
+            {
+                break;
+            }
+
+            std::this_thread::yield();
+        }
+
+        if(server_controller->GetUpdateCount() != update_count)
+        {
+            samples_us.push_back(std::chrono::duration<double, std::micro>(server_controller->GetLastUpdateTime() - send_time).count());
+        }
+
+        /*-------------------------------------------------*\
+        | Let the device thread go idle between samples     |
+        \*-------------------------------------------------*/
+        std::this_thread::sleep_for(2ms);
+    }
+
+    latency["samples"]  = samples_us.size();
+    latency["lost"]     = latency_samples - samples_us.size();
+
+    if(samples_us.empty())
+    {
+        return(latency);
+    }
+
+    std::sort(samples_us.begin(), samples_us.end());
+
+    double sum = 0.0;
+
+    for(std::size_t sample_idx = 0; sample_idx < samples_us.size(); sample_idx++)
+    {
+        sum += samples_us[sample_idx];
+    }
+
+    latency["min_us"]   = samples_us.front();
+    latency["mean_us"]  = sum / samples_us.size();
+    latency["p50_us"]   = samples_us[samples_us.size() / 2];
+    latency["p99_us"]   = samples_us[std::min(samples_us.size() - 1, (samples_us.size() * 99) / 100)];
+    latency["max_us"]   = samples_us.back();
+
+    return(latency);
+}
+
+json NetworkBenchmark::GetStreamStats()
+{
+    json stream;
+
+    /*-----------------------------------------------------*\
+    | Loopback should not lose frames, but the server drops |
+    | stale ones when client threads race on a device       |
+    \*-----------------------------------------------------*/
+    for(unsigned int client_idx = 0; client_idx < server->GetNumClients(); client_idx++)
+    {
+        NetworkStreamStats  stats;
+        json                client_stats;
+
+        if(server->GetClientStreamStats(client_idx, &stats))
+        {
+            client_stats["frames_received"] = stats.frames_received;
+            client_stats["frames_lost"]     = stats.frames_lost;
+            client_stats["frames_stale"]    = stats.frames_stale;
+            client_stats["jitter_us"]       = stats.jitter_us;
+        }
+        else
+        {
+            client_stats = nullptr;
+        }
+
+        stream["clients"].push_back(client_stats);
+    }
+
+    return(stream);
+}
+
+void NetworkBenchmark::WaitForServerIdle()
+{
+    /*-----------------------------------------------------*\
+    | Wait until no device update has happened for 200ms,   |
+    | giving up after 10s                                   |
+    \*-----------------------------------------------------*/
+    std::chrono::steady_clock::time_point wait_start    = std::chrono::steady_clock::now();
+    unsigned long long                    last_count    = GetServerUpdateCount();
+    std::chrono::steady_clock::time_point last_change   = wait_start;
+
+    while(std::chrono::steady_clock::now() - wait_start < 10s)
+    {
+        std::this_thread::sleep_for(10ms);
+
+        unsigned long long count = GetServerUpdateCount();
+
+        if(count != last_count)
+        {
+            last_count  = count;
+            last_change = std::chrono::steady_clock::now();
+        }
+        else if(std::chrono::steady_clock::now() - last_change > 200ms)
+        {
+            break;
+        }
+    }
+}
+
+void NetworkBenchmark::Stop()
+{
+    /*-----------------------------------------------------*\
+    | Stop the server first so the clients' sockets close   |
+    | and their listen threads exit without waiting for the |
+    | receive timeout                                       |
+    \*-----------------------------------------------------*/
+    server->StopServer();
+
+    for(unsigned int client_idx = 0; client_idx < clients.size(); client_idx++)
+    {
+        clients[client_idx]->StopClient();
+    }
+}
+
+unsigned long long NetworkBenchmark::GetServerUpdateCount()
+{
+    unsigned long long count = 0;
+
+    for(unsigned int controller_idx = 0; controller_idx < debug_controllers.size(); controller_idx++)
+    {
+        count += debug_controllers[controller_idx]->GetUpdateCount();
+    }
+
+    return(count);
+}
+
+long long NetworkBenchmark::GetResidentBytes()
+{
+#ifdef __linux__
+    FILE* statm = fopen("/proc/self/statm", "r");
+
+    if(statm == NULL)
+    {
+        return(-1);
+    }
+
+    long long size      = 0;
+    long long resident  = 0;
+
+    int fields = fscanf(statm, "%lld %lld", &size, &resident);
+
+    fclose(statm);
+
+    if(fields != 2)
+    {
+        return(-1);
+    }
+
+    return(resident * sysconf(_SC_PAGESIZE));
+#else
+    return(-1);
+#endif
+}
@@ -0,0 +1,76 @@
+/*-----------------------------------------*\
+|  NetworkBenchmark.h                       |
+|                                           |
+|  End-to-end benchmark of the SDK path,    |
+|  running an in-process server with        |
+|  synthetic controllers and a number of    |
+|  loopback clients                         |
+\*-----------------------------------------*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "NetworkClient.h"
+#include "NetworkServer.h"
+#include "RGBController_Debug.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+#define NETWORK_BENCHMARK_DEFAULT_CLIENTS           4
+#define NETWORK_BENCHMARK_DEFAULT_DEVICES           32
+#define NETWORK_BENCHMARK_DEFAULT_LEDS              120
+#define NETWORK_BENCHMARK_DEFAULT_FRAMES            500
+#define NETWORK_BENCHMARK_DEFAULT_LATENCY_SAMPLES   200
+#define NETWORK_BENCHMARK_DEFAULT_PORT              (OPENRGB_SDK_PORT + 1)
+
+class NetworkBenchmark
+{
+public:
+    /*-----------------------------------------------------*\
+    | Settings (all optional):                              |
+    |   clients, devices, leds, frames, latency_samples,    |
+    |   port, unix_socket (connect the clients over a Unix  |
+    |   domain socket at this path instead of TCP),         |
+    |   udp_stream (1 to send LED colors over UDP streams)  |
+    \*-----------------------------------------------------*/
+    NetworkBenchmark(const json& benchmark_settings);
+    ~NetworkBenchmark();
+
+    /*-----------------------------------------------------*\
+    | Run all measurements and return the results, or an   |
+    | object with an "error" string if the run failed       |
+    \*-----------------------------------------------------*/
+    json                                Run();
+
+private:
+    unsigned int                        client_count;
+    unsigned int                        device_count;
+    unsigned int                        led_count;
+    unsigned int                        frame_count;
+    unsigned int                        latency_samples;
+    unsigned short                      port;
+    std::string                         unix_socket;
+    bool                                udp_stream;
+
+    std::vector<RGBController *>        server_controllers;
+    std::vector<RGBController_Debug *>  debug_controllers;
+    NetworkServer*                      server;
+
+    std::vector<NetworkClient *>                    clients;
+    std::vector<std::vector<RGBController *> *>     client_controllers;
+
+    void                                CreateControllers();
+    bool                                StartServer();
+    json                                MeasureSync();
+    json                                MeasureThroughput();
+    json                                MeasureLatency();
+    json                                GetStreamStats();
+    void                                WaitForServerIdle();
+    void                                Stop();
+
+    unsigned long long                  GetServerUpdateCount();
+    static long long                    GetResidentBytes();
+};
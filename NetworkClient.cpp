@@ -8,6 +8,7 @@
 
 #include "NetworkClient.h"
 #include "RGBController_Network.h"
+#include <chrono>
 #include <cstring>
 
 #ifdef _WIN32
@@ -34,6 +35,8 @@ NetworkClient::NetworkClient(std::vector<RGBController *>& control) : controller
     server_connected        = false;
     server_controller_count = 0;
     change_in_progress      = false;
+    udp_stream_enabled      = false;
+    udp_stream_active       = false;
 
     ListenThread            = NULL;
     ConnectionThread        = NULL;
@@ -103,6 +106,11 @@ bool NetworkClient::GetOnline()
     return(server_connected && server_initialized);
 }
 
+bool NetworkClient::GetUDPStreamActive()
+{
+    return(udp_stream_active);
+}
+
 void NetworkClient::RegisterClientInfoChangeCallback(NetClientCallback new_callback, void * new_callback_arg)
 {
     ClientInfoChangeCallbacks.push_back(new_callback);
@@ -135,13 +143,40 @@ void NetworkClient::SetPort(unsigned short new_port)
     }
 }
 
+void NetworkClient::SetUDPStream(bool enable)
+{
+    if(server_connected == false)
+    {
+        udp_stream_enabled = enable;
+    }
+}
+
+void NetworkClient::SetUnixSocketPath(std::string new_path)
+{
+    if(server_connected == false)
+    {
+        unix_socket_path = new_path;
+    }
+}
+
 void NetworkClient::StartClient()
 {
-    //Start a TCP server and launch threads
-    char port_str[6];
-    snprintf(port_str, 6, "%d", port_num);
+    /*-------------------------------------------------*\
+    | Connect over a Unix domain socket if a path is    |
+    | set, otherwise over TCP                           |
+    \*-------------------------------------------------*/
+    if(unix_socket_path != "")
+    {
+        port.unix_client(unix_socket_path.c_str());
+    }
+    else
+    {
+        //Start a TCP server and launch threads
+        char port_str[6];
+        snprintf(port_str, 6, "%d", port_num);
 
-    port.tcp_client(port_ip.c_str(), port_str);
+        port.tcp_client(port_ip.c_str(), port_str);
+    }
 
     client_active = true;
 
@@ -168,6 +203,8 @@ void NetworkClient::StopClient()
     client_active    = false;
     server_connected = false;
 
+    StopUDPStream();
+
     if(ListenThread)
     {
         ListenThread->join();
@@ -200,9 +237,21 @@ void NetworkClient::ConnectionThreadFunction()
             server_initialized = false;
 
             //Try to connect to server
-            if(port.tcp_client_connect() == true)
+            bool connect_result;
+
+            if(unix_socket_path != "")
+            {
+                connect_result = port.unix_client_connect();
+            }
+            else
+            {
+                connect_result = port.tcp_client_connect();
+            }
+
+            if(connect_result == true)
             {
                 client_sock = port.sock;
+                writer.set_socket(client_sock);
                 printf( "Connected to server\n" );
 
                 //Server is now connected
@@ -301,6 +350,15 @@ void NetworkClient::ConnectionThreadFunction()
 
             ControllerListMutex.unlock();
 
+            /*-------------------------------------------------*\
+            | Request a UDP color stream if enabled and the     |
+            | server supports it                                |
+            \*-------------------------------------------------*/
+            if(udp_stream_enabled && server_protocol_version >= 5 && unix_socket_path == "")
+            {
+                StartUDPStream();
+            }
+
             server_initialized = true;
 
             /*-------------------------------------------------*\
@@ -313,6 +371,87 @@ void NetworkClient::ConnectionThreadFunction()
     }
 }
 
+/*-----------------------------------------------------*\
+| Send a packet header and its data as one message.     |
+| The writer serializes the device threads sending on   |
+| this connection and coalesces their packets           |
+\*-----------------------------------------------------*/
+void NetworkClient::SendPacket(NetPacketHeader * header, const char * data)
+{
+    net_port_buffer buffers[2];
+
+    buffers[0].buffer = (const char *)header;
+    buffers[0].length = sizeof(NetPacketHeader);
+    buffers[1].buffer = data;
+    buffers[1].length = (data == NULL) ? 0 : header->pkt_size;
+
+    writer.write(buffers, 2);
+}
+
+void NetworkClient::StartUDPStream()
+{
+    udp_stream_id             = 0;
+    udp_stream_reply_received = false;
+
+    SendRequest_UDPStream();
+
+    //Wait up to 1s for the stream reply
+    for(unsigned int timeout_counter = 0; !udp_stream_reply_received && timeout_counter < 200; timeout_counter++)
+    {
+        std::this_thread::sleep_for(5ms);
+    }
+
+    if(udp_stream_id == 0)
+    {
+        printf("Client: UDP stream not available, using TCP\r\n");
+        return;
+    }
+
+    /*-------------------------------------------------*\
+    | Send datagrams to the address of the TCP peer so  |
+    | they come from the host the server expects.  The  |
+    | UDP port only supports IPv4                       |
+    \*-------------------------------------------------*/
+    struct sockaddr_storage peer_addr;
+    socklen_t               peer_len = sizeof(peer_addr);
+    char                    ipstr[INET6_ADDRSTRLEN];
+    char                    port_str[6];
+
+    if(getpeername(client_sock, (struct sockaddr*)&peer_addr, &peer_len) != 0 || peer_addr.ss_family != AF_INET)
+    {
+        printf("Client: UDP stream requires an IPv4 connection, using TCP\r\n");
+        return;
+    }
+
+    inet_ntop(AF_INET, &((struct sockaddr_in *)&peer_addr)->sin_addr, ipstr, sizeof(ipstr));
+    snprintf(port_str, 6, "%u", udp_stream_port);
+
+    UDPStreamMutex.lock();
+
+    if(udp_stream.udp_client(ipstr, port_str))
+    {
+        udp_stream_sequence.clear();
+        udp_stream_active = true;
+
+        printf("Client: UDP stream started to %s:%s\r\n", ipstr, port_str);
+    }
+
+    UDPStreamMutex.unlock();
+}
+
+void NetworkClient::StopUDPStream()
+{
+    UDPStreamMutex.lock();
+
+    if(udp_stream_active)
+    {
+        udp_stream_active = false;
+        closesocket(udp_stream.sock);
+    }
+
+    UDPStreamMutex.unlock();
+}
+
 int NetworkClient::recv_select(SOCKET s, char *buf, int len, int flags)
 {
     fd_set              set;
@@ -465,9 +604,21 @@ void NetworkClient::ListenThreadFunction()
                 ProcessReply_ProtocolVersion(header.pkt_size, data);
                 break;
 
+            case NET_PACKET_ID_REQUEST_UDP_STREAM:
+                ProcessReply_UDPStream(header.pkt_size, data);
+                break;
+
             case NET_PACKET_ID_DEVICE_LIST_UPDATED:
                 ProcessRequest_DeviceListChanged();
                 break;
+
+            case NET_PACKET_ID_COLORS_UPDATED:
+                ProcessRequest_ColorsUpdated(header.pkt_dev_idx, header.pkt_size, data);
+                break;
+
+            case NET_PACKET_ID_COLORS_UPDATED_DELTA:
+                ProcessRequest_ColorsUpdatedDelta(header.pkt_dev_idx, header.pkt_size, data);
+                break;
         }
 
         delete[] data;
@@ -478,6 +629,8 @@ listen_done:
     server_initialized = false;
     server_connected = false;
 
+    StopUDPStream();
+
     ControllerListMutex.lock();
 
     for(size_t server_controller_idx = 0; server_controller_idx < server_controllers.size(); server_controller_idx++)
@@ -498,6 +651,7 @@ listen_done:
 
     for(size_t server_controller_idx = 0; server_controller_idx < server_controllers_copy.size(); server_controller_idx++)
     {
+        server_controllers_copy[server_controller_idx]->Shutdown();
         delete server_controllers_copy[server_controller_idx];
     }
 
@@ -546,7 +700,7 @@ void NetworkClient::ProcessReply_ControllerData(unsigned int /*data_size*/, char
     }
     else
     {
-        server_controllers[dev_idx]->active_mode = new_controller->active_mode;
+        server_controllers[dev_idx]->SelectMode(new_controller->GetMode());
         for(unsigned int i = 0; i < server_controllers[dev_idx]->zones.size(); i++)
         {
             server_controllers[dev_idx]->zones[i].leds_count = new_controller->zones[i].leds_count;
@@ -568,6 +722,17 @@ void NetworkClient::ProcessReply_ProtocolVersion(unsigned int data_size, char *
     }
 }
 
+void NetworkClient::ProcessReply_UDPStream(unsigned int data_size, char * data)
+{
+    if(data_size == 2 * sizeof(unsigned int))
+    {
+        memcpy(&udp_stream_id, data, sizeof(unsigned int));
+        memcpy(&udp_stream_port, data + sizeof(unsigned int), sizeof(unsigned int));
+    }
+
+    udp_stream_reply_received = true;
+}
+
 void NetworkClient::ProcessRequest_DeviceListChanged()
 {
     change_in_progress = true;
@@ -592,6 +757,7 @@ void NetworkClient::ProcessRequest_DeviceListChanged()
 
     for(size_t server_controller_idx = 0; server_controller_idx < server_controllers_copy.size(); server_controller_idx++)
     {
+        server_controllers_copy[server_controller_idx]->Shutdown();
         delete server_controllers_copy[server_controller_idx];
     }
 
@@ -610,6 +776,93 @@ void NetworkClient::ProcessRequest_DeviceListChanged()
     change_in_progress = false;
 }
 
+void NetworkClient::ProcessRequest_ColorsUpdated(unsigned int dev_idx, unsigned int data_size, char * data)
+{
+    unsigned short num_colors;
+
+    if(data_size < (sizeof(unsigned int) + sizeof(unsigned short)))
+    {
+        return;
+    }
+
+    memcpy(&num_colors, data + sizeof(unsigned int), sizeof(unsigned short));
+
+    if(data_size < (sizeof(unsigned int) + sizeof(unsigned short) + (num_colors * sizeof(RGBColor))))
+    {
+        return;
+    }
+
+    ControllerListMutex.lock();
+
+    if(dev_idx < server_controllers.size())
+    {
+        server_controllers[dev_idx]->SetColorDescription((unsigned char *)data);
+
+        /*-------------------------------------------------*\
+        | Notify listeners without sending the colors back  |
+        | to the server                                     |
+        \*-------------------------------------------------*/
+        server_controllers[dev_idx]->SignalUpdate();
+    }
+
+    ControllerListMutex.unlock();
+}
+
+void NetworkClient::ProcessRequest_ColorsUpdatedDelta(unsigned int dev_idx, unsigned int data_size, char * data)
+{
+    unsigned int    data_ptr = sizeof(unsigned int);
+    unsigned short  num_colors;
+    unsigned short  num_changes;
+
+    if(data_size < (sizeof(unsigned int) + (2 * sizeof(unsigned short))))
+    {
+        return;
+    }
+
+    memcpy(&num_colors, &data[data_ptr], sizeof(unsigned short));
+    data_ptr += sizeof(unsigned short);
+
+    memcpy(&num_changes, &data[data_ptr], sizeof(unsigned short));
+    data_ptr += sizeof(unsigned short);
+
+    if(data_size < (data_ptr + (num_changes * (sizeof(unsigned short) + sizeof(RGBColor)))))
+    {
+        return;
+    }
+
+    ControllerListMutex.lock();
+
+    /*-------------------------------------------------*\
+    | Deltas apply to the colors of the last update, so |
+    | ignore one that does not match the device         |
+    \*-------------------------------------------------*/
+    if((dev_idx < server_controllers.size()) && (server_controllers[dev_idx]->colors.size() == num_colors))
+    {
+        RGBController * controller = server_controllers[dev_idx];
+
+        for(unsigned short change_idx = 0; change_idx < num_changes; change_idx++)
+        {
+            unsigned short  led_idx;
+            RGBColor        color;
+
+            memcpy(&led_idx, &data[data_ptr], sizeof(unsigned short));
+            data_ptr += sizeof(unsigned short);
+
+            memcpy(&color, &data[data_ptr], sizeof(RGBColor));
+            data_ptr += sizeof(RGBColor);
+
+            if(led_idx < num_colors)
+            {
+                controller->colors[led_idx] = color;
+            }
+        }
+
+        controller->SignalUpdate();
+    }
+
+    ControllerListMutex.unlock();
+}
+
 void NetworkClient::SendData_ClientString()
 {
     NetPacketHeader reply_hdr;
@@ -623,8 +876,7 @@ void NetworkClient::SendData_ClientString()
     reply_hdr.pkt_id       = NET_PACKET_ID_SET_CLIENT_NAME;
     reply_hdr.pkt_size     = strlen(client_name.c_str()) + 1;
 
-    send(client_sock, (char *)&reply_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)client_name.c_str(), reply_hdr.pkt_size, MSG_NOSIGNAL);
+    SendPacket(&reply_hdr, (char *)client_name.c_str());
 }
 
 void NetworkClient::SendRequest_ControllerCount()
@@ -640,7 +892,7 @@ void NetworkClient::SendRequest_ControllerCount()
     request_hdr.pkt_id       = NET_PACKET_ID_REQUEST_CONTROLLER_COUNT;
     request_hdr.pkt_size     = 0;
 
-    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
+    SendPacket(&request_hdr, NULL);
 }
 
 void NetworkClient::SendRequest_ControllerData(unsigned int dev_idx)
@@ -662,7 +914,7 @@ void NetworkClient::SendRequest_ControllerData(unsigned int dev_idx)
     {
         request_hdr.pkt_size     = 0;
 
-        send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
+        SendPacket(&request_hdr, NULL);
     }
     else
     {
@@ -681,8 +933,7 @@ void NetworkClient::SendRequest_ControllerData(unsigned int dev_idx)
             protocol_version = server_protocol_version;
         }
 
-        send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-        send(client_sock, (char *)&protocol_version, sizeof(unsigned int), MSG_NOSIGNAL);
+        SendPacket(&request_hdr, (char *)&protocol_version);
     }
 }
 
@@ -702,8 +953,72 @@ void NetworkClient::SendRequest_ProtocolVersion()
 
     request_data             = OPENRGB_SDK_PROTOCOL_VERSION;
 
-    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)&request_data, sizeof(unsigned int), MSG_NOSIGNAL);
+    SendPacket(&request_hdr, (char *)&request_data);
+}
+
+void NetworkClient::SendRequest_UDPStream()
+{
+    NetPacketHeader request_hdr;
+
+    request_hdr.pkt_magic[0] = 'O';
+    request_hdr.pkt_magic[1] = 'R';
+    request_hdr.pkt_magic[2] = 'G';
+    request_hdr.pkt_magic[3] = 'B';
+
+    request_hdr.pkt_dev_idx  = 0;
+    request_hdr.pkt_id       = NET_PACKET_ID_REQUEST_UDP_STREAM;
+    request_hdr.pkt_size     = 0;
+
+    SendPacket(&request_hdr, NULL);
+}
+
+void NetworkClient::SendRequest_SubscribeColors(unsigned int dev_idx, unsigned int interval_ms, unsigned int flags)
+{
+    /*-------------------------------------------------*\
+    | Color subscriptions were added in protocol 5      |
+    \*-------------------------------------------------*/
+    if(server_protocol_version < 5)
+    {
+        return;
+    }
+
+    NetPacketHeader request_hdr;
+    unsigned int    request_data[2];
+
+    request_hdr.pkt_magic[0] = 'O';
+    request_hdr.pkt_magic[1] = 'R';
+    request_hdr.pkt_magic[2] = 'G';
+    request_hdr.pkt_magic[3] = 'B';
+
+    request_hdr.pkt_dev_idx  = dev_idx;
+    request_hdr.pkt_id       = NET_PACKET_ID_SUBSCRIBE_COLORS;
+    request_hdr.pkt_size     = sizeof(request_data);
+
+    request_data[0]          = interval_ms;
+    request_data[1]          = flags;
+
+    SendPacket(&request_hdr, (char *)&request_data);
+}
+
+void NetworkClient::SendRequest_UnsubscribeColors(unsigned int dev_idx)
+{
+    if(server_protocol_version < 5)
+    {
+        return;
+    }
+
+    NetPacketHeader request_hdr;
+
+    request_hdr.pkt_magic[0] = 'O';
+    request_hdr.pkt_magic[1] = 'R';
+    request_hdr.pkt_magic[2] = 'G';
+    request_hdr.pkt_magic[3] = 'B';
+
+    request_hdr.pkt_dev_idx  = dev_idx;
+    request_hdr.pkt_id       = NET_PACKET_ID_UNSUBSCRIBE_COLORS;
+    request_hdr.pkt_size     = 0;
+
+    SendPacket(&request_hdr, NULL);
 }
 
 void NetworkClient::SendRequest_RGBController_ResizeZone(unsigned int dev_idx, int zone, int new_size)
@@ -728,8 +1043,7 @@ void NetworkClient::SendRequest_RGBController_ResizeZone(unsigned int dev_idx, i
     request_data[0]          = zone;
     request_data[1]          = new_size;
 
-    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)&request_data, sizeof(request_data), MSG_NOSIGNAL);
+    SendPacket(&request_hdr, (char *)&request_data);
 }
 
 void NetworkClient::SendRequest_RGBController_UpdateLEDs(unsigned int dev_idx, unsigned char * data, unsigned int size)
@@ -739,6 +1053,16 @@ void NetworkClient::SendRequest_RGBController_UpdateLEDs(unsigned int dev_idx, u
         return;
     }
 
+    /*-------------------------------------------------*\
+    | Send frames over the UDP stream when it is active |
+    | and the frame fits in a single datagram           |
+    \*-------------------------------------------------*/
+    if(udp_stream_active && (sizeof(NetStreamHeader) + size) <= OPENRGB_SDK_STREAM_MAX_DATAGRAM)
+    {
+        SendStream_RGBController_UpdateLEDs(dev_idx, data, size);
+        return;
+    }
+
     NetPacketHeader request_hdr;
 
     request_hdr.pkt_magic[0] = 'O';
@@ -750,8 +1074,41 @@ void NetworkClient::SendRequest_RGBController_UpdateLEDs(unsigned int dev_idx, u
     request_hdr.pkt_id       = NET_PACKET_ID_RGBCONTROLLER_UPDATELEDS;
     request_hdr.pkt_size     = size;
 
-    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)data, size, 0);
+    SendPacket(&request_hdr, (char *)data);
+}
+
+void NetworkClient::SendStream_RGBController_UpdateLEDs(unsigned int dev_idx, unsigned char * data, unsigned int size)
+{
+    std::vector<char>   datagram(sizeof(NetStreamHeader) + size);
+    NetStreamHeader     stream_hdr;
+
+    stream_hdr.pkt_magic[0] = 'O';
+    stream_hdr.pkt_magic[1] = 'R';
+    stream_hdr.pkt_magic[2] = 'G';
+    stream_hdr.pkt_magic[3] = 'U';
+
+    stream_hdr.stream_id    = udp_stream_id;
+    stream_hdr.pkt_dev_idx  = dev_idx;
+    stream_hdr.timestamp_us = (unsigned int)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    UDPStreamMutex.lock();
+
+    if(udp_stream_active)
+    {
+        if(dev_idx >= udp_stream_sequence.size())
+        {
+            udp_stream_sequence.resize(dev_idx + 1, 0);
+        }
+
+        stream_hdr.sequence = ++udp_stream_sequence[dev_idx];
+
+        memcpy(&datagram[0], &stream_hdr, sizeof(NetStreamHeader));
+        memcpy(&datagram[sizeof(NetStreamHeader)], data, size);
+
+        udp_stream.udp_write(&datagram[0], datagram.size());
+    }
+
+    UDPStreamMutex.unlock();
 }
 
 void NetworkClient::SendRequest_RGBController_UpdateZoneLEDs(unsigned int dev_idx, unsigned char * data, unsigned int size)
@@ -772,8 +1129,7 @@ void NetworkClient::SendRequest_RGBController_UpdateZoneLEDs(unsigned int dev_id
     request_hdr.pkt_id       = NET_PACKET_ID_RGBCONTROLLER_UPDATEZONELEDS;
     request_hdr.pkt_size     = size;
 
-    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)data, size, MSG_NOSIGNAL);
+    SendPacket(&request_hdr, (char *)data);
 }
 
 void NetworkClient::SendRequest_RGBController_UpdateSingleLED(unsigned int dev_idx, unsigned char * data, unsigned int size)
@@ -794,8 +1150,7 @@ void NetworkClient::SendRequest_RGBController_UpdateSingleLED(unsigned int dev_i
     request_hdr.pkt_id       = NET_PACKET_ID_RGBCONTROLLER_UPDATESINGLELED;
     request_hdr.pkt_size     = size;
 
-    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)data, size, MSG_NOSIGNAL);
+    SendPacket(&request_hdr, (char *)data);
 }
 
 void NetworkClient::SendRequest_RGBController_SetCustomMode(unsigned int dev_idx)
@@ -816,7 +1171,7 @@ void NetworkClient::SendRequest_RGBController_SetCustomMode(unsigned int dev_idx
     request_hdr.pkt_id       = NET_PACKET_ID_RGBCONTROLLER_SETCUSTOMMODE;
     request_hdr.pkt_size     = 0;
 
-    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
+    SendPacket(&request_hdr, NULL);
 }
 
 void NetworkClient::SendRequest_RGBController_UpdateMode(unsigned int dev_idx, unsigned char * data, unsigned int size)
@@ -837,8 +1192,7 @@ void NetworkClient::SendRequest_RGBController_UpdateMode(unsigned int dev_idx, u
     request_hdr.pkt_id       = NET_PACKET_ID_RGBCONTROLLER_UPDATEMODE;
     request_hdr.pkt_size     = size;
 
-    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)data, size, MSG_NOSIGNAL);
+    SendPacket(&request_hdr, (char *)data);
 }
 
 void NetworkClient::SendRequest_RGBController_SaveMode(unsigned int dev_idx, unsigned char * data, unsigned int size)
@@ -859,8 +1213,7 @@ void NetworkClient::SendRequest_RGBController_SaveMode(unsigned int dev_idx, uns
     request_hdr.pkt_id       = NET_PACKET_ID_RGBCONTROLLER_SAVEMODE;
     request_hdr.pkt_size     = size;
 
-    send(client_sock, (char *)&request_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)data, size, MSG_NOSIGNAL);
+    SendPacket(&request_hdr, (char *)data);
 }
 
 void NetworkClient::SendRequest_LoadProfile(std::string profile_name)
@@ -876,8 +1229,7 @@ void NetworkClient::SendRequest_LoadProfile(std::string profile_name)
     reply_hdr.pkt_id       = NET_PACKET_ID_REQUEST_LOAD_PROFILE;
     reply_hdr.pkt_size     = strlen(profile_name.c_str()) + 1;
 
-    send(client_sock, (char *)&reply_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)profile_name.c_str(), reply_hdr.pkt_size, MSG_NOSIGNAL);
+    SendPacket(&reply_hdr, (char *)profile_name.c_str());
 }
 
 void NetworkClient::SendRequest_SaveProfile(std::string profile_name)
@@ -893,8 +1245,7 @@ void NetworkClient::SendRequest_SaveProfile(std::string profile_name)
     reply_hdr.pkt_id       = NET_PACKET_ID_REQUEST_SAVE_PROFILE;
     reply_hdr.pkt_size     = strlen(profile_name.c_str()) + 1;
 
-    send(client_sock, (char *)&reply_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)profile_name.c_str(), reply_hdr.pkt_size, MSG_NOSIGNAL);
+    SendPacket(&reply_hdr, (char *)profile_name.c_str());
 }
 
 void NetworkClient::SendRequest_DeleteProfile(std::string profile_name)
@@ -910,8 +1261,7 @@ void NetworkClient::SendRequest_DeleteProfile(std::string profile_name)
     reply_hdr.pkt_id       = NET_PACKET_ID_REQUEST_DELETE_PROFILE;
     reply_hdr.pkt_size     = strlen(profile_name.c_str()) + 1;
 
-    send(client_sock, (char *)&reply_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
-    send(client_sock, (char *)profile_name.c_str(), reply_hdr.pkt_size, MSG_NOSIGNAL);
+    SendPacket(&reply_hdr, (char *)profile_name.c_str());
 }
 
 void NetworkClient::SendRequest_GetProfileList()
@@ -927,7 +1277,7 @@ void NetworkClient::SendRequest_GetProfileList()
     reply_hdr.pkt_id       = NET_PACKET_ID_REQUEST_PROFILE_LIST;
     reply_hdr.pkt_size     = 0;
 
-    send(client_sock, (char *)&reply_hdr, sizeof(NetPacketHeader), MSG_NOSIGNAL);
+    SendPacket(&reply_hdr, NULL);
 }
 
 std::vector<std::string> * NetworkClient::ProcessReply_ProfileList(unsigned int data_size, char * data)
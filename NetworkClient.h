@@ -30,6 +30,7 @@ public:
     unsigned short  GetPort();
     unsigned int    GetProtocolVersion();
     bool            GetOnline();
+    bool            GetUDPStreamActive();
 
     void            ClearCallbacks();
     void            RegisterClientInfoChangeCallback(NetClientCallback new_callback, void * new_callback_arg);
@@ -37,6 +38,8 @@ public:
     void            SetIP(std::string new_ip);
     void            SetName(std::string new_name);
     void            SetPort(unsigned short new_port);
+    void            SetUnixSocketPath(std::string new_path);
+    void            SetUDPStream(bool enable);
 
     void            StartClient();
     void            StopClient();
@@ -49,18 +52,26 @@ public:
     void        ProcessReply_ControllerCount(unsigned int data_size, char * data);
     void        ProcessReply_ControllerData(unsigned int data_size, char * data, unsigned int dev_idx);
     void        ProcessReply_ProtocolVersion(unsigned int data_size, char * data);
+    void        ProcessReply_UDPStream(unsigned int data_size, char * data);
 
     void        ProcessRequest_DeviceListChanged();
+    void        ProcessRequest_ColorsUpdated(unsigned int dev_idx, unsigned int data_size, char * data);
+    void        ProcessRequest_ColorsUpdatedDelta(unsigned int dev_idx, unsigned int data_size, char * data);
 
     void        SendData_ClientString();
 
     void        SendRequest_ControllerCount();
     void        SendRequest_ControllerData(unsigned int dev_idx);
     void        SendRequest_ProtocolVersion();
+    void        SendRequest_UDPStream();
+
+    void        SendRequest_SubscribeColors(unsigned int dev_idx, unsigned int interval_ms, unsigned int flags);
+    void        SendRequest_UnsubscribeColors(unsigned int dev_idx);
 
     void        SendRequest_RGBController_ResizeZone(unsigned int dev_idx, int zone, int new_size);
 
     void        SendRequest_RGBController_UpdateLEDs(unsigned int dev_idx, unsigned char * data, unsigned int size);
+    void        SendStream_RGBController_UpdateLEDs(unsigned int dev_idx, unsigned char * data, unsigned int size);
     void        SendRequest_RGBController_UpdateZoneLEDs(unsigned int dev_idx, unsigned char * data, unsigned int size);
     void        SendRequest_RGBController_UpdateSingleLED(unsigned int dev_idx, unsigned char * data, unsigned int size);
 
@@ -89,8 +100,10 @@ private:
     SOCKET          client_sock;
     std::string     client_name;
     net_port        port;
+    net_port_writer writer;
     std::string     port_ip;
     unsigned short  port_num;
+    std::string     unix_socket_path;
     bool            client_active;
     bool            controller_data_received;
     bool            server_connected;
@@ -101,6 +114,15 @@ private:
     bool            server_protocol_version_received;
     bool            change_in_progress;
 
+    bool                        udp_stream_enabled;
+    bool                        udp_stream_active;
+    bool                        udp_stream_reply_received;
+    unsigned int                udp_stream_id;
+    unsigned int                udp_stream_port;
+    net_port                    udp_stream;
+    std::vector<unsigned int>   udp_stream_sequence;
+    std::mutex                  UDPStreamMutex;
+
     std::thread *   ConnectionThread;
     std::thread *   ListenThread;
 
@@ -108,5 +130,10 @@ private:
     std::vector<NetClientCallback>      ClientInfoChangeCallbacks;
     std::vector<void *>                 ClientInfoChangeCallbackArgs;
 
+    void SendPacket(NetPacketHeader * header, const char * data);
+
+    void StartUDPStream();
+    void StopUDPStream();
+
     int recv_select(SOCKET s, char *buf, int len, int flags);
 };
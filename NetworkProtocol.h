@@ -16,8 +16,9 @@
 |   2:      Add profile controls (Release 0.6)                          |
 |   3:      Add brightness field to modes (Release 0.7)                 |
 |   4:      Add segments field to zones, network plugins (Release 0.9)  |
+|   5:      Add UDP color streaming, color subscriptions                |
 \*---------------------------------------------------------------------*/
-#define OPENRGB_SDK_PROTOCOL_VERSION    4
+#define OPENRGB_SDK_PROTOCOL_VERSION    5
 
 /*-----------------------------------------------------*\
 | Default Interface to bind to.                         |
@@ -38,6 +39,50 @@ typedef struct NetPacketHeader
     unsigned int        pkt_size;                   /* Packet size                                          */
 } NetPacketHeader;
 
+/*-----------------------------------------------------*\
+| Largest UDP stream datagram, header included          |
+\*-----------------------------------------------------*/
+#define OPENRGB_SDK_STREAM_MAX_DATAGRAM 65507
+
+/*-----------------------------------------------------*\
+| UDP stream datagrams carry this header followed by    |
+| the same color description as an UpdateLEDs packet.   |
+| The stream ID is assigned by the server when the      |
+| stream is requested over the TCP session.  Sequence   |
+| numbers count up per device, and frames that arrive   |
+| with a sequence number at or below the last one seen  |
+| for that device are dropped                           |
+\*-----------------------------------------------------*/
+typedef struct NetStreamHeader
+{
+    char                pkt_magic[4];               /* Magic value "ORGU" identifies a stream datagram      */
+    unsigned int        stream_id;                  /* Stream ID assigned by the server                     */
+    unsigned int        pkt_dev_idx;                /* Device index                                         */
+    unsigned int        sequence;                   /* Per-device frame sequence number                     */
+    unsigned int        timestamp_us;               /* Sender timestamp in microseconds, used for jitter    */
+} NetStreamHeader;
+
+/*-----------------------------------------------------*\
+| Color subscriptions                                   |
+|                                                       |
+| SUBSCRIBE_COLORS carries the minimum interval between |
+| pushes in milliseconds and a flags word.  Each time   |
+| the device's colors change, and at most once per      |
+| interval, the server pushes either:                   |
+|                                                       |
+|   COLORS_UPDATED:       the same color description    |
+|                         as an UpdateLEDs packet       |
+|   COLORS_UPDATED_DELTA: u32 data size, u16 color      |
+|                         count, u16 change count, then |
+|                         a u16 LED index and RGBColor  |
+|                         for each change               |
+|                                                       |
+| Deltas are only sent with NET_SUBSCRIBE_FLAG_DELTA,   |
+| after a full update, and when they are smaller.       |
+| Subscriptions end when the device list changes        |
+\*-----------------------------------------------------*/
+#define NET_SUBSCRIBE_FLAG_DELTA        (1 << 0)
+
 enum
 {
     /*----------------------------------------------------------------------------------------------------------*\
@@ -50,7 +95,14 @@ enum
 
     NET_PACKET_ID_SET_CLIENT_NAME               = 50,   /* Send client name string to server                    */
 
+    NET_PACKET_ID_REQUEST_UDP_STREAM            = 60,   /* Request a UDP color stream ID and port from server   */
+
+    NET_PACKET_ID_SUBSCRIBE_COLORS              = 70,   /* Subscribe to color updates of a device               */
+    NET_PACKET_ID_UNSUBSCRIBE_COLORS            = 71,   /* Unsubscribe from color updates of a device           */
+
     NET_PACKET_ID_DEVICE_LIST_UPDATED           = 100,  /* Indicate to clients that device list has updated     */
+    NET_PACKET_ID_COLORS_UPDATED                = 101,  /* Push all colors of a subscribed device               */
+    NET_PACKET_ID_COLORS_UPDATED_DELTA          = 102,  /* Push changed colors of a subscribed device           */
 
     NET_PACKET_ID_REQUEST_PROFILE_LIST          = 150,  /* Request profile list                                 */
     NET_PACKET_ID_REQUEST_SAVE_PROFILE          = 151,  /* Save current configuration in a new profile          */
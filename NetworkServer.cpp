@@ -14,6 +14,7 @@
 #include <sys/ioctl.h>
 #include <netinet/tcp.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <arpa/inet.h>
 #else
 #include <ws2tcpip.h>
@@ -22,8 +23,9 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <iostream>
+#include <random>
 
-const char yes = 1;
+const int yes = 1;
 
 #ifdef WIN32
 #include <Windows.h>
@@ -33,6 +35,28 @@ const char yes = 1;
 
 using namespace std::chrono_literals;
 
+static void WakeSubscriptionThread(NetworkClientInfo * client_info)
+{
+    std::lock_guard<std::mutex> lock(client_info->subscription_wake_mutex);
+
+    client_info->subscription_wake = true;
+    client_info->subscription_wake_cv.notify_one();
+}
+
+/*-----------------------------------------------------*\
+| Called from the update dispatcher when a subscribed   |
+| device changes.  Only flags the subscription, the     |
+| client's subscription thread does the sending         |
+\*-----------------------------------------------------*/
+static void NetworkServerColorsChangedCallback(void * this_ptr)
+{
+    NetworkColorSubscription * subscription = (NetworkColorSubscription *)this_ptr;
+
+    subscription->dirty = true;
+
+    WakeSubscriptionThread(subscription->client_info);
+}
+
 NetworkClientInfo::NetworkClientInfo()
 {
     client_string           = "Client";
@@ -40,15 +64,33 @@ NetworkClientInfo::NetworkClientInfo()
     client_sock             = INVALID_SOCKET;
     client_listen_thread    = nullptr;
     client_protocol_version = 0;
+    stream_id               = 0;
+    stream_stats            = {};
+    subscription_thread     = nullptr;
+    subscription_thread_running = false;
+    subscription_wake       = false;
+    client_writer           = std::make_shared<net_port_writer>();
 }
 
 NetworkClientInfo::~NetworkClientInfo()
 {
     if(client_sock != INVALID_SOCKET)
     {
+        if(stream_id != 0)
+        {
+            LOG_INFO("UDP stream from %s closed: %u received, %u lost, %u stale, %.0f us jitter", client_ip.c_str(), stream_stats.frames_received, stream_stats.frames_lost, stream_stats.frames_stale, stream_stats.jitter_us);
+        }
+
         LOG_INFO("Closing server connection: %s", client_ip.c_str());
         delete client_listen_thread;
-        shutdown(client_sock, SD_RECEIVE);
+
+        /*-------------------------------------------------*\
+        | Shut down both directions to abort a blocked      |
+        | write, then wait for any write in progress before |
+        | the socket is closed and its number reused        |
+        \*-------------------------------------------------*/
+        shutdown(client_sock, SD_BOTH);
+        client_writer->set_socket(INVALID_SOCKET);
         closesocket(client_sock);
     }
 }
@@ -59,6 +101,10 @@ NetworkServer::NetworkServer(std::vector<RGBController *>& control) : controller
     port_num         = OPENRGB_SDK_PORT;
     server_online    = false;
     server_listening = false;
+    unix_socket_bound = false;
+    udp_stream_enabled = false;
+    stream_sock      = INVALID_SOCKET;
+    StreamThread     = nullptr;
     for(int i = 0; i < MAXSOCK; i++)
     {
         ConnectionThread[i] = nullptr;
@@ -88,13 +134,29 @@ void NetworkServer::ClientInfoChanged()
 
 void NetworkServer::DeviceListChanged()
 {
+    /*-------------------------------------------------*\
+    | Device indices may have changed, end all color    |
+    | subscriptions                                     |
+    \*-------------------------------------------------*/
+    std::vector<SOCKET> client_socks;
+
+    ServerClientsMutex.lock();
+
+    for(unsigned int client_idx = 0; client_idx < ServerClients.size(); client_idx++)
+    {
+        ClearSubscriptions(ServerClients[client_idx]);
+        client_socks.push_back(ServerClients[client_idx]->client_sock);
+    }
+
+    ServerClientsMutex.unlock();
+
     /*-------------------------------------------------*\
     | Indicate to the clients that the controller list  |
     | has changed                                       |
     \*-------------------------------------------------*/
-    for(unsigned int client_idx = 0; client_idx < ServerClients.size(); client_idx++)
+    for(unsigned int client_idx = 0; client_idx < client_socks.size(); client_idx++)
     {
-        SendRequest_DeviceListChanged(ServerClients[client_idx]->client_sock);
+        SendRequest_DeviceListChanged(client_socks[client_idx]);
     }
 }
 
@@ -123,6 +185,11 @@ unsigned short NetworkServer::GetPort()
     return port_num;
 }
 
+std::string NetworkServer::GetUnixSocketPath()
+{
+    return unix_socket_path;
+}
+
 bool NetworkServer::GetOnline()
 {
     return server_online;
@@ -198,6 +265,28 @@ unsigned int NetworkServer::GetClientProtocolVersion(unsigned int client_num)
     return result;
 }
 
+bool NetworkServer::GetClientStreamStats(unsigned int client_num, NetworkStreamStats * stats)
+{
+    bool result = false;
+
+    ServerClientsMutex.lock();
+
+    if(client_num < ServerClients.size() && ServerClients[client_num]->stream_id != 0)
+    {
+        *stats = ServerClients[client_num]->stream_stats;
+        result = true;
+    }
+
+    ServerClientsMutex.unlock();
+
+    return result;
+}
+
+bool NetworkServer::GetUDPStreamEnabled()
+{
+    return udp_stream_enabled;
+}
+
 void NetworkServer::RegisterClientInfoChangeCallback(NetServerCallback new_callback, void * new_callback_arg)
 {
     ClientInfoChangeCallbacks.push_back(new_callback);
@@ -226,6 +315,22 @@ void NetworkServer::SetPort(unsigned short new_port)
     }
 }
 
+void NetworkServer::SetUnixSocketPath(std::string new_path)
+{
+    if(server_online == false)
+    {
+        unix_socket_path = new_path;
+    }
+}
+
+void NetworkServer::SetUDPStreamEnabled(bool enabled)
+{
+    if(server_online == false)
+    {
+        udp_stream_enabled = enabled;
+    }
+}
+
 void NetworkServer::StartServer()
 {
     int err;
@@ -313,12 +418,24 @@ void NetworkServer::StartServer()
         /*-------------------------------------------------*\
         | Set socket options - no delay                     |
         \*-------------------------------------------------*/
-        setsockopt(server_sock[socket_count], IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        setsockopt(server_sock[socket_count], IPPROTO_TCP, TCP_NODELAY, (const char *)&yes, sizeof(yes));
 
         socket_count += 1;
     }
 
     freeaddrinfo(result);
+
+    /*-------------------------------------------------*\
+    | Also listen on a Unix domain socket for clients   |
+    | on the same host, if a path is set                |
+    \*-------------------------------------------------*/
+    StartUnixSocket();
+
+    /*-------------------------------------------------*\
+    | Open the UDP color stream socket, if enabled      |
+    \*-------------------------------------------------*/
+    StartStreamSocket();
+
     server_online = true;
     
     /*-------------------------------------------------*\
@@ -329,6 +446,143 @@ void NetworkServer::StartServer()
         ConnectionThread[curr_socket] = new std::thread(&NetworkServer::ConnectionThreadFunction, this, curr_socket);
         ConnectionThread[curr_socket]->detach();
     }
+
+    /*-------------------------------------------------*\
+    | Start the stream thread                           |
+    \*-------------------------------------------------*/
+    if(stream_sock != INVALID_SOCKET)
+    {
+        StreamThread = new std::thread(&NetworkServer::StreamThreadFunction, this);
+    }
+}
+
+void NetworkServer::StartUnixSocket()
+{
+    if(unix_socket_path == "" || socket_count >= MAXSOCK)
+    {
+        return;
+    }
+
+#ifdef WIN32
+    printf("Error: Unix domain sockets are not supported on this platform\n");
+#else
+    sockaddr_un addr = {};
+
+    if(unix_socket_path.size() >= sizeof(addr.sun_path))
+    {
+        printf("Error: Unix socket path is too long: %s\n", unix_socket_path.c_str());
+        return;
+    }
+
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, unix_socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    SOCKET unix_sock = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if(unix_sock == INVALID_SOCKET)
+    {
+        printf("Error: Unix socket could not be created\n");
+        return;
+    }
+
+    /*-------------------------------------------------*\
+    | Remove a socket file left behind by a previous    |
+    | server that did not shut down cleanly.  Only a    |
+    | socket that refuses connections is stale, leave   |
+    | anything else at the path alone                   |
+    \*-------------------------------------------------*/
+    struct stat path_stat;
+
+    if(lstat(unix_socket_path.c_str(), &path_stat) == 0)
+    {
+        if(!S_ISSOCK(path_stat.st_mode))
+        {
+            printf("Error: Unix socket path %s exists and is not a socket\n", unix_socket_path.c_str());
+            closesocket(unix_sock);
+            return;
+        }
+
+        SOCKET probe_sock   = socket(AF_UNIX, SOCK_STREAM, 0);
+        int    probe_ret    = connect(probe_sock, (sockaddr *)&addr, sizeof(addr));
+        int    probe_errno  = errno;
+
+        closesocket(probe_sock);
+
+        if((probe_ret == SOCKET_ERROR) && (probe_errno == ECONNREFUSED))
+        {
+            unlink(unix_socket_path.c_str());
+        }
+        else
+        {
+            printf("Error: Unix socket %s is in use by another server\n", unix_socket_path.c_str());
+            closesocket(unix_sock);
+            return;
+        }
+    }
+
+    if(bind(unix_sock, (sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR)
+    {
+        printf("Error: Could not bind Unix socket %s, error code:%d\n", unix_socket_path.c_str(), errno);
+        closesocket(unix_sock);
+        return;
+    }
+
+    server_sock[socket_count] = unix_sock;
+    socket_count             += 1;
+    unix_socket_bound         = true;
+#endif
+}
+
+void NetworkServer::StartStreamSocket()
+{
+    if(udp_stream_enabled == false)
+    {
+        return;
+    }
+
+    struct addrinfo hints, *result;
+    char port_str[6];
+    snprintf(port_str, 6, "%d", port_num);
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_PASSIVE;
+
+    if(getaddrinfo(host.c_str(), port_str, &hints, &result))
+    {
+        printf("Error: Unable to get UDP stream address.\n");
+        return;
+    }
+
+    /*-------------------------------------------------*\
+    | The stream socket uses the same port number as    |
+    | the TCP server, on the first address returned     |
+    \*-------------------------------------------------*/
+    stream_sock = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+
+    if(stream_sock == INVALID_SOCKET)
+    {
+        printf("Error: UDP stream socket could not be created\n");
+    }
+    else if(bind(stream_sock, result->ai_addr, result->ai_addrlen) == SOCKET_ERROR)
+    {
+        printf("Error: Could not bind UDP stream socket on port %hu, error code:%d\n", port_num, errno);
+        closesocket(stream_sock);
+        stream_sock = INVALID_SOCKET;
+    }
+    else
+    {
+        /*-------------------------------------------------*\
+        | Enlarge the receive buffer so bursts of frames    |
+        | from several clients are not dropped by the OS    |
+        \*-------------------------------------------------*/
+        int rcvbuf = 1024 * 1024;
+
+        setsockopt(stream_sock, SOL_SOCKET, SO_RCVBUF, (const char *)&rcvbuf, sizeof(rcvbuf));
+    }
+
+    freeaddrinfo(result);
 }
 
 void NetworkServer::StopServer()
@@ -336,10 +590,28 @@ void NetworkServer::StopServer()
     int curr_socket;
     server_online = false;
 
+    /*-------------------------------------------------*\
+    | The stream thread polls server_online, wait for   |
+    | it to exit before closing its socket              |
+    \*-------------------------------------------------*/
+    if(StreamThread)
+    {
+        StreamThread->join();
+        delete StreamThread;
+        StreamThread = nullptr;
+    }
+
+    if(stream_sock != INVALID_SOCKET)
+    {
+        closesocket(stream_sock);
+        stream_sock = INVALID_SOCKET;
+    }
+
     ServerClientsMutex.lock();
 
     for(unsigned int client_idx = 0; client_idx < ServerClients.size(); client_idx++)
     {
+        StopSubscriptions(ServerClients[client_idx]);
         delete ServerClients[client_idx];
     }
 
@@ -364,6 +636,14 @@ void NetworkServer::StopServer()
 
     socket_count = 0;
 
+#ifndef WIN32
+    if(unix_socket_bound)
+    {
+        unlink(unix_socket_path.c_str());
+        unix_socket_bound = false;
+    }
+#endif
+
     /*-------------------------------------------------*\
     | Client info has changed, call the callbacks       |
     \*-------------------------------------------------*/
@@ -420,7 +700,9 @@ void NetworkServer::ConnectionThreadFunction(int socket_idx)
         \*-------------------------------------------------*/
         u_long arg = 0;
         ioctlsocket(client_info->client_sock, FIONBIO, &arg);
-        setsockopt(client_info->client_sock, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        setsockopt(client_info->client_sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&yes, sizeof(yes));
+
+        client_info->client_writer->set_socket(client_info->client_sock);
 
         /*-------------------------------------------------*\
         | Discover the remote hosts IP                      |
@@ -431,6 +713,13 @@ void NetworkServer::ConnectionThreadFunction(int socket_idx)
         len = sizeof(tmp_addr);
         getpeername(client_info->client_sock, (struct sockaddr*)&tmp_addr, &len);
         
+#ifndef WIN32
+        if(tmp_addr.ss_family == AF_UNIX)
+        {
+            client_info->client_ip = "local";
+        }
+        else
+#endif
         if(tmp_addr.ss_family == AF_INET)
         {
             struct sockaddr_in *s_4 = (struct sockaddr_in *)&tmp_addr;
@@ -466,6 +755,67 @@ void NetworkServer::ConnectionThreadFunction(int socket_idx)
     ServerListeningChanged();
 }
 
+void NetworkServer::StreamThreadFunction()
+{
+    char * data = new char[OPENRGB_SDK_STREAM_MAX_DATAGRAM];
+
+    printf("Network stream thread started on port %hu\n", GetPort());
+
+    while(server_online == true)
+    {
+        fd_set              set;
+        struct timeval      timeout;
+
+        timeout.tv_sec          = 0;
+        timeout.tv_usec         = 100000;
+
+        FD_ZERO(&set);
+        FD_SET(stream_sock, &set);
+
+        int rv = select(stream_sock + 1, &set, NULL, NULL, &timeout);
+
+        if(rv == SOCKET_ERROR)
+        {
+            break;
+        }
+        else if(rv == 0)
+        {
+            continue;
+        }
+
+        /*-------------------------------------------------*\
+        | Receive the datagram and its sender's address     |
+        \*-------------------------------------------------*/
+        struct sockaddr_storage sender_addr;
+        socklen_t               sender_len = sizeof(sender_addr);
+        char                    ipstr[INET6_ADDRSTRLEN];
+
+        int bytes_read = recvfrom(stream_sock, data, OPENRGB_SDK_STREAM_MAX_DATAGRAM, 0, (struct sockaddr*)&sender_addr, &sender_len);
+
+        if(bytes_read <= 0)
+        {
+            continue;
+        }
+
+        if(sender_addr.ss_family == AF_INET)
+        {
+            struct sockaddr_in *s_4 = (struct sockaddr_in *)&sender_addr;
+            inet_ntop(AF_INET, &s_4->sin_addr, ipstr, sizeof(ipstr));
+        }
+        else
+        {
+            struct sockaddr_in6 *s_6 = (struct sockaddr_in6 *)&sender_addr;
+            inet_ntop(AF_INET6, &s_6->sin6_addr, ipstr, sizeof(ipstr));
+        }
+
+        ProcessStream_Datagram(data, bytes_read, ipstr);
+    }
+
+    delete[] data;
+
+    printf("Network stream thread closed\r\n");
+}
+
 int NetworkServer::accept_select(int sockfd)
 {
     fd_set              set;
@@ -528,6 +878,39 @@ int NetworkServer::recv_select(SOCKET s, char *buf, int len, int flags)
     }
 }
 
+bool NetworkServer::send_select(NetworkClientInfo * client_info)
+{
+    fd_set              set;
+    struct timeval      timeout;
+
+    /*-------------------------------------------------*\
+    | Wait for room in the socket's send buffer so that |
+    | a client that stopped reading cannot keep its     |
+    | subscription thread from stopping                 |
+    \*-------------------------------------------------*/
+    while(client_info->subscription_thread_running)
+    {
+        timeout.tv_sec          = 0;
+        timeout.tv_usec         = 100000;
+
+        FD_ZERO(&set);
+        FD_SET(client_info->client_sock, &set);
+
+        int rv = select(client_info->client_sock + 1, NULL, &set, NULL, &timeout);
+
+        if(rv == SOCKET_ERROR)
+        {
+            return false;
+        }
+        else if(rv > 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
 {
     SOCKET client_sock = client_info->client_sock;
@@ -669,6 +1052,18 @@ void NetworkServer::ListenThreadFunction(NetworkClientInfo * client_info)
                 ProcessRequest_ClientString(client_sock, header.pkt_size, data);
                 break;
 
+            case NET_PACKET_ID_REQUEST_UDP_STREAM:
+                ProcessRequest_UDPStream(client_info);
+                break;
+
+            case NET_PACKET_ID_SUBSCRIBE_COLORS:
+                ProcessRequest_SubscribeColors(client_info, header.pkt_dev_idx, header.pkt_size, data);
+                break;
+
+            case NET_PACKET_ID_UNSUBSCRIBE_COLORS:
+                ProcessRequest_UnsubscribeColors(client_info, header.pkt_dev_idx);
+                break;
+
             case NET_PACKET_ID_RGBCONTROLLER_RESIZEZONE:
                 if(data == NULL)
                 {
@@ -850,6 +1245,7 @@ listen_done:
     {
         if(ServerClients[this_idx] == client_info)
         {
+            StopSubscriptions(client_info);
             delete client_info;
             ServerClients.erase(ServerClients.begin() + this_idx);
             break;
@@ -916,6 +1312,505 @@ void NetworkServer::ProcessRequest_ClientString(SOCKET client_sock, unsigned int
     ClientInfoChanged();
 }
 
+void NetworkServer::ProcessRequest_UDPStream(NetworkClientInfo * client_info)
+{
+    static std::random_device   stream_id_source;
+    unsigned int                stream_id   = 0;
+    unsigned int                stream_port = 0;
+
+    /*-------------------------------------------------*\
+    | Assign a random, nonzero stream ID that datagrams |
+    | must carry.  Clients on a Unix domain socket are  |
+    | always refused, reply with ID 0 to let the client |
+    | stay on TCP                                       |
+    \*-------------------------------------------------*/
+    if(stream_sock != INVALID_SOCKET && client_info->client_ip != "local")
+    {
+        ServerClientsMutex.lock();
+
+        if(client_info->stream_id == 0)
+        {
+            while(client_info->stream_id == 0)
+            {
+                client_info->stream_id = stream_id_source();
+            }
+
+            client_info->stream_stats = {};
+            client_info->stream_devices.clear();
+
+            LOG_INFO("UDP stream opened for %s", client_info->client_ip.c_str());
+        }
+
+        stream_id   = client_info->stream_id;
+        stream_port = port_num;
+
+        ServerClientsMutex.unlock();
+    }
+
+    SendReply_UDPStream(client_info->client_sock, stream_id, stream_port);
+
+    /*-------------------------------------------------*\
+    | Client info has changed, call the callbacks       |
+    \*-------------------------------------------------*/
+    ClientInfoChanged();
+}
+
+void NetworkServer::ProcessRequest_SubscribeColors(NetworkClientInfo * client_info, unsigned int dev_idx, unsigned int data_size, char * data)
+{
+    unsigned int interval_ms;
+    unsigned int flags;
+
+    if((dev_idx >= controllers.size()) || (data == NULL) || (data_size < (2 * sizeof(unsigned int))))
+    {
+        return;
+    }
+
+    memcpy(&interval_ms, data, sizeof(unsigned int));
+    memcpy(&flags, data + sizeof(unsigned int), sizeof(unsigned int));
+
+    if(interval_ms < NETWORK_SUBSCRIPTION_MIN_INTERVAL_MS)
+    {
+        interval_ms = NETWORK_SUBSCRIPTION_MIN_INTERVAL_MS;
+    }
+
+    client_info->subscription_mutex.lock();
+
+    /*-------------------------------------------------*\
+    | Subscribing again to the same device updates the  |
+    | interval and flags and resends all colors         |
+    \*-------------------------------------------------*/
+    NetworkColorSubscription * subscription = nullptr;
+
+    for(std::size_t subscription_idx = 0; subscription_idx < client_info->subscriptions.size(); subscription_idx++)
+    {
+        if(client_info->subscriptions[subscription_idx]->dev_idx == dev_idx)
+        {
+            subscription = client_info->subscriptions[subscription_idx];
+            break;
+        }
+    }
+
+    if(subscription == nullptr)
+    {
+        subscription = new NetworkColorSubscription();
+
+        subscription->client_info   = client_info;
+        subscription->dev_idx       = dev_idx;
+        subscription->controller    = controllers[dev_idx];
+
+        client_info->subscriptions.push_back(subscription);
+
+        subscription->controller->RegisterUpdateCallback(NetworkServerColorsChangedCallback, subscription);
+    }
+
+    subscription->flags     = flags;
+    subscription->interval  = std::chrono::milliseconds(interval_ms);
+    subscription->last_push = std::chrono::steady_clock::time_point();
+    subscription->last_colors.clear();
+    subscription->dirty     = true;
+
+    /*-------------------------------------------------*\
+    | Start this client's subscription thread on its    |
+    | first subscription                                |
+    \*-------------------------------------------------*/
+    if(client_info->subscription_thread == nullptr)
+    {
+        client_info->subscription_thread_running = true;
+        client_info->subscription_thread         = new std::thread(&NetworkServer::SubscriptionThreadFunction, this, client_info);
+    }
+
+    client_info->subscription_mutex.unlock();
+
+    WakeSubscriptionThread(client_info);
+}
+
+void NetworkServer::ProcessRequest_UnsubscribeColors(NetworkClientInfo * client_info, unsigned int dev_idx)
+{
+    client_info->subscription_mutex.lock();
+
+    for(std::size_t subscription_idx = 0; subscription_idx < client_info->subscriptions.size(); subscription_idx++)
+    {
+        NetworkColorSubscription * subscription = client_info->subscriptions[subscription_idx];
+
+        if(subscription->dev_idx == dev_idx)
+        {
+            subscription->controller->UnregisterUpdateCallback(subscription);
+
+            client_info->subscriptions.erase(client_info->subscriptions.begin() + subscription_idx);
+            delete subscription;
+            break;
+        }
+    }
+
+    client_info->subscription_mutex.unlock();
+}
+
+void NetworkServer::ClearSubscriptions(NetworkClientInfo * client_info)
+{
+    client_info->subscription_mutex.lock();
+
+    for(std::size_t subscription_idx = 0; subscription_idx < client_info->subscriptions.size(); subscription_idx++)
+    {
+        NetworkColorSubscription * subscription = client_info->subscriptions[subscription_idx];
+
+        subscription->controller->UnregisterUpdateCallback(subscription);
+        delete subscription;
+    }
+
+    client_info->subscriptions.clear();
+
+    client_info->subscription_mutex.unlock();
+}
+
+void NetworkServer::StopSubscriptions(NetworkClientInfo * client_info)
+{
+    ClearSubscriptions(client_info);
+
+    if(client_info->subscription_thread != nullptr)
+    {
+        client_info->subscription_wake_mutex.lock();
+        client_info->subscription_thread_running = false;
+        client_info->subscription_wake_cv.notify_one();
+        client_info->subscription_wake_mutex.unlock();
+
+        client_info->subscription_thread->join();
+        delete client_info->subscription_thread;
+        client_info->subscription_thread = nullptr;
+    }
+}
+
+void NetworkServer::SubscriptionThreadFunction(NetworkClientInfo * client_info)
+{
+    std::chrono::steady_clock::time_point next_push = std::chrono::steady_clock::now() + 1s;
+
+    while(true)
+    {
+        /*-------------------------------------------------*\
+        | Wait for a color change, or for the interval of   |
+        | a rate limited subscription to run out            |
+        \*-------------------------------------------------*/
+        {
+            std::unique_lock<std::mutex> wake_lock(client_info->subscription_wake_mutex);
+
+            client_info->subscription_wake_cv.wait_until(wake_lock, next_push, [client_info]{ return(client_info->subscription_wake || !client_info->subscription_thread_running); });
+
+            if(!client_info->subscription_thread_running)
+            {
+                break;
+            }
+
+            client_info->subscription_wake = false;
+        }
+
+        /*-------------------------------------------------*\
+        | Build an update for each changed device whose     |
+        | interval has passed.  Devices changed within      |
+        | their interval are sent once it runs out, with    |
+        | the colors they have by then                      |
+        \*-------------------------------------------------*/
+        std::chrono::steady_clock::time_point   now = std::chrono::steady_clock::now();
+        std::vector<NetPacketHeader>            update_headers;
+        std::vector<std::vector<unsigned char>> update_data;
+
+        next_push = now + 1s;
+
+        client_info->subscription_mutex.lock();
+
+        for(std::size_t subscription_idx = 0; subscription_idx < client_info->subscriptions.size(); subscription_idx++)
+        {
+            NetworkColorSubscription * subscription = client_info->subscriptions[subscription_idx];
+
+            if(!subscription->dirty)
+            {
+                continue;
+            }
+
+            if(now < (subscription->last_push + subscription->interval))
+            {
+                next_push = std::min(next_push, subscription->last_push + subscription->interval);
+                continue;
+            }
+
+            subscription->dirty = false;
+
+            if((subscription->dev_idx >= controllers.size()) || (controllers[subscription->dev_idx] != subscription->controller))
+            {
+                continue;
+            }
+
+            NetPacketHeader             header;
+            std::vector<unsigned char>  data;
+
+            if(BuildColorUpdate(subscription, &header, &data))
+            {
+                subscription->last_push = now;
+
+                update_headers.push_back(header);
+                update_data.push_back(std::move(data));
+            }
+        }
+
+        client_info->subscription_mutex.unlock();
+
+        /*-------------------------------------------------*\
+        | Send the updates.  A slow client only holds up    |
+        | its own subscription thread, and the changes made |
+        | meanwhile are merged into its next update         |
+        \*-------------------------------------------------*/
+        for(std::size_t update_idx = 0; update_idx < update_headers.size(); update_idx++)
+        {
+            if(!send_select(client_info))
+            {
+                break;
+            }
+
+            net_port_buffer buffers[2];
+
+            buffers[0].buffer = (const char *)&update_headers[update_idx];
+            buffers[0].length = sizeof(NetPacketHeader);
+            buffers[1].buffer = (const char *)update_data[update_idx].data();
+            buffers[1].length = update_data[update_idx].size();
+
+            client_info->client_writer->write(buffers, 2);
+        }
+    }
+}
+
+bool NetworkServer::BuildColorUpdate(NetworkColorSubscription * subscription, NetPacketHeader * header, std::vector<unsigned char> * data)
+{
+    std::vector<RGBColor>       colors = subscription->controller->colors;
+    std::vector<unsigned short> changed;
+    bool                        same_size = (colors.size() == subscription->last_colors.size());
+
+    /*-------------------------------------------------*\
+    | Skip the update if nothing changed since the last |
+    | one sent                                          |
+    \*-------------------------------------------------*/
+    if(same_size)
+    {
+        for(std::size_t color_idx = 0; color_idx < colors.size(); color_idx++)
+        {
+            if(colors[color_idx] != subscription->last_colors[color_idx])
+            {
+                changed.push_back((unsigned short)color_idx);
+            }
+        }
+
+        if(changed.empty())
+        {
+            return(false);
+        }
+    }
+
+    unsigned short num_colors   = (unsigned short)colors.size();
+    unsigned int   full_size    = sizeof(unsigned int) + sizeof(unsigned short) + (num_colors * sizeof(RGBColor));
+    unsigned int   delta_size   = sizeof(unsigned int) + (2 * sizeof(unsigned short)) + (changed.size() * (sizeof(unsigned short) + sizeof(RGBColor)));
+    bool           delta        = (subscription->flags & NET_SUBSCRIBE_FLAG_DELTA) && same_size && (delta_size < full_size) && (colors.size() <= 0xFFFF);
+    unsigned int   data_size    = delta ? delta_size : full_size;
+    unsigned int   data_ptr     = 0;
+
+    header->pkt_magic[0] = 'O';
+    header->pkt_magic[1] = 'R';
+    header->pkt_magic[2] = 'G';
+    header->pkt_magic[3] = 'B';
+
+    header->pkt_dev_idx  = subscription->dev_idx;
+    header->pkt_id       = delta ? NET_PACKET_ID_COLORS_UPDATED_DELTA : NET_PACKET_ID_COLORS_UPDATED;
+    header->pkt_size     = data_size;
+
+    data->resize(data_size);
+
+    memcpy(&(*data)[data_ptr], &data_size, sizeof(data_size));
+    data_ptr += sizeof(data_size);
+
+    memcpy(&(*data)[data_ptr], &num_colors, sizeof(num_colors));
+    data_ptr += sizeof(num_colors);
+
+    if(delta)
+    {
+        unsigned short num_changes = (unsigned short)changed.size();
+
+        memcpy(&(*data)[data_ptr], &num_changes, sizeof(num_changes));
+        data_ptr += sizeof(num_changes);
+
+        for(std::size_t change_idx = 0; change_idx < changed.size(); change_idx++)
+        {
+            memcpy(&(*data)[data_ptr], &changed[change_idx], sizeof(unsigned short));
+            data_ptr += sizeof(unsigned short);
+
+            memcpy(&(*data)[data_ptr], &colors[changed[change_idx]], sizeof(RGBColor));
+            data_ptr += sizeof(RGBColor);
+        }
+    }
+    else if(num_colors > 0)
+    {
+        memcpy(&(*data)[data_ptr], colors.data(), num_colors * sizeof(RGBColor));
+    }
+
+    subscription->last_colors.swap(colors);
+
+    return(true);
+}
+
+void NetworkServer::ProcessStream_Datagram(const char * data, int data_size, const std::string& sender_ip)
+{
+    NetStreamHeader header;
+
+    /*-------------------------------------------------*\
+    | A datagram must hold the header, data size, and   |
+    | color count                                       |
+    \*-------------------------------------------------*/
+    if(data_size < (int)(sizeof(NetStreamHeader) + sizeof(unsigned int) + sizeof(unsigned short)))
+    {
+        return;
+    }
+
+    memcpy(&header, data, sizeof(NetStreamHeader));
+
+    if(memcmp(header.pkt_magic, "ORGU", sizeof(header.pkt_magic)) != 0 || header.stream_id == 0)
+    {
+        return;
+    }
+
+    const char *    color_data = data + sizeof(NetStreamHeader);
+    unsigned short  num_colors;
+
+    memcpy(&num_colors, color_data + sizeof(unsigned int), sizeof(unsigned short));
+
+    if(data_size < (int)(sizeof(NetStreamHeader) + sizeof(unsigned int) + sizeof(unsigned short) + (num_colors * sizeof(RGBColor))))
+    {
+        return;
+    }
+
+    long long arrival_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    ServerClientsMutex.lock();
+
+    /*-------------------------------------------------*\
+    | Find the client that owns this stream.  The       |
+    | datagram must come from the same host as the TCP  |
+    | session that requested it                         |
+    \*-------------------------------------------------*/
+    NetworkClientInfo * client_info = nullptr;
+
+    for(unsigned int client_idx = 0; client_idx < ServerClients.size(); client_idx++)
+    {
+        if(ServerClients[client_idx]->stream_id == header.stream_id)
+        {
+            client_info = ServerClients[client_idx];
+            break;
+        }
+    }
+
+    if(client_info == nullptr || client_info->client_ip != sender_ip || header.pkt_dev_idx >= controllers.size())
+    {
+        ServerClientsMutex.unlock();
+        return;
+    }
+
+    NetworkStreamStats&     stats       = client_info->stream_stats;
+    unsigned int            transit_us  = (unsigned int)arrival_us - header.timestamp_us;
+
+    /*-------------------------------------------------*\
+    | Sequence numbers start at 1 for each device       |
+    \*-------------------------------------------------*/
+    bool                    first_frame = (client_info->stream_devices.count(header.pkt_dev_idx) == 0);
+    NetworkStreamDevice&    device      = client_info->stream_devices[header.pkt_dev_idx];
+
+    if(first_frame)
+    {
+        device.last_sequence   = 0;
+        device.last_transit_us = transit_us;
+    }
+
+    /*-------------------------------------------------*\
+    | Drop frames that are not newer than the last one  |
+    | applied, a late frame is worthless.  The signed   |
+    | difference handles sequence number wraparound     |
+    \*-------------------------------------------------*/
+    int sequence_delta = (int)(header.sequence - device.last_sequence);
+
+    if(sequence_delta <= 0)
+    {
+        stats.frames_stale++;
+        ServerClientsMutex.unlock();
+        return;
+    }
+
+    stats.frames_lost += sequence_delta - 1;
+
+    /*-------------------------------------------------*\
+    | Interarrival jitter from RFC 3550.  The sender    |
+    | clock offset cancels out of the transit delta     |
+    \*-------------------------------------------------*/
+    if(!first_frame)
+    {
+        int transit_delta = (int)(transit_us - device.last_transit_us);
+
+        if(transit_delta < 0)
+        {
+            transit_delta = -transit_delta;
+        }
+
+        stats.jitter_us += ((double)transit_delta - stats.jitter_us) / 16.0;
+    }
+
+    device.last_sequence   = header.sequence;
+    device.last_transit_us = transit_us;
+
+    stats.frames_received++;
+
+    controllers[header.pkt_dev_idx]->SetColorDescription((unsigned char *)color_data);
+    controllers[header.pkt_dev_idx]->UpdateLEDs();
+
+    ServerClientsMutex.unlock();
+}
+
+/*-----------------------------------------------------*\
+| Send a packet header and its data as one message      |
+\*-----------------------------------------------------*/
+void NetworkServer::SendPacket(SOCKET client_sock, NetPacketHeader * header, const char * data)
+{
+    net_port_buffer buffers[2];
+
+    buffers[0].buffer = (const char *)header;
+    buffers[0].length = sizeof(NetPacketHeader);
+    buffers[1].buffer = data;
+    buffers[1].length = (data == NULL) ? 0 : header->pkt_size;
+
+    SendBuffers(client_sock, buffers, 2);
+}
+
+/*-----------------------------------------------------*\
+| Send through the client's writer.  Its mutex keeps    |
+| the gathered write of each packet whole when replies, |
+| device list notifications and color updates are sent  |
+| from different threads.  Packets for a socket that no |
+| longer belongs to a client are dropped                |
+\*-----------------------------------------------------*/
+void NetworkServer::SendBuffers(SOCKET client_sock, const net_port_buffer * buffers, int count)
+{
+    std::shared_ptr<net_port_writer> writer;
+
+    ServerClientsMutex.lock();
+
+    for(unsigned int client_idx = 0; client_idx < ServerClients.size(); client_idx++)
+    {
+        if(ServerClients[client_idx]->client_sock == client_sock)
+        {
+            writer = ServerClients[client_idx]->client_writer;
+            break;
+        }
+    }
+
+    ServerClientsMutex.unlock();
+
+    if(writer != nullptr)
+    {
+        writer->write(buffers, count);
+    }
+}
+
 void NetworkServer::SendReply_ControllerCount(SOCKET client_sock)
 {
     NetPacketHeader reply_hdr;
@@ -932,8 +1827,7 @@ void NetworkServer::SendReply_ControllerCount(SOCKET client_sock)
 
     reply_data             = controllers.size();
 
-    send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-    send(client_sock, (const char *)&reply_data, sizeof(unsigned int), 0);
+    SendPacket(client_sock, &reply_hdr, (const char *)&reply_data);
 }
 
 void NetworkServer::SendReply_ControllerData(SOCKET client_sock, unsigned int dev_idx, unsigned int protocol_version)
@@ -955,8 +1849,7 @@ void NetworkServer::SendReply_ControllerData(SOCKET client_sock, unsigned int de
         reply_hdr.pkt_id       = NET_PACKET_ID_REQUEST_CONTROLLER_DATA;
         reply_hdr.pkt_size     = reply_size;
 
-        send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-        send(client_sock, (const char *)reply_data, reply_size, 0);
+        SendPacket(client_sock, &reply_hdr, (const char *)reply_data);
 
         delete[] reply_data;
     }
@@ -978,8 +1871,27 @@ void NetworkServer::SendReply_ProtocolVersion(SOCKET client_sock)
 
     reply_data             = OPENRGB_SDK_PROTOCOL_VERSION;
 
-    send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-    send(client_sock, (const char *)&reply_data, sizeof(unsigned int), 0);
+    SendPacket(client_sock, &reply_hdr, (const char *)&reply_data);
+}
+
+void NetworkServer::SendReply_UDPStream(SOCKET client_sock, unsigned int stream_id, unsigned int stream_port)
+{
+    NetPacketHeader reply_hdr;
+    unsigned int    reply_data[2];
+
+    reply_hdr.pkt_magic[0] = 'O';
+    reply_hdr.pkt_magic[1] = 'R';
+    reply_hdr.pkt_magic[2] = 'G';
+    reply_hdr.pkt_magic[3] = 'B';
+
+    reply_hdr.pkt_dev_idx  = 0;
+    reply_hdr.pkt_id       = NET_PACKET_ID_REQUEST_UDP_STREAM;
+    reply_hdr.pkt_size     = sizeof(reply_data);
+
+    reply_data[0]          = stream_id;
+    reply_data[1]          = stream_port;
+
+    SendPacket(client_sock, &reply_hdr, (const char *)&reply_data);
 }
 
 void NetworkServer::SendRequest_DeviceListChanged(SOCKET client_sock)
@@ -995,7 +1907,7 @@ void NetworkServer::SendRequest_DeviceListChanged(SOCKET client_sock)
     pkt_hdr.pkt_id       = NET_PACKET_ID_DEVICE_LIST_UPDATED;
     pkt_hdr.pkt_size     = 0;
 
-    send(client_sock, (char *)&pkt_hdr, sizeof(NetPacketHeader), 0);
+    SendPacket(client_sock, &pkt_hdr, NULL);
 }
 
 void NetworkServer::SendReply_ProfileList(SOCKET client_sock)
@@ -1020,8 +1932,7 @@ void NetworkServer::SendReply_ProfileList(SOCKET client_sock)
     reply_hdr.pkt_id       = NET_PACKET_ID_REQUEST_PROFILE_LIST;
     reply_hdr.pkt_size     = reply_size;
 
-    send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-    send(client_sock, (const char *)reply_data, reply_size, 0);
+    SendPacket(client_sock, &reply_hdr, (const char *)reply_data);
 }
 
 void NetworkServer::SendReply_PluginList(SOCKET client_sock)
@@ -1125,8 +2036,7 @@ void NetworkServer::SendReply_PluginList(SOCKET client_sock)
     reply_hdr.pkt_id       = NET_PACKET_ID_REQUEST_PLUGIN_LIST;
     reply_hdr.pkt_size     = reply_size;
 
-    send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-    send(client_sock, (const char *)data_buf, reply_size, 0);
+    SendPacket(client_sock, &reply_hdr, (const char *)data_buf);
 
     delete [] data_buf;
 }
@@ -1144,9 +2054,16 @@ void NetworkServer::SendReply_PluginSpecific(SOCKET client_sock, unsigned int pk
     reply_hdr.pkt_id       = NET_PACKET_ID_PLUGIN_SPECIFIC;
     reply_hdr.pkt_size     = data_size + sizeof(pkt_type);
 
-    send(client_sock, (const char *)&reply_hdr, sizeof(NetPacketHeader), 0);
-    send(client_sock, (const char *)&pkt_type, sizeof(pkt_type), 0);
-    send(client_sock, (const char *)data, data_size, 0);
+    net_port_buffer buffers[3];
+
+    buffers[0].buffer = (const char *)&reply_hdr;
+    buffers[0].length = sizeof(NetPacketHeader);
+    buffers[1].buffer = (const char *)&pkt_type;
+    buffers[1].length = sizeof(pkt_type);
+    buffers[2].buffer = (const char *)data;
+    buffers[2].length = data_size;
+
+    SendBuffers(client_sock, buffers, 3);
     delete [] data;
 }
 
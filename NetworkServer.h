@@ -11,6 +11,10 @@
 #include "net_port.h"
 #include "ProfileManager.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <chrono>
@@ -20,6 +24,12 @@
 #define MAXSOCK 32
 #define TCP_TIMEOUT_SECONDS 5
 
+/*-----------------------------------------------------*\
+| Shortest interval a client may subscribe to color     |
+| updates with                                          |
+\*-----------------------------------------------------*/
+#define NETWORK_SUBSCRIPTION_MIN_INTERVAL_MS    10
+
 typedef void (*NetServerCallback)(void *);
 typedef unsigned char* (*NetPluginCallback)(void *, unsigned int, unsigned char*, unsigned int*);
 
@@ -33,6 +43,34 @@ struct NetworkPlugin
     unsigned int protocol_version;
 };
 
+struct NetworkStreamStats
+{
+    unsigned int        frames_received;            /* Frames applied to a device                           */
+    unsigned int        frames_lost;                /* Frames missing from the sequence                     */
+    unsigned int        frames_stale;               /* Frames dropped as duplicate or out of order          */
+    double              jitter_us;                  /* Interarrival jitter estimate (RFC 3550)              */
+};
+
+struct NetworkStreamDevice
+{
+    unsigned int        last_sequence;
+    unsigned int        last_transit_us;
+};
+
+class NetworkClientInfo;
+
+struct NetworkColorSubscription
+{
+    NetworkClientInfo *                     client_info;
+    unsigned int                            dev_idx;
+    RGBController *                         controller;
+    unsigned int                            flags;
+    std::chrono::milliseconds               interval;
+    std::chrono::steady_clock::time_point   last_push;
+    std::atomic<bool>                       dirty;
+    std::vector<RGBColor>                   last_colors;
+};
+
 class NetworkClientInfo
 {
 public:
@@ -44,6 +82,24 @@ public:
     std::string     client_string;
     unsigned int    client_protocol_version;
     std::string     client_ip;
+
+    unsigned int                                stream_id;
+    NetworkStreamStats                          stream_stats;
+    std::map<unsigned int, NetworkStreamDevice> stream_devices;
+
+    /*---------------------------------------------------------*\
+    | Shared so a sender that looked the client up can finish   |
+    | its write after the client has been removed               |
+    \*---------------------------------------------------------*/
+    std::shared_ptr<net_port_writer>            client_writer;
+
+    std::mutex                                  subscription_mutex;
+    std::vector<NetworkColorSubscription *>     subscriptions;
+    std::thread *                               subscription_thread;
+    bool                                        subscription_thread_running;
+    std::mutex                                  subscription_wake_mutex;
+    std::condition_variable                     subscription_wake_cv;
+    bool                                        subscription_wake;
 };
 
 class NetworkServer
@@ -54,12 +110,15 @@ public:
 
     std::string                         GetHost();
     unsigned short                      GetPort();
+    std::string                         GetUnixSocketPath();
     bool                                GetOnline();
     bool                                GetListening();
     unsigned int                        GetNumClients();
     const char *                        GetClientString(unsigned int client_num);
     const char *                        GetClientIP(unsigned int client_num);
     unsigned int                        GetClientProtocolVersion(unsigned int client_num);
+    bool                                GetClientStreamStats(unsigned int client_num, NetworkStreamStats * stats);
+    bool                                GetUDPStreamEnabled();
 
     void                                ClientInfoChanged();
     void                                DeviceListChanged();
@@ -70,19 +129,28 @@ public:
 
     void                                SetHost(std::string host);
     void                                SetPort(unsigned short new_port);
+    void                                SetUnixSocketPath(std::string new_path);
+    void                                SetUDPStreamEnabled(bool enabled);
 
     void                                StartServer();
     void                                StopServer();
 
     void                                ConnectionThreadFunction(int socket_idx);
     void                                ListenThreadFunction(NetworkClientInfo * client_sock);
+    void                                StreamThreadFunction();
+    void                                SubscriptionThreadFunction(NetworkClientInfo * client_info);
 
     void                                ProcessRequest_ClientProtocolVersion(SOCKET client_sock, unsigned int data_size, char * data);
     void                                ProcessRequest_ClientString(SOCKET client_sock, unsigned int data_size, char * data);
+    void                                ProcessRequest_UDPStream(NetworkClientInfo * client_info);
+    void                                ProcessRequest_SubscribeColors(NetworkClientInfo * client_info, unsigned int dev_idx, unsigned int data_size, char * data);
+    void                                ProcessRequest_UnsubscribeColors(NetworkClientInfo * client_info, unsigned int dev_idx);
+    void                                ProcessStream_Datagram(const char * data, int data_size, const std::string& sender_ip);
 
     void                                SendReply_ControllerCount(SOCKET client_sock);
     void                                SendReply_ControllerData(SOCKET client_sock, unsigned int dev_idx, unsigned int protocol_version);
     void                                SendReply_ProtocolVersion(SOCKET client_sock);
+    void                                SendReply_UDPStream(SOCKET client_sock, unsigned int stream_id, unsigned int stream_port);
 
     void                                SendRequest_DeviceListChanged(SOCKET client_sock);
     void                                SendReply_ProfileList(SOCKET client_sock);
@@ -97,6 +165,8 @@ public:
 protected:
     std::string                         host;
     unsigned short                      port_num;
+    std::string                         unix_socket_path;
+    bool                                udp_stream_enabled;
     bool                                server_online;
     bool                                server_listening;
 
@@ -125,7 +195,21 @@ private:
 
     int             socket_count;
     SOCKET          server_sock[MAXSOCK];
+    bool            unix_socket_bound;
+    SOCKET          stream_sock;
+    std::thread *   StreamThread;
+
+    void            SendPacket(SOCKET client_sock, NetPacketHeader * header, const char * data);
+    void            SendBuffers(SOCKET client_sock, const net_port_buffer * buffers, int count);
+
+    bool            BuildColorUpdate(NetworkColorSubscription * subscription, NetPacketHeader * header, std::vector<unsigned char> * data);
+    void            ClearSubscriptions(NetworkClientInfo * client_info);
+    void            StopSubscriptions(NetworkClientInfo * client_info);
+
+    void            StartUnixSocket();
+    void            StartStreamSocket();
 
     int             accept_select(int sockfd);
     int             recv_select(SOCKET s, char *buf, int len, int flags);
+    bool            send_select(NetworkClientInfo * client_info);
 };
@@ -205,7 +205,10 @@ HEADERS +=
     dependencies/Swatches/swatches.h                                                            \
     dependencies/json/json.hpp                                                                  \
     dependencies/libcmmk/include/libcmmk/libcmmk.h                                              \
+    EffectsEngine.h                                                                             \
+    LogBenchmark.h                                                                              \
     LogManager.h                                                                                \
+    NetworkBenchmark.h                                                                          \
     NetworkClient.h                                                                             \
     NetworkProtocol.h                                                                           \
     NetworkServer.h                                                                             \
@@ -213,6 +216,7 @@ HEADERS +=
     PluginManager.h                                                                             \
     ProfileManager.h                                                                            \
     ResourceManager.h                                                                           \
+    SceneGraph.h                                                                                \
     SettingsManager.h                                                                           \
     Detector.h                                                                                  \
     DeviceDetector.h                                                                            \
@@ -223,8 +227,11 @@ HEADERS +=
     qt/OpenRGBDeviceInfoPage.h                                                                  \
     qt/OpenRGBDevicePage.h                                                                      \
     qt/OpenRGBDialog.h                                                                          \
+    hidapi_wrapper/hid_pacer.h                                                                  \
+    hidapi_wrapper/hidapi_mock.h                                                                \
     hidapi_wrapper/hidapi_wrapper.h                                                             \
     i2c_smbus/i2c_smbus.h                                                                       \
+    i2c_smbus/i2c_smbus_scheduler.h                                                             \
     i2c_tools/i2c_tools.h                                                                       \
     net_port/net_port.h                                                                         \
     pci_ids/pci_ids.h                                                                           \
@@ -740,6 +747,7 @@ HEADERS +=
     Controllers/ZotacV2GPUController/ZotacV2GPUController.h                                     \
     Controllers/ZotacV2GPUController/RGBController_ZotacV2GPU.h                                 \
     KeyboardLayoutManager/KeyboardLayoutManager.h                                               \
+    RGBController/RGBColorPack.h                                                                \
     RGBController/RGBController.h                                                               \
     RGBController/RGBController_Dummy.h                                                         \
     RGBController/RGBControllerKeyNames.h                                                       \
@@ -792,12 +800,16 @@ SOURCES +=
     dependencies/libcmmk/src/libcmmk.c                                                          \
     main.cpp                                                                                    \
     cli.cpp                                                                                     \
+    EffectsEngine.cpp                                                                           \
+    LogBenchmark.cpp                                                                            \
     LogManager.cpp                                                                              \
+    NetworkBenchmark.cpp                                                                        \
     NetworkClient.cpp                                                                           \
     NetworkServer.cpp                                                                           \
     PluginManager.cpp                                                                           \
     ProfileManager.cpp                                                                          \
     ResourceManager.cpp                                                                         \
+    SceneGraph.cpp                                                                              \
     SettingsManager.cpp                                                                         \
     qt/DetectorTableModel.cpp                                                                   \
     qt/OpenRGBClientInfoPage.cpp                                                                \
@@ -805,7 +817,10 @@ SOURCES +=
     qt/OpenRGBDeviceInfoPage.cpp                                                                \
     qt/OpenRGBDevicePage.cpp                                                                    \
     qt/OpenRGBDialog.cpp                                                                        \
+    hidapi_wrapper/hid_pacer.cpp                                                                \
+    hidapi_wrapper/hidapi_mock.cpp                                                              \
     i2c_smbus/i2c_smbus.cpp                                                                     \
+    i2c_smbus/i2c_smbus_scheduler.cpp                                                           \
     i2c_tools/i2c_tools.cpp                                                                     \
     net_port/net_port.cpp                                                                       \
     qt/DeviceView.cpp                                                                           \
@@ -1442,6 +1457,7 @@ SOURCES +=
     Controllers/ZotacV2GPUController/ZotacV2GPUControllerDetect.cpp                             \
     Controllers/ZotacV2GPUController/RGBController_ZotacV2GPU.cpp                               \
     KeyboardLayoutManager/KeyboardLayoutManager.cpp                                             \
+    RGBController/RGBColorPack.cpp                                                              \
     RGBController/RGBController.cpp                                                             \
     RGBController/RGBController_Dummy.cpp                                                       \
     RGBController/RGBControllerKeyNames.cpp                                                     \
@@ -1749,11 +1765,13 @@ contains(QMAKE_PLATFORM, linux) {
     TARGET = $$lower($$TARGET)
 
     INCLUDEPATH +=                                                                              \
+    sysfs/                                                                                      \
     Controllers/FaustusController                                                               \
     Controllers/LinuxLEDController                                                              \
 
     HEADERS +=                                                                                  \
     i2c_smbus/i2c_smbus_linux.h                                                                 \
+    sysfs/sysfs_attr.h                                                                          \
     AutoStart/AutoStart-Linux.h                                                                 \
     Controllers/AsusTUFLaptopLinuxController/AsusTUFLaptopLinuxController.h                     \
     Controllers/AsusTUFLaptopLinuxController/RGBController_AsusTUFLaptopLinux.h                 \
@@ -1780,8 +1798,12 @@ contains(QMAKE_PLATFORM, linux) {
     #-------------------------------------------------------------------------------------------#
     # Determine which hidapi to use based on availability                                       #
     #   Prefer hidraw backend, then libusb                                                      #
+    #   With CONFIG+=hid_mock, link the simulated backend from hidapi_mock.cpp instead so that  #
+    #   all HID detectors run against the configured hid_mock_fixture                           #
     #-------------------------------------------------------------------------------------------#
-    packagesExist(hidapi-hidraw) {
+    CONFIG(hid_mock) {
+        DEFINES += HIDAPI_MOCK_BACKEND USE_HID_USAGE
+    } else:packagesExist(hidapi-hidraw) {
         LIBS += -lhidapi-hidraw
 
         #---------------------------------------------------------------------------------------#
@@ -1804,6 +1826,7 @@ contains(QMAKE_PLATFORM, linux) {
     dependencies/hueplusplus-1.0.0/src/LinHttpHandler.cpp                                       \
     i2c_smbus/i2c_smbus_linux.cpp                                                               \
     serial_port/find_usb_serial_port_linux.cpp                                                  \
+    sysfs/sysfs_attr.cpp                                                                        \
     AutoStart/AutoStart-Linux.cpp                                                               \
     Controllers/AsusTUFLaptopLinuxController/AsusTUFLaptopLinuxController.cpp                   \
     Controllers/AsusTUFLaptopLinuxController/AsusTUFLaptopLinuxDetect.cpp                       \
@@ -1874,11 +1897,13 @@ contains(QMAKE_PLATFORM, freebsd) {
     TARGET = $$lower($$TARGET)
 
     INCLUDEPATH +=                                                                              \
+    sysfs/                                                                                      \
     Controllers/FaustusController                                                               \
     Controllers/LinuxLEDController                                                              \
 
     HEADERS +=                                                                                  \
     AutoStart/AutoStart-FreeBSD.h                                                               \
+    sysfs/sysfs_attr.h                                                                          \
     Controllers/ENESMBusController/ENESMBusInterface/ENESMBusInterface_SpectrixS40G.h           \
     Controllers/FaustusController/RGBController_Faustus.h                                       \
     Controllers/LinuxLEDController/LinuxLEDController.h                                         \
@@ -1922,6 +1947,7 @@ contains(QMAKE_PLATFORM, freebsd) {
     SOURCES +=                                                                                  \
     dependencies/hueplusplus-1.0.0/src/LinHttpHandler.cpp                                       \
     serial_port/find_usb_serial_port_linux.cpp                                                  \
+    sysfs/sysfs_attr.cpp                                                                        \
     AutoStart/AutoStart-FreeBSD.cpp                                                             \
     Controllers/ENESMBusController/XPGSpectrixS40GDetect.cpp                                    \
     Controllers/ENESMBusController/ENESMBusInterface/ENESMBusInterface_SpectrixS40G.cpp         \
@@ -328,7 +328,7 @@ bool ProfileManager::LoadDeviceFromListWithOptions
 
                     }
 
-                    load_controller->active_mode = temp_controller->active_mode;
+                    load_controller->SelectMode(temp_controller->GetMode());
                 }
 
                 /*---------------------------------------------------------*\
@@ -398,6 +398,7 @@ bool ProfileManager::LoadProfileWithOptions
     \*---------------------------------------------------------*/
     for(unsigned int controller_idx = 0; controller_idx < temp_controllers.size(); controller_idx++)
     {
+        temp_controllers[controller_idx]->Shutdown();
         delete temp_controllers[controller_idx];
     }
 
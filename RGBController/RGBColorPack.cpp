@@ -0,0 +1,243 @@
+/*-----------------------------------------*\
+|  RGBColorPack.cpp                         |
+|                                           |
+|  Shared conversion of RGBColor buffers    |
+|  into common wire formats                 |
+\*-----------------------------------------*/
+
+#include "RGBColorPack.h"
+#include <cmath>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define RGB_COLOR_PACK_SSSE3
+#define RGB_COLOR_PACK_SSSE3_TARGET __attribute__((target("ssse3")))
+#include <tmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define RGB_COLOR_PACK_SSSE3
+#define RGB_COLOR_PACK_SSSE3_TARGET
+#include <intrin.h>
+#include <tmmintrin.h>
+#endif
+
+/*-----------------------------------------*\
+| Source byte (0 = R, 1 = G, 2 = B) of each |
+| output byte for every channel order       |
+\*-----------------------------------------*/
+static const unsigned char pack_order_map[6][3] =
+{
+    { 0, 1, 2 },    /* RGB_PACK_ORDER_RGB   */
+    { 0, 2, 1 },    /* RGB_PACK_ORDER_RBG   */
+    { 1, 0, 2 },    /* RGB_PACK_ORDER_GRB   */
+    { 1, 2, 0 },    /* RGB_PACK_ORDER_GBR   */
+    { 2, 0, 1 },    /* RGB_PACK_ORDER_BRG   */
+    { 2, 1, 0 },    /* RGB_PACK_ORDER_BGR   */
+};
+
+static unsigned char LUTValue(unsigned int value, float gamma, float scale)
+{
+    float out = std::pow(value / 255.0f, gamma) * scale * 255.0f;
+
+    if(out <= 0.0f)
+    {
+        return(0);
+    }
+
+    if(out >= 255.0f)
+    {
+        return(255);
+    }
+
+    return((unsigned char)(out + 0.5f));
+}
+
+void RGBColorLUTInit
+    (
+    RGBColorLUT*        lut,
+    float               gamma,
+    float               brightness,
+    float               red_gain,
+    float               green_gain,
+    float               blue_gain
+    )
+{
+    for(unsigned int value = 0; value < 256; value++)
+    {
+        lut->r[value] = LUTValue(value, gamma, red_gain   * brightness);
+        lut->g[value] = LUTValue(value, gamma, green_gain * brightness);
+        lut->b[value] = LUTValue(value, gamma, blue_gain  * brightness);
+    }
+}
+
+void RGBColorApplyLUT
+    (
+    const RGBColor*     in,
+    RGBColor*           out,
+    std::size_t         count,
+    const RGBColorLUT*  lut
+    )
+{
+    for(std::size_t color_idx = 0; color_idx < count; color_idx++)
+    {
+        RGBColor color  = in[color_idx];
+
+        out[color_idx]  = ToRGBColor(lut->r[RGBGetRValue(color)],
+                                     lut->g[RGBGetGValue(color)],
+                                     lut->b[RGBGetBValue(color)]);
+    }
+}
+
+#ifdef RGB_COLOR_PACK_SSSE3
+static bool HasSSSE3()
+{
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 1);
+
+    return((info[2] & (1 << 9)) != 0);
+#else
+    return(__builtin_cpu_supports("ssse3"));
+#endif
+}
+
+/*-----------------------------------------*\
+| Shuffle four colors (16 bytes) into 12    |
+| packed bytes at a time.  Each store       |
+| writes 16 bytes, so the loop stops while  |
+| at least two colors remain and returns    |
+| the number of colors packed               |
+\*-----------------------------------------*/
+RGB_COLOR_PACK_SSSE3_TARGET
+static std::size_t PackSSSE3
+    (
+    const RGBColor*     colors,
+    std::size_t         count,
+    unsigned char*      buf,
+    const unsigned char map[3]
+    )
+{
+    alignas(16) unsigned char shuffle[16];
+
+    for(unsigned int byte_idx = 0; byte_idx < 16; byte_idx++)
+    {
+        shuffle[byte_idx] = 0x80;
+    }
+
+    for(unsigned int color_idx = 0; color_idx < 4; color_idx++)
+    {
+        for(unsigned int channel_idx = 0; channel_idx < 3; channel_idx++)
+        {
+            shuffle[(color_idx * 3) + channel_idx] = (unsigned char)((color_idx * 4) + map[channel_idx]);
+        }
+    }
+
+    __m128i     mask    = _mm_load_si128((const __m128i*)shuffle);
+    std::size_t packed  = 0;
+
+    while(count - packed >= 6)
+    {
+        __m128i in = _mm_loadu_si128((const __m128i*)&colors[packed]);
+
+        _mm_storeu_si128((__m128i*)&buf[packed * 3], _mm_shuffle_epi8(in, mask));
+
+        packed += 4;
+    }
+
+    return(packed);
+}
+#endif
+
+void RGBColorPack
+    (
+    const RGBColor*     colors,
+    std::size_t         count,
+    unsigned char*      buf,
+    RGBColorPackOrder   order,
+    const RGBColorLUT*  lut
+    )
+{
+    const unsigned char*    map         = pack_order_map[order];
+    std::size_t             color_idx   = 0;
+
+    if(lut == NULL)
+    {
+#ifdef RGB_COLOR_PACK_SSSE3
+        static const bool has_ssse3 = HasSSSE3();
+
+        if(has_ssse3)
+        {
+            color_idx = PackSSSE3(colors, count, buf, map);
+        }
+#endif
+        for(; color_idx < count; color_idx++)
+        {
+            unsigned char channels[3] =
+            {
+                (unsigned char)RGBGetRValue(colors[color_idx]),
+                (unsigned char)RGBGetGValue(colors[color_idx]),
+                (unsigned char)RGBGetBValue(colors[color_idx])
+            };
+
+            buf[(color_idx * 3) + 0] = channels[map[0]];
+            buf[(color_idx * 3) + 1] = channels[map[1]];
+            buf[(color_idx * 3) + 2] = channels[map[2]];
+        }
+    }
+    else
+    {
+        for(; color_idx < count; color_idx++)
+        {
+            unsigned char channels[3] =
+            {
+                lut->r[RGBGetRValue(colors[color_idx])],
+                lut->g[RGBGetGValue(colors[color_idx])],
+                lut->b[RGBGetBValue(colors[color_idx])]
+            };
+
+            buf[(color_idx * 3) + 0] = channels[map[0]];
+            buf[(color_idx * 3) + 1] = channels[map[1]];
+            buf[(color_idx * 3) + 2] = channels[map[2]];
+        }
+    }
+}
+
+void RGBColorPackRGBW
+    (
+    const RGBColor*     colors,
+    std::size_t         count,
+    unsigned char*      buf,
+    const RGBColorLUT*  lut
+    )
+{
+    for(std::size_t color_idx = 0; color_idx < count; color_idx++)
+    {
+        unsigned char red   = RGBGetRValue(colors[color_idx]);
+        unsigned char grn   = RGBGetGValue(colors[color_idx]);
+        unsigned char blu   = RGBGetBValue(colors[color_idx]);
+
+        if(lut != NULL)
+        {
+            red = lut->r[red];
+            grn = lut->g[grn];
+            blu = lut->b[blu];
+        }
+
+        unsigned char wht   = red;
+
+        if(grn < wht)
+        {
+            wht = grn;
+        }
+
+        if(blu < wht)
+        {
+            wht = blu;
+        }
+
+        buf[(color_idx * 4) + 0] = red - wht;
+        buf[(color_idx * 4) + 1] = grn - wht;
+        buf[(color_idx * 4) + 2] = blu - wht;
+        buf[(color_idx * 4) + 3] = wht;
+    }
+}
@@ -0,0 +1,91 @@
+/*-----------------------------------------*\
+|  RGBColorPack.h                           |
+|                                           |
+|  Shared conversion of RGBColor buffers    |
+|  into common wire formats, with optional  |
+|  per-channel lookup tables for gamma,     |
+|  gain and brightness                      |
+|                                           |
+|  Controllers opt in by calling these from |
+|  their packet building code in place of   |
+|  per-LED RGBGet*Value loops               |
+\*-----------------------------------------*/
+
+#pragma once
+
+#include <cstddef>
+#include "RGBController.h"
+
+enum RGBColorPackOrder
+{
+    RGB_PACK_ORDER_RGB,
+    RGB_PACK_ORDER_RBG,
+    RGB_PACK_ORDER_GRB,
+    RGB_PACK_ORDER_GBR,
+    RGB_PACK_ORDER_BRG,
+    RGB_PACK_ORDER_BGR,
+};
+
+/*-----------------------------------------*\
+| Per-channel 8-bit lookup table            |
+\*-----------------------------------------*/
+struct RGBColorLUT
+{
+    unsigned char   r[256];
+    unsigned char   g[256];
+    unsigned char   b[256];
+};
+
+/*-----------------------------------------*\
+| Fill a lookup table.  Each channel maps   |
+| v to 255 * (v / 255) ^ gamma * gain *     |
+| brightness, clamped to 0-255              |
+\*-----------------------------------------*/
+void RGBColorLUTInit
+    (
+    RGBColorLUT*        lut,
+    float               gamma       = 1.0f,
+    float               brightness  = 1.0f,
+    float               red_gain    = 1.0f,
+    float               green_gain  = 1.0f,
+    float               blue_gain   = 1.0f
+    );
+
+/*-----------------------------------------*\
+| Apply a lookup table to count colors.     |
+| in and out may be the same buffer         |
+\*-----------------------------------------*/
+void RGBColorApplyLUT
+    (
+    const RGBColor*     in,
+    RGBColor*           out,
+    std::size_t         count,
+    const RGBColorLUT*  lut
+    );
+
+/*-----------------------------------------*\
+| Pack count colors as 3 bytes each in the  |
+| given channel order.  If lut is not NULL  |
+| it is applied while packing               |
+\*-----------------------------------------*/
+void RGBColorPack
+    (
+    const RGBColor*     colors,
+    std::size_t         count,
+    unsigned char*      buf,
+    RGBColorPackOrder   order,
+    const RGBColorLUT*  lut         = NULL
+    );
+
+/*-----------------------------------------*\
+| Pack count colors as R, G, B, W bytes,    |
+| moving the common white component of     |
+| each color into the W channel             |
+\*-----------------------------------------*/
+void RGBColorPackRGBW
+    (
+    const RGBColor*     colors,
+    std::size_t         count,
+    unsigned char*      buf,
+    const RGBColorLUT*  lut         = NULL
+    );
@@ -1,8 +1,48 @@
 #include "RGBController.h"
+#include "RGBColorPack.h"
+#include "LogManager.h"
+#include <algorithm>
+#include <condition_variable>
 #include <cstring>
 
 using namespace std::chrono_literals;
 
+/*---------------------------------------------------------*\
+| Interval between update dispatcher statistics log entries |
+\*---------------------------------------------------------*/
+#define UPDATE_DISPATCH_STATS_INTERVAL_MS   10000
+
+/*---------------------------------------------------------*\
+| Shared update dispatcher state.  Controllers with pending |
+| updates are pushed onto a lock-free intrusive stack which |
+| the dispatcher thread moves into batch in one exchange.   |
+| batch and dispatching are guarded by dispatch_mutex so a  |
+| controller can be removed before it is deleted, and       |
+| wake_cv is always notified with it held.  The state is    |
+| never destroyed so the detached dispatcher thread can     |
+| safely outlive static destruction at exit                 |
+\*---------------------------------------------------------*/
+struct UpdateDispatchState
+{
+    std::atomic<RGBController*>         queue_head{nullptr};
+    std::condition_variable             wake_cv;
+
+    std::mutex                          dispatch_mutex;
+    std::condition_variable             dispatch_cv;
+    std::vector<RGBController*>         batch;
+    RGBController*                      dispatching{nullptr};
+    std::thread::id                     thread_id;
+
+    std::atomic<unsigned int>           stats_signals{0};
+};
+
+static UpdateDispatchState* GetUpdateDispatchState()
+{
+    static UpdateDispatchState* state = new UpdateDispatchState();
+
+    return(state);
+}
+
 mode::mode()
 {
     name           = "";
@@ -27,15 +67,26 @@ mode::~mode()
 
 RGBController::RGBController()
 {
+    UpdatePending       = false;
+    UpdateQueueNext     = nullptr;
+
+    CalibrationEnabled  = false;
+    CalibrationLUT      = nullptr;
+
     DeviceThreadRunning = true;
     DeviceCallThread = new std::thread(&RGBController::DeviceCallThreadFunction, this);
 }
 
 RGBController::~RGBController()
 {
-    DeviceThreadRunning = false;
-    DeviceCallThread->join();
-    delete DeviceCallThread;
+    /*-------------------------------------------------*\
+    | Owners should call Shutdown before deleting, while |
+    | the derived class is still intact.  This catches   |
+    | controllers deleted without it                     |
+    \*-------------------------------------------------*/
+    Shutdown();
+
+    ClearCalibration();
 
     leds.clear();
     colors.clear();
@@ -261,8 +312,10 @@ unsigned char * RGBController::GetDeviceDescription(unsigned int protocol_versio
     /*---------------------------------------------------------*\
     | Copy in active mode (data)                                |
     \*---------------------------------------------------------*/
-    memcpy(&data_buf[data_ptr], &active_mode, sizeof(active_mode));
-    data_ptr += sizeof(active_mode);
+    int mode_idx = GetMode();
+
+    memcpy(&data_buf[data_ptr], &mode_idx, sizeof(mode_idx));
+    data_ptr += sizeof(mode_idx);
 
     /*---------------------------------------------------------*\
     | Copy in modes                                             |
@@ -641,8 +694,9 @@ void RGBController::ReadDeviceDescription(unsigned char* data_buf, unsigned int
     /*---------------------------------------------------------*\
     | Copy in active mode (data)                                |
     \*---------------------------------------------------------*/
-    memcpy(&active_mode, &data_buf[data_ptr], sizeof(active_mode));
-    data_ptr += sizeof(active_mode);
+    int mode_idx;
+    memcpy(&mode_idx, &data_buf[data_ptr], sizeof(mode_idx));
+    data_ptr += sizeof(mode_idx);
 
     /*---------------------------------------------------------*\
     | Copy in modes                                             |
@@ -762,6 +816,8 @@ void RGBController::ReadDeviceDescription(unsigned char* data_buf, unsigned int
         modes.push_back(new_mode);
     }
 
+    SelectMode(mode_idx);
+
     /*---------------------------------------------------------*\
     | Copy in number of zones (data)                            |
     \*---------------------------------------------------------*/
@@ -1160,7 +1216,9 @@ void RGBController::SetModeDescription(unsigned char* data_buf, unsigned int pro
     /*---------------------------------------------------------*\
     | Set active mode to the new mode                           |
     \*---------------------------------------------------------*/
-    active_mode = mode_idx;
+    {
+        SelectMode(mode_idx);
+    }
 
     /*---------------------------------------------------------*\
     | Copy in mode name (size+data)                             |
@@ -1274,6 +1332,8 @@ void RGBController::SetModeDescription(unsigned char* data_buf, unsigned int pro
 
 unsigned char * RGBController::GetColorDescription()
 {
+    std::lock_guard<std::recursive_mutex> lock(ColorMutex);
+
     unsigned int data_ptr = 0;
     unsigned int data_size = 0;
 
@@ -1320,6 +1380,8 @@ unsigned char * RGBController::GetColorDescription()
 
 void RGBController::SetColorDescription(unsigned char* data_buf)
 {
+    std::lock_guard<std::recursive_mutex> lock(ColorMutex);
+
     unsigned int data_ptr = sizeof(unsigned int);
 
     /*---------------------------------------------------------*\
@@ -1356,6 +1418,8 @@ void RGBController::SetColorDescription(unsigned char* data_buf)
 
 unsigned char * RGBController::GetZoneColorDescription(int zone)
 {
+    std::lock_guard<std::recursive_mutex> lock(ColorMutex);
+
     unsigned int data_ptr = 0;
     unsigned int data_size = 0;
 
@@ -1409,6 +1473,8 @@ unsigned char * RGBController::GetZoneColorDescription(int zone)
 
 void RGBController::SetZoneColorDescription(unsigned char* data_buf)
 {
+    std::lock_guard<std::recursive_mutex> lock(ColorMutex);
+
     unsigned int data_ptr = sizeof(unsigned int);
     unsigned int zone_idx;
 
@@ -1459,6 +1525,8 @@ unsigned char * RGBController::GetSingleLEDColorDescription(int led)
     \*---------------------------------------------------------*/
     unsigned char *data_buf = new unsigned char[sizeof(int) + sizeof(RGBColor)];
 
+    std::lock_guard<std::recursive_mutex> lock(ColorMutex);
+
     /*---------------------------------------------------------*\
     | Copy in LED index                                         |
     \*---------------------------------------------------------*/
@@ -1497,6 +1565,8 @@ void RGBController::SetSingleLEDColorDescription(unsigned char* data_buf)
     /*---------------------------------------------------------*\
     | Copy in LED color                                         |
     \*---------------------------------------------------------*/
+    std::lock_guard<std::recursive_mutex> lock(ColorMutex);
+
     memcpy(&colors[led_idx], &data_buf[sizeof(led_idx)], sizeof(RGBColor));
 }
 
@@ -1553,6 +1623,8 @@ void RGBController::SetupColors()
 
 RGBColor RGBController::GetLED(unsigned int led)
 {
+    std::lock_guard<std::recursive_mutex> lock(ColorMutex);
+
     if(led < colors.size())
     {
         return(colors[led]);
@@ -1565,6 +1637,8 @@ RGBColor RGBController::GetLED(unsigned int led)
 
 void RGBController::SetLED(unsigned int led, RGBColor color)
 {
+    std::lock_guard<std::recursive_mutex> lock(ColorMutex);
+
     if(led < colors.size())
     {
         colors[led] = color;
@@ -1573,6 +1647,8 @@ void RGBController::SetLED(unsigned int led, RGBColor color)
 
 void RGBController::SetAllLEDs(RGBColor color)
 {
+    std::lock_guard<std::recursive_mutex> lock(ColorMutex);
+
     for(std::size_t zone_idx = 0; zone_idx < zones.size(); zone_idx++)
     {
         SetAllZoneLEDs(zone_idx, color);
@@ -1581,6 +1657,8 @@ void RGBController::SetAllLEDs(RGBColor color)
 
 void RGBController::SetAllZoneLEDs(int zone, RGBColor color)
 {
+    std::lock_guard<std::recursive_mutex> lock(ColorMutex);
+
     for (std::size_t color_idx = 0; color_idx < zones[zone].leds_count; color_idx++)
     {
         zones[zone].colors[color_idx] = color;
@@ -1589,59 +1667,348 @@ void RGBController::SetAllZoneLEDs(int zone, RGBColor color)
 
 int RGBController::GetMode()
 {
+    std::lock_guard<std::recursive_mutex> lock(UpdateMutex);
+
+    /*-------------------------------------------------*\
+    | Report the software effect only while the device  |
+    | is still in the hardware mode it selected         |
+    \*-------------------------------------------------*/
+    if((SoftwareEffectMode >= 0)
+    && (SoftwareEffectMode < (int)modes.size())
+    && (modes[SoftwareEffectMode].value == active_mode))
+    {
+        return(SoftwareEffectMode);
+    }
+
     return(active_mode);
 }
 
 void RGBController::SetMode(int mode)
 {
-    active_mode = mode;
+    SelectMode(mode);
 
     UpdateMode();
 }
 
+void RGBController::SelectMode(int mode)
+{
+    std::lock_guard<std::recursive_mutex> lock(UpdateMutex);
+
+    /*-------------------------------------------------*\
+    | A software effect puts the device in the hardware |
+    | mode stored in its value while it renders         |
+    \*-------------------------------------------------*/
+    if((mode >= 0) && (mode < (int)modes.size()) && (modes[mode].flags & MODE_FLAG_SOFTWARE_EFFECT))
+    {
+        SoftwareEffectMode  = mode;
+        active_mode         = modes[mode].value;
+    }
+    else
+    {
+        SoftwareEffectMode  = -1;
+        active_mode         = mode;
+    }
+}
+
 void RGBController::RegisterUpdateCallback(RGBControllerCallback new_callback, void * new_callback_arg)
 {
+    std::lock_guard<std::recursive_mutex> lock(UpdateMutex);
+
     UpdateCallbacks.push_back(new_callback);
     UpdateCallbackArgs.push_back(new_callback_arg);
 }
 
 void RGBController::UnregisterUpdateCallback(void * callback_arg)
 {
-    for(unsigned int callback_idx = 0; callback_idx < UpdateCallbackArgs.size(); callback_idx++ )
     {
-        if(UpdateCallbackArgs[callback_idx] == callback_arg)
+        std::lock_guard<std::recursive_mutex> lock(UpdateMutex);
+
+        for(unsigned int callback_idx = 0; callback_idx < UpdateCallbackArgs.size(); callback_idx++ )
         {
-            UpdateCallbackArgs.erase(UpdateCallbackArgs.begin() + callback_idx);
-            UpdateCallbacks.erase(UpdateCallbacks.begin() + callback_idx);
+            if(UpdateCallbackArgs[callback_idx] == callback_arg)
+            {
+                UpdateCallbackArgs.erase(UpdateCallbackArgs.begin() + callback_idx);
+                UpdateCallbacks.erase(UpdateCallbacks.begin() + callback_idx);
 
-            break;
+                break;
+            }
         }
     }
+
+    WaitForDispatch();
 }
 
 void RGBController::ClearCallbacks()
 {
-    UpdateCallbacks.clear();
-    UpdateCallbackArgs.clear();
+    {
+        std::lock_guard<std::recursive_mutex> lock(UpdateMutex);
+
+        UpdateCallbacks.clear();
+        UpdateCallbackArgs.clear();
+    }
+
+    WaitForDispatch();
+}
+
+void RGBController::Shutdown()
+{
+    /*-------------------------------------------------*\
+    | Stop the device call thread, letting a call that  |
+    | is in progress finish first                       |
+    \*-------------------------------------------------*/
+    if(DeviceCallThread != nullptr)
+    {
+        DeviceThreadRunning = false;
+        SignalDeviceThread();
+        DeviceCallThread->join();
+        delete DeviceCallThread;
+        DeviceCallThread = nullptr;
+    }
+
+    UpdateDispatchState* state = GetUpdateDispatchState();
+
+    std::unique_lock<std::mutex> lock(state->dispatch_mutex);
+
+    /*-------------------------------------------------*\
+    | Leave the pending flag set so that later signals  |
+    | are dropped instead of queueing this controller   |
+    \*-------------------------------------------------*/
+    UpdatePending = true;
+
+    /*-------------------------------------------------*\
+    | Take the queue so this controller can be removed  |
+    | from it, the others stay queued in the batch      |
+    \*-------------------------------------------------*/
+    TakeUpdateQueue(state->queue_head.exchange(nullptr, std::memory_order_acquire), state->batch);
+
+    std::replace(state->batch.begin(), state->batch.end(), this, (RGBController*)nullptr);
+
+    if(!state->batch.empty())
+    {
+        state->wake_cv.notify_one();
+    }
+
+    lock.unlock();
+
+    WaitForDispatch();
+}
+
+void RGBController::WaitForDispatch()
+{
+    UpdateDispatchState* state = GetUpdateDispatchState();
+
+    std::unique_lock<std::mutex> lock(state->dispatch_mutex);
+
+    /*-------------------------------------------------*\
+    | Callbacks are called from a copy of the list, so  |
+    | wait for a notification that is being delivered   |
+    | to finish.  A callback on the dispatcher thread   |
+    | may delete other controllers, but not the one it  |
+    | is being called for                               |
+    \*-------------------------------------------------*/
+    if(std::this_thread::get_id() != state->thread_id)
+    {
+        state->dispatch_cv.wait(lock, [this, state]{ return(state->dispatching != this); });
+    }
+}
+
+void RGBController::TakeUpdateQueue(RGBController* head, std::vector<RGBController*>& batch)
+{
+    /*-------------------------------------------------*\
+    | Append the queued controllers to the batch in     |
+    | signal order.  Called with dispatch_mutex held    |
+    \*-------------------------------------------------*/
+    std::size_t batch_start = batch.size();
+
+    for(RGBController* controller = head; controller != nullptr; controller = controller->UpdateQueueNext)
+    {
+        batch.push_back(controller);
+    }
+
+    std::reverse(batch.begin() + batch_start, batch.end());
 }
 
 void RGBController::SignalUpdate()
 {
-    UpdateMutex.lock();
+    UpdateDispatchState* state = GetUpdateDispatchState();
+
+    /*-------------------------------------------------*\
+    | Start the dispatcher thread on first use          |
+    \*-------------------------------------------------*/
+    static std::once_flag dispatch_thread_started;
+
+    std::call_once(dispatch_thread_started, []
+    {
+        std::thread(&RGBController::UpdateDispatchThreadFunction).detach();
+    });
+
+    state->stats_signals++;
+
+    /*-------------------------------------------------*\
+    | If an update is already pending for this device,  |
+    | it will pick up this change as well               |
+    \*-------------------------------------------------*/
+    if(UpdatePending.exchange(true))
+    {
+        return;
+    }
+
+    /*-------------------------------------------------*\
+    | Push this controller onto the dispatch queue      |
+    \*-------------------------------------------------*/
+    UpdateQueueTime = std::chrono::steady_clock::now();
+
+    RGBController* head = state->queue_head.load(std::memory_order_relaxed);
+
+    do
+    {
+        UpdateQueueNext = head;
+    } while(!state->queue_head.compare_exchange_weak(head, this, std::memory_order_release, std::memory_order_relaxed));
+
+    /*-------------------------------------------------*\
+    | Wake the dispatcher if the queue was empty.  The  |
+    | mutex is taken so the wakeup cannot be lost       |
+    | between the dispatcher checking and waiting       |
+    \*-------------------------------------------------*/
+    if(head == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(state->dispatch_mutex);
+
+        state->wake_cv.notify_one();
+    }
+}
+
+void RGBController::DispatchUpdate()
+{
+    std::vector<RGBControllerCallback>  callbacks;
+    std::vector<void *>                 callback_args;
+
+    /*-------------------------------------------------*\
+    | Clear the pending flag before calling out so that |
+    | changes made during the callbacks are signalled   |
+    | again, and copy the callbacks so that a slow      |
+    | device holding UpdateMutex does not stall the     |
+    | shared dispatcher                                 |
+    \*-------------------------------------------------*/
+    {
+        std::lock_guard<std::recursive_mutex> lock(UpdateMutex);
+
+        UpdatePending   = false;
+        callbacks       = UpdateCallbacks;
+        callback_args   = UpdateCallbackArgs;
+    }
 
     /*-------------------------------------------------*\
     | Client info has changed, call the callbacks       |
     \*-------------------------------------------------*/
-    for(unsigned int callback_idx = 0; callback_idx < UpdateCallbacks.size(); callback_idx++)
+    for(unsigned int callback_idx = 0; callback_idx < callbacks.size(); callback_idx++)
+    {
+        callbacks[callback_idx](callback_args[callback_idx]);
+    }
+}
+
+void RGBController::UpdateDispatchThreadFunction()
+{
+    UpdateDispatchState* state = GetUpdateDispatchState();
+
+    std::chrono::steady_clock::time_point   stats_start         = std::chrono::steady_clock::now();
+    std::chrono::nanoseconds                stats_latency       = std::chrono::nanoseconds(0);
+    std::chrono::nanoseconds                stats_latency_max   = std::chrono::nanoseconds(0);
+    unsigned int                            stats_dispatched    = 0;
+
     {
-        UpdateCallbacks[callback_idx](UpdateCallbackArgs[callback_idx]);
+        std::lock_guard<std::mutex> lock(state->dispatch_mutex);
+
+        state->thread_id = std::this_thread::get_id();
     }
 
-    UpdateMutex.unlock();
+    while(true)
+    {
+        /*-------------------------------------------------*\
+        | Wait for work, either newly queued controllers or |
+        | a batch left behind by Shutdown, then take the    |
+        | whole queue into the batch                        |
+        \*-------------------------------------------------*/
+        {
+            std::unique_lock<std::mutex> lock(state->dispatch_mutex);
+
+            state->wake_cv.wait(lock, [state]{ return((state->queue_head.load() != nullptr) || !state->batch.empty()); });
+
+            TakeUpdateQueue(state->queue_head.exchange(nullptr, std::memory_order_acquire), state->batch);
+        }
+
+        std::chrono::steady_clock::time_point dispatch_time = std::chrono::steady_clock::now();
+
+        /*-------------------------------------------------*\
+        | Deliver the batch one controller at a time.       |
+        | Controllers removed by Shutdown are left as null  |
+        | entries and skipped                               |
+        \*-------------------------------------------------*/
+        for(std::size_t batch_idx = 0; ; batch_idx++)
+        {
+            RGBController* controller;
+
+            {
+                std::lock_guard<std::mutex> lock(state->dispatch_mutex);
+
+                if(batch_idx >= state->batch.size())
+                {
+                    state->batch.clear();
+                    break;
+                }
+
+                controller          = state->batch[batch_idx];
+                state->dispatching  = controller;
+            }
+
+            if(controller != nullptr)
+            {
+                std::chrono::nanoseconds latency = dispatch_time - controller->UpdateQueueTime;
+
+                stats_latency      += latency;
+                stats_latency_max   = std::max(stats_latency_max, latency);
+                stats_dispatched++;
+
+                controller->DispatchUpdate();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(state->dispatch_mutex);
+
+                state->dispatching  = nullptr;
+            }
+
+            state->dispatch_cv.notify_all();
+        }
+
+        /*-------------------------------------------------*\
+        | Periodically report latency and coalescing        |
+        \*-------------------------------------------------*/
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if((now - stats_start) >= std::chrono::milliseconds(UPDATE_DISPATCH_STATS_INTERVAL_MS) && stats_dispatched > 0)
+        {
+            unsigned int signals = state->stats_signals.exchange(0);
+
+            LOG_TRACE("[RGBController] Update dispatch: %u signals, %u notifications, coalesce ratio %.2f, latency avg %.1f us max %.1f us",
+                      signals,
+                      stats_dispatched,
+                      (double)signals / stats_dispatched,
+                      std::chrono::duration<double, std::micro>(stats_latency).count() / stats_dispatched,
+                      std::chrono::duration<double, std::micro>(stats_latency_max).count());
+
+            stats_start         = now;
+            stats_latency       = std::chrono::nanoseconds(0);
+            stats_latency_max   = std::chrono::nanoseconds(0);
+            stats_dispatched    = 0;
+        }
+    }
 }
+
 void RGBController::UpdateLEDs()
 {
     CallFlag_UpdateLEDs = true;
+    SignalDeviceThread();
 
     SignalUpdate();
 }
@@ -1649,13 +2016,145 @@ void RGBController::UpdateLEDs()
 void RGBController::UpdateMode()
 {
     CallFlag_UpdateMode = true;
+    SignalDeviceThread();
+}
+
+void RGBController::SignalDeviceThread()
+{
+    /*-------------------------------------------------*\
+    | Take the lock so the wakeup cannot be lost        |
+    | between the device thread checking the flags and  |
+    | starting to wait                                  |
+    \*-------------------------------------------------*/
+    std::lock_guard<std::mutex> lock(DeviceCallMutex);
+    DeviceCallCV.notify_one();
 }
 
 void RGBController::SaveMode()
 {
+    /*-------------------------------------------------*\
+    | Software effects only exist on the server, there  |
+    | is nothing to save to the device                  |
+    \*-------------------------------------------------*/
+    int mode_idx = GetMode();
+
+    if((mode_idx >= 0) && (mode_idx < (int)modes.size()) && (modes[mode_idx].flags & MODE_FLAG_SOFTWARE_EFFECT))
+    {
+        return;
+    }
+
     DeviceSaveMode();
 }
 
+void RGBController::SetCalibration(int zone, const RGBColorLUT* lut)
+{
+    std::lock_guard<std::mutex> lock(CalibrationMutex);
+
+    /*-------------------------------------------------*\
+    | Zone -1 sets the table for the whole device       |
+    \*-------------------------------------------------*/
+    RGBColorLUT** target;
+
+    if(zone < 0)
+    {
+        target = &CalibrationLUT;
+    }
+    else
+    {
+        if((unsigned int)zone >= CalibrationZoneLUTs.size())
+        {
+            CalibrationZoneLUTs.resize(zone + 1, nullptr);
+        }
+
+        target = &CalibrationZoneLUTs[zone];
+    }
+
+    if(lut == nullptr)
+    {
+        delete *target;
+        *target = nullptr;
+    }
+    else
+    {
+        if(*target == nullptr)
+        {
+            *target = new RGBColorLUT;
+        }
+
+        **target = *lut;
+    }
+
+    /*-------------------------------------------------*\
+    | Only take the calibrated path if any table is set |
+    \*-------------------------------------------------*/
+    bool enabled = (CalibrationLUT != nullptr);
+
+    for(std::size_t zone_idx = 0; zone_idx < CalibrationZoneLUTs.size(); zone_idx++)
+    {
+        enabled |= (CalibrationZoneLUTs[zone_idx] != nullptr);
+    }
+
+    CalibrationEnabled = enabled;
+}
+
+void RGBController::ClearCalibration()
+{
+    std::lock_guard<std::mutex> lock(CalibrationMutex);
+
+    delete CalibrationLUT;
+    CalibrationLUT = nullptr;
+
+    for(std::size_t zone_idx = 0; zone_idx < CalibrationZoneLUTs.size(); zone_idx++)
+    {
+        delete CalibrationZoneLUTs[zone_idx];
+    }
+
+    CalibrationZoneLUTs.clear();
+    CalibrationEnabled = false;
+}
+
+void RGBController::CalibratedUpdateLEDs()
+{
+    std::lock_guard<std::mutex>             lock(CalibrationMutex);
+    std::lock_guard<std::recursive_mutex>   color_lock(ColorMutex);
+
+    /*-------------------------------------------------*\
+    | Save the requested colors and correct colors in   |
+    | place zone by zone, so that DeviceUpdateLEDs and  |
+    | the zone color pointers see the calibrated values |
+    \*-------------------------------------------------*/
+    CalibrationSaved.assign(colors.begin(), colors.end());
+
+    for(std::size_t zone_idx = 0; zone_idx < zones.size(); zone_idx++)
+    {
+        RGBColorLUT* lut = CalibrationLUT;
+
+        if((zone_idx < CalibrationZoneLUTs.size()) && (CalibrationZoneLUTs[zone_idx] != nullptr))
+        {
+            lut = CalibrationZoneLUTs[zone_idx];
+        }
+
+        unsigned int start_idx  = zones[zone_idx].start_idx;
+        unsigned int leds_count = zones[zone_idx].leds_count;
+
+        if((lut == nullptr) || (start_idx + leds_count > colors.size()))
+        {
+            continue;
+        }
+
+        RGBColorApplyLUT(&colors[start_idx], &colors[start_idx], leds_count, lut);
+    }
+
+    DeviceUpdateLEDs();
+
+    /*-------------------------------------------------*\
+    | Restore the requested colors.  Client reads and   |
+    | writes wait on ColorMutex, so none are lost and   |
+    | the calibrated values are never read back         |
+    \*-------------------------------------------------*/
+    std::copy(CalibrationSaved.begin(), CalibrationSaved.begin() + std::min(CalibrationSaved.size(), colors.size()), colors.begin());
+}
+
 void RGBController::DeviceUpdateLEDs()
 {
 
@@ -1687,7 +2186,7 @@ void RGBController::SetCustomMode()
             && ((modes[mode_idx].color_mode == MODE_COLORS_PER_LED)
              || (modes[mode_idx].color_mode == MODE_COLORS_MODE_SPECIFIC)))
             {
-                active_mode = mode_idx;
+                SelectMode(mode_idx);
                 return;
             }
         }
@@ -1706,19 +2205,37 @@ void RGBController::DeviceCallThreadFunction()
 
     while(DeviceThreadRunning.load() == true)
     {
-        if(CallFlag_UpdateMode.load() == true)
+        /*-------------------------------------------------*\
+        | Clear each flag before making the device call, so |
+        | a request that arrives during the call is run     |
+        | again afterwards                                  |
+        \*-------------------------------------------------*/
+        if(CallFlag_UpdateMode.exchange(false) == true)
         {
             DeviceUpdateMode();
-            CallFlag_UpdateMode = false;
         }
-        if(CallFlag_UpdateLEDs.load() == true)
+        if(CallFlag_UpdateLEDs.exchange(false) == true)
         {
-            DeviceUpdateLEDs();
-            CallFlag_UpdateLEDs = false;
+            if(CalibrationEnabled.load() == true)
+            {
+                CalibratedUpdateLEDs();
+            }
+            else
+            {
+                DeviceUpdateLEDs();
+            }
         }
         else
         {
-           std::this_thread::sleep_for(1ms);
+            /*-------------------------------------------------*\
+            | Sleep until an update is requested                |
+            \*-------------------------------------------------*/
+            std::unique_lock<std::mutex> lock(DeviceCallMutex);
+
+            DeviceCallCV.wait(lock, [this]
+            {
+                return(CallFlag_UpdateLEDs.load() || CallFlag_UpdateMode.load() || !DeviceThreadRunning.load());
+            });
         }
     }
 }
@@ -15,6 +15,7 @@
 #include <thread>
 #include <chrono>
 #include <mutex>
+#include <condition_variable>
 
 /*------------------------------------------------------------------*\
 | RGB Color Type and Conversion Macros                               |
@@ -27,6 +28,8 @@ typedef unsigned int RGBColor;
 
 #define ToRGBColor(r, g, b) ((RGBColor)((b << 16) | (g << 8) | (r)))
 
+struct RGBColorLUT;
+
 /*------------------------------------------------------------------*\
 | Mode Flags                                                         |
 \*------------------------------------------------------------------*/
@@ -42,6 +45,7 @@ enum
     MODE_FLAG_HAS_RANDOM_COLOR          = (1 << 7), /* Mode has random color option     */
     MODE_FLAG_MANUAL_SAVE               = (1 << 8), /* Mode can manually be saved       */
     MODE_FLAG_AUTOMATIC_SAVE            = (1 << 9), /* Mode automatically saves         */
+    MODE_FLAG_SOFTWARE_EFFECT           = (1 << 10),/* Mode is rendered by the server   */
 };
 
 /*------------------------------------------------------------------*\
@@ -295,6 +299,7 @@ public:
 
     int                     GetMode();
     void                    SetMode(int mode);
+    void                    SelectMode(int mode);
 
     unsigned char *         GetDeviceDescription(unsigned int protocol_version);
     void                    ReadDeviceDescription(unsigned char* data_buf, unsigned int protocol_version);
@@ -316,6 +321,14 @@ public:
     void                    ClearCallbacks();
     void                    SignalUpdate();
 
+    /*---------------------------------------------------------*\
+    | Stop the device call thread and remove the controller     |
+    | from the update dispatcher.  Owners call this before      |
+    | deleting a controller so that no device call or update    |
+    | notification runs while derived destructors tear down     |
+    \*---------------------------------------------------------*/
+    void                    Shutdown();
+
     void                    UpdateLEDs();
     //void                    UpdateZoneLEDs(int zone);
     //void                    UpdateSingleLED(int led);
@@ -323,6 +336,9 @@ public:
     void                    UpdateMode();
     void                    SaveMode();
 
+    void                    SetCalibration(int zone, const RGBColorLUT* lut);
+    void                    ClearCalibration();
+
     void                    DeviceCallThreadFunction();
 
     /*---------------------------------------------------------*\
@@ -346,11 +362,55 @@ private:
     std::atomic<bool>       CallFlag_UpdateLEDs;
     std::atomic<bool>       CallFlag_UpdateMode;
     std::atomic<bool>       DeviceThreadRunning;
+    std::mutex              DeviceCallMutex;
+    std::condition_variable DeviceCallCV;
+
+    void                    SignalDeviceThread();
     //bool                    CallFlag_UpdateZoneLEDs                     = false;
     //bool                    CallFlag_UpdateSingleLED                    = false;
     //bool                    CallFlag_UpdateMode                         = false;
 
-    std::mutex                          UpdateMutex;
+    /*---------------------------------------------------------*\
+    | Update callbacks are delivered on a shared dispatcher     |
+    | thread.  UpdatePending coalesces repeated signals so a    |
+    | controller is queued at most once per dispatch.           |
+    | UpdateMutex also guards the mode selection                |
+    \*---------------------------------------------------------*/
+    std::recursive_mutex                UpdateMutex;
     std::vector<RGBControllerCallback>  UpdateCallbacks;
     std::vector<void *>                 UpdateCallbackArgs;
+
+    std::atomic<bool>                   UpdatePending;
+    RGBController*                      UpdateQueueNext;
+    std::chrono::steady_clock::time_point UpdateQueueTime;
+
+    void                    DispatchUpdate();
+    void                    WaitForDispatch();
+    static void             TakeUpdateQueue(RGBController* head, std::vector<RGBController*>& batch);
+    static void             UpdateDispatchThreadFunction();
+
+    /*---------------------------------------------------------*\
+    | Index of the selected software effect mode, or -1.  While |
+    | an effect is selected active_mode holds the hardware mode |
+    | stored in its value, so drivers only ever see their own   |
+    | modes in active_mode                                      |
+    \*---------------------------------------------------------*/
+    int                                 SoftwareEffectMode = -1;
+
+    /*---------------------------------------------------------*\
+    | Calibration lookup tables applied to colors for the       |
+    | duration of DeviceUpdateLEDs, with the requested colors   |
+    | saved and restored around it.  A zone table takes         |
+    | precedence over the device table, zones with neither are  |
+    | passed through unchanged.  ColorMutex is held by the      |
+    | color accessors so they never see the calibrated values   |
+    \*---------------------------------------------------------*/
+    std::recursive_mutex                ColorMutex;
+    std::mutex                          CalibrationMutex;
+    std::atomic<bool>                   CalibrationEnabled;
+    RGBColorLUT*                        CalibrationLUT;
+    std::vector<RGBColorLUT*>           CalibrationZoneLUTs;
+    std::vector<RGBColor>               CalibrationSaved;
+
+    void                    CalibratedUpdateLEDs();
 };
@@ -72,7 +72,7 @@ void RGBController_Network::SetCustomMode()
 
 void RGBController_Network::DeviceUpdateMode()
 {
-    unsigned char * data = GetModeDescription(active_mode, client->GetProtocolVersion());
+    unsigned char * data = GetModeDescription(GetMode(), client->GetProtocolVersion());
     unsigned int size;
 
     memcpy(&size, &data[0], sizeof(unsigned int));
@@ -84,7 +84,7 @@ void RGBController_Network::DeviceUpdateMode()
 
 void RGBController_Network::DeviceSaveMode()
 {
-    unsigned char * data = GetModeDescription(active_mode, client->GetProtocolVersion());
+    unsigned char * data = GetModeDescription(GetMode(), client->GetProtocolVersion());
     unsigned int size;
 
     memcpy(&size, &data[0], sizeof(unsigned int));
@@ -14,6 +14,9 @@
 #include "LogManager.h"
 #include "filesystem.h"
 #include "StringUtils.h"
+#include "RGBColorPack.h"
+#include "hidapi_mock.h"
+#include "i2c_smbus_scheduler.h"
 
 #ifdef _WIN32
 #include <codecvt>
@@ -27,6 +30,9 @@
 const hidapi_wrapper default_wrapper =
 {
     NULL,
+    (hidapi_wrapper_write)                      hid_write,
+    (hidapi_wrapper_read)                       hid_read,
+    (hidapi_wrapper_read_timeout)               hid_read_timeout,
     (hidapi_wrapper_send_feature_report)        hid_send_feature_report,
     (hidapi_wrapper_get_feature_report)         hid_get_feature_report,
     (hidapi_wrapper_get_serial_number_string)   hid_get_serial_number_string,
@@ -141,17 +147,55 @@ ResourceManager::ResourceManager()
     profile_manager         = new ProfileManager(GetConfigurationDirectory());
     server->SetProfileManager(profile_manager);
     rgb_controllers_sizes   = profile_manager->LoadProfileToList("sizes", true);
+
+    /*-------------------------------------------------------------------------*\
+    | Initialize Effects Engine if enabled                                      |
+    \*-------------------------------------------------------------------------*/
+    json effects_settings   = settings_manager->GetSettings("EffectsEngine");
+    effects_engine          = nullptr;
+
+    if(effects_settings.contains("enabled") && effects_settings["enabled"] == true)
+    {
+        unsigned int fps    = EFFECTS_ENGINE_DEFAULT_FPS;
+
+        if(effects_settings.contains("fps"))
+        {
+            fps             = effects_settings["fps"];
+        }
+
+        effects_engine      = new EffectsEngine(fps, settings_manager->GetSettings("Scene"));
+    }
 }
 
 ResourceManager::~ResourceManager()
 {
     Cleanup();
+
+    delete effects_engine;
 }
 
 void ResourceManager::RegisterI2CBus(i2c_smbus_interface *bus)
 {
     LOG_INFO("Registering I2C interface: %s Device %04X:%04X Subsystem: %04X:%04X", bus->device_name, bus->pci_vendor, bus->pci_device,bus->pci_subsystem_vendor,bus->pci_subsystem_device);
     busses.push_back(bus);
+
+    /*-------------------------------------------------*\
+    | Start the bus frame scheduler if enabled, devices |
+    | detected on this bus will register with it        |
+    \*-------------------------------------------------*/
+    json scheduler_settings = settings_manager->GetSettings("SMBusScheduler");
+
+    if(scheduler_settings.contains("enabled") && scheduler_settings["enabled"] == true)
+    {
+        unsigned int fps = I2C_SMBUS_SCHEDULER_DEFAULT_FPS;
+
+        if(scheduler_settings.contains("fps") && scheduler_settings["fps"].is_number_unsigned())
+        {
+            fps = scheduler_settings["fps"];
+        }
+
+        bus->i2c_smbus_enable_scheduler(fps);
+    }
 }
 
 std::vector<i2c_smbus_interface*> & ResourceManager::GetI2CBusses()
@@ -162,6 +206,16 @@ std::vector<i2c_smbus_interface*> & ResourceManager::GetI2CBusses()
 void ResourceManager::RegisterRGBController(RGBController *rgb_controller)
 {
     LOG_INFO("[%s] Registering RGB controller", rgb_controller->name.c_str());
+
+    /*-------------------------------------------------*\
+    | Add the software effect modes before the          |
+    | controller is visible to any other thread         |
+    \*-------------------------------------------------*/
+    if(effects_engine != nullptr)
+    {
+        effects_engine->RegisterController(rgb_controller);
+    }
+
     rgb_controllers_hw.push_back(rgb_controller);
 
     /*-------------------------------------------------*\
@@ -176,11 +230,13 @@ void ResourceManager::RegisterRGBController(RGBController *rgb_controller)
     if(rgb_controllers_hw.size() != detection_prev_size)
     {
         /*-------------------------------------------------*\
-        | First, load sizes for the new controllers         |
+        | First, load sizes and calibration for the new     |
+        | controllers                                       |
         \*-------------------------------------------------*/
         for(unsigned int controller_size_idx = detection_prev_size; controller_size_idx < rgb_controllers_hw.size(); controller_size_idx++)
         {
             profile_manager->LoadDeviceFromListWithOptions(rgb_controllers_sizes, detection_size_entry_used, rgb_controllers_hw[controller_size_idx], true, false);
+            LoadCalibration(rgb_controllers_hw[controller_size_idx]);
         }
 
         UpdateDeviceList();
@@ -190,6 +246,122 @@ void ResourceManager::RegisterRGBController(RGBController *rgb_controller)
     UpdateDeviceList();
 }
 
+/*---------------------------------------------------------*\
+| Calibration settings format:                              |
+|                                                           |
+| "Calibration" :                                           |
+| {                                                         |
+|   "devices" :                                             |
+|   [                                                       |
+|     {                                                     |
+|       "name"          : "LED Strip",                      |
+|       "location"      : "COM3",      (optional)           |
+|       "serial"        : "",          (optional)           |
+|       "gamma"         : 2.2,                              |
+|       "brightness"    : 1.0,                              |
+|       "white_point"   : [ 255, 220, 180 ],                |
+|       "gains"         : [ 1.0, 1.0, 1.0 ],                |
+|       "zones"         :                                   |
+|       {                                                   |
+|         "Zone Name"   : { same keys as above }            |
+|       }                                                   |
+|     }                                                     |
+|   ]                                                       |
+| }                                                         |
+|                                                           |
+| white_point is the output for full white, it scales each  |
+| channel in addition to its gain                           |
+\*---------------------------------------------------------*/
+static void CalibrationLUTFromSettings(const json& settings, RGBColorLUT* lut)
+{
+    float gamma         = 1.0f;
+    float brightness    = 1.0f;
+    float gains[3]      = { 1.0f, 1.0f, 1.0f };
+
+    if(settings.contains("gamma"))
+    {
+        gamma       = settings["gamma"];
+    }
+
+    if(settings.contains("brightness"))
+    {
+        brightness  = settings["brightness"];
+    }
+
+    for(unsigned int channel_idx = 0; channel_idx < 3; channel_idx++)
+    {
+        if(settings.contains("gains") && (settings["gains"].size() == 3))
+        {
+            gains[channel_idx]  = settings["gains"][channel_idx];
+        }
+
+        if(settings.contains("white_point") && (settings["white_point"].size() == 3))
+        {
+            float white         = settings["white_point"][channel_idx];
+
+            gains[channel_idx] *= white / 255.0f;
+        }
+    }
+
+    RGBColorLUTInit(lut, gamma, brightness, gains[0], gains[1], gains[2]);
+}
+
+void ResourceManager::LoadCalibration(RGBController* rgb_controller)
+{
+    json calibration_settings = settings_manager->GetSettings("Calibration");
+
+    if(!calibration_settings.contains("devices"))
+    {
+        return;
+    }
+
+    for(unsigned int device_idx = 0; device_idx < calibration_settings["devices"].size(); device_idx++)
+    {
+        json device_settings = calibration_settings["devices"][device_idx];
+
+        if(!device_settings.contains("name") || (device_settings["name"] != rgb_controller->name))
+        {
+            continue;
+        }
+
+        if(device_settings.contains("location") && (device_settings["location"] != rgb_controller->location))
+        {
+            continue;
+        }
+
+        if(device_settings.contains("serial") && (device_settings["serial"] != rgb_controller->serial))
+        {
+            continue;
+        }
+
+        RGBColorLUT lut;
+
+        rgb_controller->ClearCalibration();
+
+        if(device_settings.contains("gamma") || device_settings.contains("brightness")
+        || device_settings.contains("gains") || device_settings.contains("white_point"))
+        {
+            CalibrationLUTFromSettings(device_settings, &lut);
+            rgb_controller->SetCalibration(-1, &lut);
+        }
+
+        if(device_settings.contains("zones"))
+        {
+            for(unsigned int zone_idx = 0; zone_idx < rgb_controller->zones.size(); zone_idx++)
+            {
+                if(device_settings["zones"].contains(rgb_controller->zones[zone_idx].name))
+                {
+                    CalibrationLUTFromSettings(device_settings["zones"][rgb_controller->zones[zone_idx].name], &lut);
+                    rgb_controller->SetCalibration(zone_idx, &lut);
+                }
+            }
+        }
+
+        LOG_INFO("[%s] Loaded color calibration", rgb_controller->name.c_str());
+        break;
+    }
+}
+
 void ResourceManager::UnregisterRGBController(RGBController* rgb_controller)
 {
     LOG_INFO("[%s] Unregistering RGB controller", rgb_controller->name.c_str());
@@ -199,6 +371,11 @@ void ResourceManager::UnregisterRGBController(RGBController* rgb_controller)
     \*-------------------------------------------------------------------------*/
     rgb_controller->ClearCallbacks();
 
+    if(effects_engine != nullptr)
+    {
+        effects_engine->UnregisterController(rgb_controller);
+    }
+
     /*-------------------------------------------------------------------------*\
     | Find the controller to remove and remove it from the hardware list        |
     \*-------------------------------------------------------------------------*/
@@ -673,11 +850,37 @@ void ResourceManager::Cleanup()
     rgb_controllers_hw.clear();
     detection_prev_size = 0;
 
+    /*-------------------------------------------------*\
+    | Inform clients connected to this server, ending   |
+    | their color subscriptions before the controllers  |
+    | are deleted                                       |
+    \*-------------------------------------------------*/
+    server->DeviceListChanged();
+
+    if(effects_engine != nullptr)
+    {
+        effects_engine->ClearControllers();
+    }
+
     for(RGBController* rgb_controller : rgb_controllers_hw_copy)
     {
+        rgb_controller->Shutdown();
         delete rgb_controller;
     }
 
+    /*-------------------------------------------------*\
+    | If the mock HID backend was used, save the        |
+    | captured reports for offline analysis             |
+    \*-------------------------------------------------*/
+    json detector_settings = settings_manager->GetSettings("Detectors");
+
+    if(hidapi_mock_is_loaded() && detector_settings.contains("hid_mock_capture"))
+    {
+        std::string capture_filename = detector_settings["hid_mock_capture"];
+
+        hidapi_mock_save_reports(capture_filename);
+    }
+
     std::vector<i2c_smbus_interface *> busses_copy = busses;
 
     busses.clear();
@@ -840,6 +1043,22 @@ void ResourceManager::DetectDevicesThreadFunction()
     \*-------------------------------------------------*/
     detector_settings = settings_manager->GetSettings("Detectors");
 
+    /*-------------------------------------------------*\
+    | Load the mock HID fixture if one is configured.   |
+    | Builds linked against the mock backend serve all  |
+    | hidapi calls from it, so it is loaded before the  |
+    | HID devices are enumerated                        |
+    \*-------------------------------------------------*/
+    if(detector_settings.contains("hid_mock_fixture"))
+    {
+        std::string fixture_filename = detector_settings["hid_mock_fixture"];
+
+        if(!hidapi_mock_load_fixture(fixture_filename))
+        {
+            LOG_WARNING("[ResourceManager] Failed to load HID mock fixture %s", fixture_filename.c_str());
+        }
+    }
+
     /*-------------------------------------------------*\
     | Initialize HID interface for detection            |
     \*-------------------------------------------------*/
@@ -960,11 +1179,13 @@ void ResourceManager::DetectDevicesThreadFunction()
         if(rgb_controllers_hw.size() != detection_prev_size)
         {
             /*-------------------------------------------------*\
-            | First, load sizes for the new controllers         |
+            | First, load sizes and calibration for the new     |
+            | controllers                                       |
             \*-------------------------------------------------*/
             for(unsigned int controller_size_idx = detection_prev_size; controller_size_idx < rgb_controllers_hw.size(); controller_size_idx++)
             {
                 profile_manager->LoadDeviceFromListWithOptions(rgb_controllers_sizes, detection_size_entry_used, rgb_controllers_hw[controller_size_idx], true, false);
+                LoadCalibration(rgb_controllers_hw[controller_size_idx]);
             }
 
             UpdateDeviceList();
@@ -1170,47 +1391,13 @@ void ResourceManager::DetectDevicesThreadFunction()
             }
 
             /*-----------------------------------------------------------------------------*\
-            | Loop through all available wrapped HID detectors.  If all required            |
-            | information matches, run the detector                                         |
+            | Run the wrapped HID detectors with the default hidapi functions               |
             \*-----------------------------------------------------------------------------*/
-            for(unsigned int hid_detector_idx = 0; hid_detector_idx < hid_wrapped_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
-            {
-                if(( (     hid_wrapped_device_detectors[hid_detector_idx].address    == addr                                 ) )
 #ifdef USE_HID_USAGE
-                && ( (     hid_wrapped_device_detectors[hid_detector_idx].usage_page == HID_USAGE_PAGE_ANY                   )
-                  || (     hid_wrapped_device_detectors[hid_detector_idx].usage_page == current_hid_device->usage_page       ) )
-                && ( (     hid_wrapped_device_detectors[hid_detector_idx].usage      == HID_USAGE_ANY                        )
-                  || (     hid_wrapped_device_detectors[hid_detector_idx].usage      == current_hid_device->usage            ) )
-                && ( (     hid_wrapped_device_detectors[hid_detector_idx].interface  == HID_INTERFACE_ANY                    )
-                  || (     hid_wrapped_device_detectors[hid_detector_idx].interface  == current_hid_device->interface_number ) )
+            DetectHIDWrappedDevice(default_wrapper, current_hid_device, detector_settings, true);
 #else
-                && ( (     hid_wrapped_device_detectors[hid_detector_idx].interface  == HID_INTERFACE_ANY                    )
-                  || (     hid_wrapped_device_detectors[hid_detector_idx].interface  == current_hid_device->interface_number ) )
+            DetectHIDWrappedDevice(default_wrapper, current_hid_device, detector_settings, false);
 #endif
-                )
-                {
-                    detection_string = hid_wrapped_device_detectors[hid_detector_idx].name.c_str();
-
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled or needs to be  |
-                    | added to the settings list                        |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-                    {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
-                    }
-
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
-
-                    if(this_device_enabled)
-                    {
-                        DetectionProgressChanged();
-
-                        hid_wrapped_device_detectors[hid_detector_idx].function(default_wrapper, current_hid_device, hid_wrapped_device_detectors[hid_detector_idx].name);
-                    }
-                }
-            }
 
             /*-------------------------------------------------*\
             | Update detection percent                          |
@@ -1238,7 +1425,7 @@ void ResourceManager::DetectDevicesThreadFunction()
     |                                                   |
     | Reset current device pointer to first device      |
     \*-------------------------------------------------*/
-#ifdef __linux__
+#if defined(__linux__) && !defined(HIDAPI_MOCK_BACKEND)
     LOG_INFO("------------------------------------------------------");
     LOG_INFO("|            Detecting libusb HID devices            |");
     LOG_INFO("------------------------------------------------------");
@@ -1261,6 +1448,9 @@ void ResourceManager::DetectDevicesThreadFunction()
         wrapper =
         {
             .dyn_handle                     = dyn_handle,
+            .hid_write                      = (hidapi_wrapper_write)                        dlsym(dyn_handle,"hid_write"),
+            .hid_read                       = (hidapi_wrapper_read)                         dlsym(dyn_handle,"hid_read"),
+            .hid_read_timeout               = (hidapi_wrapper_read_timeout)                 dlsym(dyn_handle,"hid_read_timeout"),
             .hid_send_feature_report        = (hidapi_wrapper_send_feature_report)          dlsym(dyn_handle,"hid_send_feature_report"),
             .hid_get_feature_report         = (hidapi_wrapper_get_feature_report)           dlsym(dyn_handle,"hid_get_feature_report"),
             .hid_get_serial_number_string   = (hidapi_wrapper_get_serial_number_string)     dlsym(dyn_handle,"hid_get_serial_number_string"),
@@ -1292,45 +1482,10 @@ void ResourceManager::DetectDevicesThreadFunction()
             detection_string = "";
             DetectionProgressChanged();
 
-            unsigned int addr = (current_hid_device->vendor_id << 16) | current_hid_device->product_id;
-
             /*-----------------------------------------------------------------------------*\
-            | Loop through all available wrapped HID detectors.  If all required            |
-            | information matches, run the detector                                         |
+            | Run the wrapped HID detectors with the libusb hidapi functions                |
             \*-----------------------------------------------------------------------------*/
-            for(unsigned int hid_detector_idx = 0; hid_detector_idx < hid_wrapped_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
-            {
-                if(( (     hid_wrapped_device_detectors[hid_detector_idx].address    == addr                                 ) )
-                && ( (     hid_wrapped_device_detectors[hid_detector_idx].usage_page == HID_USAGE_PAGE_ANY                   )
-                    || (     hid_wrapped_device_detectors[hid_detector_idx].usage_page == current_hid_device->usage_page       ) )
-                && ( (     hid_wrapped_device_detectors[hid_detector_idx].usage      == HID_USAGE_ANY                        )
-                    || (     hid_wrapped_device_detectors[hid_detector_idx].usage      == current_hid_device->usage            ) )
-                && ( (     hid_wrapped_device_detectors[hid_detector_idx].interface  == HID_INTERFACE_ANY                    )
-                    || (     hid_wrapped_device_detectors[hid_detector_idx].interface  == current_hid_device->interface_number ) )
-                )
-                {
-                    detection_string = hid_wrapped_device_detectors[hid_detector_idx].name.c_str();
-
-                    /*-------------------------------------------------*\
-                    | Check if this detector is enabled or needs to be  |
-                    | added to the settings list                        |
-                    \*-------------------------------------------------*/
-                    bool this_device_enabled = true;
-                    if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
-                    {
-                        this_device_enabled = detector_settings["detectors"][detection_string];
-                    }
-
-                    LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
-
-                    if(this_device_enabled)
-                    {
-                        DetectionProgressChanged();
-
-                        hid_wrapped_device_detectors[hid_detector_idx].function(wrapper, current_hid_device, hid_wrapped_device_detectors[hid_detector_idx].name);
-                    }
-                }
-            }
+            DetectHIDWrappedDevice(wrapper, current_hid_device, detector_settings, true);
 
             /*-------------------------------------------------*\
             | Update detection percent                          |
@@ -1354,6 +1509,41 @@ void ResourceManager::DetectDevicesThreadFunction()
     }
 #endif
 
+    /*-------------------------------------------------*\
+    | Detect mock HID devices                           |
+    |                                                   |
+    | If a mock fixture is loaded, enumerate the        |
+    | simulated devices and run the wrapped detectors   |
+    | against the mock backend.  In builds linked       |
+    | against the mock backend, the HID pass above has  |
+    | already served every detector from the fixture    |
+    \*-------------------------------------------------*/
+#ifndef HIDAPI_MOCK_BACKEND
+    if(hidapi_mock_is_loaded())
+    {
+        LOG_INFO("------------------------------------------------------");
+        LOG_INFO("|              Detecting mock HID devices            |");
+        LOG_INFO("------------------------------------------------------");
+
+        hidapi_wrapper mock_wrapper = hidapi_mock_get_wrapper();
+
+        hid_devices = mock_wrapper.hid_enumerate(0, 0);
+
+        current_hid_device = hid_devices;
+
+        while(current_hid_device)
+        {
+            LOG_DEBUG("[%04X:%04X U=%04X P=0x%04X I=%d] %s", current_hid_device->vendor_id, current_hid_device->product_id, current_hid_device->usage, current_hid_device->usage_page, current_hid_device->interface_number, current_hid_device->path);
+
+            DetectHIDWrappedDevice(mock_wrapper, current_hid_device, detector_settings, true);
+
+            current_hid_device = current_hid_device->next;
+        }
+
+        mock_wrapper.hid_free_enumeration(hid_devices);
+    }
+#endif
+
     /*-------------------------------------------------*\
     | Detect other devices                              |
     \*-------------------------------------------------*/
@@ -1473,6 +1663,52 @@ void ResourceManager::DetectDevicesThreadFunction()
     }
 }
 
+/*-----------------------------------------------------------------------------*\
+| Loop through all available wrapped HID detectors.  If all required            |
+| information matches, run the detector with the given hidapi wrapper.  The     |
+| usage page and usage are only compared when the backend reports them          |
+\*-----------------------------------------------------------------------------*/
+void ResourceManager::DetectHIDWrappedDevice(const hidapi_wrapper& wrapper, hid_device_info* hid_device, const json& detector_settings, bool match_usage)
+{
+    unsigned int addr = (hid_device->vendor_id << 16) | hid_device->product_id;
+
+    for(unsigned int hid_detector_idx = 0; hid_detector_idx < hid_wrapped_device_detectors.size() && detection_is_required.load(); hid_detector_idx++)
+    {
+        if(( (     hid_wrapped_device_detectors[hid_detector_idx].address    == addr                           ) )
+        && ( !match_usage
+          || ( (   hid_wrapped_device_detectors[hid_detector_idx].usage_page == HID_USAGE_PAGE_ANY             )
+            || (   hid_wrapped_device_detectors[hid_detector_idx].usage_page == hid_device->usage_page         ) ) )
+        && ( !match_usage
+          || ( (   hid_wrapped_device_detectors[hid_detector_idx].usage      == HID_USAGE_ANY                  )
+            || (   hid_wrapped_device_detectors[hid_detector_idx].usage      == hid_device->usage              ) ) )
+        && ( (     hid_wrapped_device_detectors[hid_detector_idx].interface  == HID_INTERFACE_ANY              )
+          || (     hid_wrapped_device_detectors[hid_detector_idx].interface  == hid_device->interface_number   ) )
+        )
+        {
+            detection_string = hid_wrapped_device_detectors[hid_detector_idx].name.c_str();
+
+            /*-------------------------------------------------*\
+            | Check if this detector is enabled or needs to be  |
+            | added to the settings list                        |
+            \*-------------------------------------------------*/
+            bool this_device_enabled = true;
+            if(detector_settings.contains("detectors") && detector_settings["detectors"].contains(detection_string))
+            {
+                this_device_enabled = detector_settings["detectors"][detection_string];
+            }
+
+            LOG_DEBUG("[%s] is %s", detection_string, ((this_device_enabled == true) ? "enabled" : "disabled"));
+
+            if(this_device_enabled)
+            {
+                DetectionProgressChanged();
+
+                hid_wrapped_device_detectors[hid_detector_idx].function(wrapper, hid_device, hid_wrapped_device_detectors[hid_detector_idx].name);
+            }
+        }
+    }
+}
+
 void ResourceManager::StopDeviceDetection()
 {
     LOG_INFO("Detection abort requested");
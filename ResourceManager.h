@@ -19,6 +19,7 @@
 
 #include "hidapi_wrapper.h"
 #include "i2c_smbus.h"
+#include "EffectsEngine.h"
 #include "NetworkClient.h"
 #include "NetworkServer.h"
 #include "ProfileManager.h"
@@ -204,7 +205,9 @@ public:
 
 private:
     void DetectDevicesThreadFunction();
+    void DetectHIDWrappedDevice(const hidapi_wrapper& wrapper, hid_device_info* hid_device, const json& detector_settings, bool match_usage);
     void UpdateDetectorSettings();
+    void LoadCalibration(RGBController* rgb_controller);
     void SetupConfigurationDirectory();
 
     /*-------------------------------------------------------------------------------------*\
@@ -227,6 +230,11 @@ private:
     \*-------------------------------------------------------------------------------------*/
     SettingsManager*                            settings_manager;
 
+    /*-------------------------------------------------------------------------------------*\
+    | Effects Engine, only created when enabled in settings                                 |
+    \*-------------------------------------------------------------------------------------*/
+    EffectsEngine*                              effects_engine;
+
     /*-------------------------------------------------------------------------------------*\
     | I2C/SMBus Interfaces                                                                  |
     \*-------------------------------------------------------------------------------------*/
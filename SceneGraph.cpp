@@ -0,0 +1,287 @@
+/*-----------------------------------------*\
+|  SceneGraph.cpp                           |
+|                                           |
+|  World coordinates for every LED of a set |
+|  of controllers                           |
+\*-----------------------------------------*/
+
+#include "SceneGraph.h"
+
+#include <math.h>
+
+#define SCENE_GRAPH_DEG_TO_RAD      0.0174532925f
+
+static void ReadVector(const json& value, float out[3])
+{
+    if(value.is_array() && (value.size() == 3))
+    {
+        for(unsigned int axis = 0; axis < 3; axis++)
+        {
+            out[axis] = value[axis];
+        }
+    }
+}
+
+static void ReadVector(const json& settings, const char* key, float out[3])
+{
+    if(settings.contains(key))
+    {
+        ReadVector(settings[key], out);
+    }
+}
+
+SceneGraph::SceneGraph()
+{
+    for(unsigned int axis = 0; axis < 3; axis++)
+    {
+        bounds_min[axis] = 0.0f;
+        bounds_max[axis] = 0.0f;
+    }
+}
+
+SceneGraph::~SceneGraph()
+{
+
+}
+
+void SceneGraph::Build(const std::vector<RGBController*>& controllers, const json& scene_settings)
+{
+    x.clear();
+    y.clear();
+    z.clear();
+    ranges.clear();
+    range_index.clear();
+
+    for(std::size_t controller_idx = 0; controller_idx < controllers.size(); controller_idx++)
+    {
+        RGBController*  controller      = controllers[controller_idx];
+        json            device_settings = json::object();
+
+        /*-------------------------------------------------*\
+        | Find this controller's placement, if any          |
+        \*-------------------------------------------------*/
+        if(scene_settings.contains("devices"))
+        {
+            for(std::size_t device_idx = 0; device_idx < scene_settings["devices"].size(); device_idx++)
+            {
+                const json& entry = scene_settings["devices"][device_idx];
+
+                if(entry.contains("name") && (entry["name"] == controller->name)
+                && (!entry.contains("location") || (entry["location"] == controller->location)))
+                {
+                    device_settings = entry;
+                    break;
+                }
+            }
+        }
+
+        AddController(controller, device_settings);
+    }
+
+    /*-----------------------------------------------------*\
+    | Compute the bounds of the whole scene                 |
+    \*-----------------------------------------------------*/
+    const std::vector<float>* axes[3] = { &x, &y, &z };
+
+    for(unsigned int axis = 0; axis < 3; axis++)
+    {
+        bounds_min[axis] = 0.0f;
+        bounds_max[axis] = 0.0f;
+
+        for(std::size_t led_idx = 0; led_idx < axes[axis]->size(); led_idx++)
+        {
+            float value = (*axes[axis])[led_idx];
+
+            if((led_idx == 0) || (value < bounds_min[axis]))
+            {
+                bounds_min[axis] = value;
+            }
+
+            if((led_idx == 0) || (value > bounds_max[axis]))
+            {
+                bounds_max[axis] = value;
+            }
+        }
+    }
+}
+
+void SceneGraph::AddController(RGBController* controller, const json& device_settings)
+{
+    SceneGraphTransform transform =
+    {
+        { 0.0f, 0.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f },
+        { 1.0f, 1.0f, 1.0f }
+    };
+
+    ReadVector(device_settings, "position", transform.position);
+    ReadVector(device_settings, "rotation", transform.rotation);
+    ReadVector(device_settings, "scale",    transform.scale);
+
+    /*-----------------------------------------------------*\
+    | Local coordinates, one per entry in the color buffer  |
+    \*-----------------------------------------------------*/
+    std::size_t         led_count = controller->colors.size();
+    std::vector<float>  local(led_count * 3, 0.0f);
+
+    if(device_settings.contains("leds") && (device_settings["leds"].size() == led_count))
+    {
+        for(std::size_t led_idx = 0; led_idx < led_count; led_idx++)
+        {
+            ReadVector(device_settings["leds"][led_idx], &local[led_idx * 3]);
+        }
+    }
+    else
+    {
+        float row_offset = 0.0f;
+
+        for(std::size_t zone_idx = 0; zone_idx < controller->zones.size(); zone_idx++)
+        {
+            zone& led_zone = controller->zones[zone_idx];
+
+            if((led_zone.type == ZONE_TYPE_MATRIX) && (led_zone.matrix_map != NULL))
+            {
+                unsigned int width  = led_zone.matrix_map->width;
+                unsigned int height = led_zone.matrix_map->height;
+
+                for(unsigned int row = 0; row < height; row++)
+                {
+                    for(unsigned int col = 0; col < width; col++)
+                    {
+                        unsigned int led_idx = led_zone.matrix_map->map[(row * width) + col];
+
+                        if((led_idx < led_zone.leds_count) && ((led_zone.start_idx + led_idx) < led_count))
+                        {
+                            local[((led_zone.start_idx + led_idx) * 3) + 0] = (float)col;
+                            local[((led_zone.start_idx + led_idx) * 3) + 1] = row_offset + row;
+                        }
+                    }
+                }
+
+                row_offset += height;
+            }
+            else
+            {
+                for(unsigned int led_idx = 0; (led_idx < led_zone.leds_count) && ((led_zone.start_idx + led_idx) < led_count); led_idx++)
+                {
+                    local[((led_zone.start_idx + led_idx) * 3) + 0] = (float)led_idx;
+                    local[((led_zone.start_idx + led_idx) * 3) + 1] = row_offset;
+                }
+
+                row_offset += 1.0f;
+            }
+        }
+    }
+
+    /*-----------------------------------------------------*\
+    | Build the rotation matrix R = Rz * Ry * Rx            |
+    \*-----------------------------------------------------*/
+    float sx = sinf(transform.rotation[0] * SCENE_GRAPH_DEG_TO_RAD);
+    float cx = cosf(transform.rotation[0] * SCENE_GRAPH_DEG_TO_RAD);
+    float sy = sinf(transform.rotation[1] * SCENE_GRAPH_DEG_TO_RAD);
+    float cy = cosf(transform.rotation[1] * SCENE_GRAPH_DEG_TO_RAD);
+    float sz = sinf(transform.rotation[2] * SCENE_GRAPH_DEG_TO_RAD);
+    float cz = cosf(transform.rotation[2] * SCENE_GRAPH_DEG_TO_RAD);
+
+    float rotation[3][3] =
+    {
+        { cz * cy,  (cz * sy * sx) - (sz * cx), (cz * sy * cx) + (sz * sx) },
+        { sz * cy,  (sz * sy * sx) + (cz * cx), (sz * sy * cx) - (cz * sx) },
+        { -sy,      cy * sx,                    cy * cx                    }
+    };
+
+    SceneGraphRange range;
+
+    range.controller    = controller;
+    range.first         = x.size();
+    range.count         = led_count;
+
+    for(std::size_t led_idx = 0; led_idx < led_count; led_idx++)
+    {
+        float scaled[3];
+
+        for(unsigned int axis = 0; axis < 3; axis++)
+        {
+            scaled[axis] = local[(led_idx * 3) + axis] * transform.scale[axis];
+        }
+
+        float world[3];
+
+        for(unsigned int axis = 0; axis < 3; axis++)
+        {
+            world[axis] = (rotation[axis][0] * scaled[0])
+                        + (rotation[axis][1] * scaled[1])
+                        + (rotation[axis][2] * scaled[2])
+                        + transform.position[axis];
+        }
+
+        x.push_back(world[0]);
+        y.push_back(world[1]);
+        z.push_back(world[2]);
+    }
+
+    range_index[controller] = ranges.size();
+    ranges.push_back(range);
+}
+
+bool SceneGraph::IsStale() const
+{
+    /*-----------------------------------------------------*\
+    | Zone resizes change the color buffer size             |
+    \*-----------------------------------------------------*/
+    for(std::size_t range_idx = 0; range_idx < ranges.size(); range_idx++)
+    {
+        if(ranges[range_idx].controller->colors.size() != ranges[range_idx].count)
+        {
+            return(true);
+        }
+    }
+
+    return(false);
+}
+
+std::size_t SceneGraph::GetSize() const
+{
+    return(x.size());
+}
+
+const float* SceneGraph::GetX() const
+{
+    return(x.data());
+}
+
+const float* SceneGraph::GetY() const
+{
+    return(y.data());
+}
+
+const float* SceneGraph::GetZ() const
+{
+    return(z.data());
+}
+
+void SceneGraph::GetBounds(float min[3], float max[3]) const
+{
+    for(unsigned int axis = 0; axis < 3; axis++)
+    {
+        min[axis] = bounds_min[axis];
+        max[axis] = bounds_max[axis];
+    }
+}
+
+const std::vector<SceneGraphRange>& SceneGraph::GetRanges() const
+{
+    return(ranges);
+}
+
+const SceneGraphRange* SceneGraph::GetRange(RGBController* controller) const
+{
+    std::unordered_map<RGBController*, std::size_t>::const_iterator it = range_index.find(controller);
+
+    if(it == range_index.end())
+    {
+        return(nullptr);
+    }
+
+    return(&ranges[it->second]);
+}
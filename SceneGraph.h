@@ -0,0 +1,94 @@
+/*-----------------------------------------*\
+|  SceneGraph.h                             |
+|                                           |
+|  World coordinates for every LED of a set |
+|  of controllers, stored as flat position  |
+|  arrays with ranges back into each        |
+|  controller's color buffer                |
+\*-----------------------------------------*/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "RGBController.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+/*---------------------------------------------------------*\
+| LEDs first..first+count-1 in the position arrays belong   |
+| to controller->colors[0..count-1]                         |
+\*---------------------------------------------------------*/
+struct SceneGraphRange
+{
+    RGBController*  controller;
+    unsigned int    first;
+    unsigned int    count;
+};
+
+/*---------------------------------------------------------*\
+| Device placement, applied as scale, then rotation about   |
+| X, Y and Z (degrees), then translation                    |
+\*---------------------------------------------------------*/
+struct SceneGraphTransform
+{
+    float           position[3];
+    float           rotation[3];
+    float           scale[3];
+};
+
+/*---------------------------------------------------------*\
+| Settings format ("Scene"):                                |
+|                                                           |
+| {                                                         |
+|   "devices" :                                             |
+|   [                                                       |
+|     {                                                     |
+|       "name"      : "LED Strip",                          |
+|       "location"  : "COM3",           (optional)          |
+|       "position"  : [ 0.0, 0.0, 0.0 ],                    |
+|       "rotation"  : [ 0.0, 0.0, 90.0 ],                   |
+|       "scale"     : [ 1.0, 1.0, 1.0 ],                    |
+|       "leds"      : [ [ 0, 0, 0 ], [ 1, 0, 0 ] ]          |
+|     }                                                     |
+|   ]                                                       |
+| }                                                         |
+|                                                           |
+| Without "leds", local LED coordinates come from the zones |
+| in LED pitch units: matrix zones use their matrix_map     |
+| column and row, other zones run along X.  Zones are       |
+| stacked along Y in zone order                             |
+\*---------------------------------------------------------*/
+class SceneGraph
+{
+public:
+    SceneGraph();
+    ~SceneGraph();
+
+    void                            Build(const std::vector<RGBController*>& controllers, const json& scene_settings);
+    bool                            IsStale() const;
+
+    std::size_t                     GetSize() const;
+    const float*                    GetX() const;
+    const float*                    GetY() const;
+    const float*                    GetZ() const;
+
+    void                            GetBounds(float min[3], float max[3]) const;
+
+    const std::vector<SceneGraphRange>& GetRanges() const;
+    const SceneGraphRange*          GetRange(RGBController* controller) const;
+
+private:
+    std::vector<float>              x;
+    std::vector<float>              y;
+    std::vector<float>              z;
+    float                           bounds_min[3];
+    float                           bounds_max[3];
+
+    std::vector<SceneGraphRange>                        ranges;
+    std::unordered_map<RGBController*, std::size_t>     range_index;
+
+    void                            AddController(RGBController* controller, const json& device_settings);
+};
@@ -6,6 +6,8 @@
 #include "i2c_smbus.h"
 #include "NetworkClient.h"
 #include "NetworkServer.h"
+#include "LogBenchmark.h"
+#include "NetworkBenchmark.h"
 #include "LogManager.h"
 #include "Colors.h"
 
@@ -14,6 +16,7 @@
 #include <string>
 #include <tuple>
 #include <iostream>
+#include <fstream>
 
 /*-------------------------------------------------------------*\
 | Quirk for MSVC; which doesn't support this case-insensitive   |
@@ -317,7 +320,7 @@ unsigned int ParseMode(DeviceOptions& options, std::vector<RGBController *> &rgb
     // no need to check if --mode wasn't passed
     if (options.mode.size() == 0)
     {
-        return rgb_controllers[options.device]->active_mode;
+        return rgb_controllers[options.device]->GetMode();
     }
 
     /*---------------------------------------------------------*\
@@ -384,8 +387,16 @@ void OptionHelp()
     help_text += "--gui                                    Shows the GUI. GUI also appears when not passing any parameters\n";
     help_text += "--startminimized                         Starts the GUI minimized to tray. Implies --gui, even if not specified\n";
     help_text += "--client [IP]:[Port]                     Starts an SDK client on the given IP:Port (assumes port 6742 if not specified)\n";
+    help_text += "                                           Use unix:[path] to connect to a local server's Unix domain socket\n";
+    help_text += "--client-udp [IP]:[Port]                 Same as --client, but streams LED colors over UDP if the server allows it\n";
     help_text += "--server                                 Starts the SDK's server\n";
     help_text += "--server-port                            Sets the SDK's server port. Default: 6742 (1024-65535)\n";
+    help_text += "--server-socket path                     Also listens for local SDK clients on a Unix domain socket at path. Implies --server\n";
+    help_text += "--server-udp                             Accepts UDP LED color streams from SDK clients on the server port. Implies --server\n";
+    help_text += "--sdk-benchmark [file]                   Benchmarks the SDK over loopback and writes the results as JSON to file, or stdout if omitted\n";
+    help_text += "                                           Configured with the SDKBenchmark settings key (clients, devices, leds, frames, latency_samples, port, unix_socket, udp_stream)\n";
+    help_text += "--log-benchmark [file]                   Benchmarks multi-threaded logging throughput and writes the results as JSON to file, or stdout if omitted\n";
+    help_text += "                                           Configured with the LogBenchmark settings key (threads, messages)\n";
     help_text += "-l,  --list-devices                      Lists every compatible device with their number\n";
     help_text += "-d,  --device [0-9 | \"name\"]             Selects device to apply colors and/or effect to, or applies to all devices if omitted\n";
     help_text += "                                           Basic string search is implemented 3 characters or more\n";
@@ -996,7 +1007,9 @@ int ProcessOptions(int argc, char* argv[], Options* options, std::vector<RGBCont
              ||(option == "--nodetect")
              ||(option == "--noautoconnect")
              ||(option == "--client")
+             ||(option == "--client-udp")
              ||(option == "--server")
+             ||(option == "--server-udp")
              ||(option == "--gui")
              ||(option == "--i2c-tools" || option == "--yolo")
              ||(option == "--startminimized")
@@ -1014,6 +1027,7 @@ int ProcessOptions(int argc, char* argv[], Options* options, std::vector<RGBCont
                 \*-------------------------------------------------*/
             }
             else if((option == "--server-port")
+                  ||(option == "--server-socket")
                   ||(option == "--loglevel")
                   ||(option == "--config")
                   ||(option == "--autostart-enable"))
@@ -1167,7 +1181,7 @@ void ApplyOptions(DeviceOptions& options, std::vector<RGBController *>& rgb_cont
     /*---------------------------------------------------------*\
     | Set device mode                                           |
     \*---------------------------------------------------------*/
-    device->active_mode = mode;
+    device->SelectMode(mode);
     device->DeviceUpdateMode();
 
     /*---------------------------------------------------------*\
@@ -1191,6 +1205,8 @@ unsigned int cli_pre_detection(int argc, char* argv[])
     unsigned int    ret_flags    = 0;
     std::string     server_host  = OPENRGB_SDK_HOST;
     unsigned short  server_port  = OPENRGB_SDK_PORT;
+    std::string     server_unix_socket;
+    bool            server_udp   = false;
     bool            server_start = false;
     bool            print_help   = false;
 
@@ -1270,7 +1286,7 @@ unsigned int cli_pre_detection(int argc, char* argv[])
         /*---------------------------------------------------------*\
         | --client                                                  |
         \*---------------------------------------------------------*/
-        else if(option == "--client")
+        else if(option == "--client" || option == "--client-udp")
         {
             NetworkClient * client = new NetworkClient(ResourceManager::get()->GetRGBControllers());
 
@@ -1278,7 +1294,16 @@ unsigned int cli_pre_detection(int argc, char* argv[])
             std::string ip = argument.substr(0, pos);
             unsigned short port_val;
 
-            if(pos == argument.npos)
+            /*---------------------------------------------------------*\
+            | unix:path connects over a Unix domain socket              |
+            \*---------------------------------------------------------*/
+            if(ip == "unix")
+            {
+                ip       = argument;
+                port_val = OPENRGB_SDK_PORT;
+                client->SetUnixSocketPath(argument.substr(pos + 1));
+            }
+            else if(pos == argument.npos)
             {
                 port_val = OPENRGB_SDK_PORT;
             }
@@ -1294,6 +1319,7 @@ unsigned int cli_pre_detection(int argc, char* argv[])
             client->SetIP(ip.c_str());
             client->SetName(titleString.c_str());
             client->SetPort(port_val);
+            client->SetUDPStream(option == "--client-udp");
 
             client->StartClient();
 
@@ -1319,6 +1345,15 @@ unsigned int cli_pre_detection(int argc, char* argv[])
             server_start = true;
         }
 
+        /*---------------------------------------------------------*\
+        | --server-udp (no arguments)                               |
+        \*---------------------------------------------------------*/
+        else if(option == "--server-udp")
+        {
+            server_udp   = true;
+            server_start = true;
+        }
+
         /*---------------------------------------------------------*\
         | --server-port                                             |
         \*---------------------------------------------------------*/
@@ -1379,6 +1414,26 @@ unsigned int cli_pre_detection(int argc, char* argv[])
             arg_index++;
         }
 
+        /*---------------------------------------------------------*\
+        | --server-socket                                           |
+        \*---------------------------------------------------------*/
+        else if(option == "--server-socket")
+        {
+            if (argument != "")
+            {
+                server_unix_socket = argument;
+                server_start       = true;
+            }
+            else
+            {
+                std::cout << "Error: Missing argument for --server-socket" << std::endl;
+                print_help = true;
+                break;
+            }
+            cfg_args++;
+            arg_index++;
+        }
+
         /*---------------------------------------------------------*\
         | --loglevel                                                |
         \*---------------------------------------------------------*/
@@ -1522,6 +1577,68 @@ unsigned int cli_pre_detection(int argc, char* argv[])
             arg_index++;
         }
 
+        /*---------------------------------------------------------*\
+        | --sdk-benchmark                                           |
+        \*---------------------------------------------------------*/
+        else if(option == "--sdk-benchmark")
+        {
+            json benchmark_settings = ResourceManager::get()->GetSettingsManager()->GetSettings("SDKBenchmark");
+
+            NetworkBenchmark benchmark(benchmark_settings);
+
+            json results = benchmark.Run();
+
+            if(argument == "" || argument[0] == '-')
+            {
+                std::cout << results.dump(4) << std::endl;
+            }
+            else
+            {
+                std::ofstream results_file(argument, std::ios::out | std::ios::trunc);
+
+                if(!results_file)
+                {
+                    std::cout << "Error: Could not write benchmark results to " << argument << std::endl;
+                    exit(-1);
+                }
+
+                results_file << results.dump(4) << std::endl;
+            }
+
+            exit(results.contains("error") ? -1 : 0);
+        }
+
+        /*---------------------------------------------------------*\
+        | --log-benchmark                                           |
+        \*---------------------------------------------------------*/
+        else if(option == "--log-benchmark")
+        {
+            json benchmark_settings = ResourceManager::get()->GetSettingsManager()->GetSettings("LogBenchmark");
+
+            LogBenchmark benchmark(benchmark_settings);
+
+            json results = benchmark.Run();
+
+            if(argument == "" || argument[0] == '-')
+            {
+                std::cout << results.dump(4) << std::endl;
+            }
+            else
+            {
+                std::ofstream results_file(argument, std::ios::out | std::ios::trunc);
+
+                if(!results_file)
+                {
+                    std::cout << "Error: Could not write benchmark results to " << argument << std::endl;
+                    exit(-1);
+                }
+
+                results_file << results.dump(4) << std::endl;
+            }
+
+            exit(0);
+        }
+
         /*---------------------------------------------------------*\
         | --gui (no arguments)                                      |
         \*---------------------------------------------------------*/
@@ -1613,6 +1730,8 @@ unsigned int cli_pre_detection(int argc, char* argv[])
         NetworkServer * server = ResourceManager::get()->GetServer();
         server->SetHost(server_host);
         server->SetPort(server_port);
+        server->SetUnixSocketPath(server_unix_socket);
+        server->SetUDPStreamEnabled(server_udp);
         ret_flags |= RET_FLAG_START_SERVER;
     }
 
@@ -0,0 +1,122 @@
+/*-----------------------------------------*\
+|  hid_pacer.cpp                            |
+|                                           |
+|  Adaptive inter-report pacing for HID     |
+|  transports.  Reports are scheduled on a  |
+|  per-frame deadline and the interval is   |
+|  tuned from device status responses       |
+\*-----------------------------------------*/
+
+#include <algorithm>
+#include <thread>
+#include "hid_pacer.h"
+
+using namespace std::chrono_literals;
+
+/*---------------------------------------------------------*\
+| Number of consecutive OK responses before the interval    |
+| is shortened, and the smallest step used when backing off |
+\*---------------------------------------------------------*/
+#define HID_PACER_PROBE_COUNT       16
+#define HID_PACER_BACKOFF_STEP      250us
+
+hid_pacer::hid_pacer()
+{
+    /*-----------------------------------------------------*\
+    | Default to the 1ms gap controllers used before the    |
+    | pacer.  Controllers that report status and can go     |
+    | faster set their own sub-millisecond minimum with     |
+    | set_limits()                                          |
+    \*-----------------------------------------------------*/
+    set_limits(1ms, 1ms, 10ms);
+}
+
+hid_pacer::hid_pacer(std::chrono::microseconds initial_interval, std::chrono::microseconds min_interval, std::chrono::microseconds max_interval)
+{
+    set_limits(initial_interval, min_interval, max_interval);
+}
+
+void hid_pacer::set_limits(std::chrono::microseconds initial_interval, std::chrono::microseconds min_interval, std::chrono::microseconds max_interval)
+{
+    this->min_interval  = min_interval;
+    this->max_interval  = std::max(min_interval, max_interval);
+    this->interval      = std::min(this->max_interval, std::max(this->min_interval, initial_interval));
+    this->safe_interval = this->min_interval;
+
+    next_slot           = std::chrono::steady_clock::now();
+    frame_delay         = 0us;
+    ok_count            = 0;
+}
+
+void hid_pacer::begin_frame()
+{
+    /*-----------------------------------------------------*\
+    | Keep the previous frame's deadline if it is still in  |
+    | the future so the interval holds across frames        |
+    \*-----------------------------------------------------*/
+    next_slot   = std::max(next_slot, std::chrono::steady_clock::now());
+    frame_delay = 0us;
+}
+
+void hid_pacer::wait()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if(now < next_slot)
+    {
+        frame_delay += std::chrono::duration_cast<std::chrono::microseconds>(next_slot - now);
+
+        std::this_thread::sleep_until(next_slot);
+    }
+    else
+    {
+        next_slot = now;
+    }
+
+    next_slot += interval;
+}
+
+void hid_pacer::report_status(int status)
+{
+    switch(status)
+    {
+        case HID_PACER_STATUS_OK:
+            /*---------------------------------------------*\
+            | After a run of accepted reports, probe a      |
+            | shorter interval, but never below the last    |
+            | interval known to be safe                     |
+            \*---------------------------------------------*/
+            ok_count++;
+
+            if(ok_count >= HID_PACER_PROBE_COUNT)
+            {
+                ok_count = 0;
+                interval = std::max(safe_interval, interval - (interval / 8));
+            }
+            break;
+
+        case HID_PACER_STATUS_BUSY:
+        case HID_PACER_STATUS_FAILED:
+            /*---------------------------------------------*\
+            | The current interval is too short.  Remember  |
+            | it as the floor and back off quickly          |
+            \*---------------------------------------------*/
+            ok_count        = 0;
+            safe_interval   = std::min(max_interval, interval + HID_PACER_BACKOFF_STEP);
+            interval        = std::min(max_interval, std::max(interval * 2, safe_interval));
+            break;
+
+        default:
+            break;
+    }
+}
+
+std::chrono::microseconds hid_pacer::get_interval()
+{
+    return(interval);
+}
+
+std::chrono::microseconds hid_pacer::get_frame_delay()
+{
+    return(frame_delay);
+}
@@ -0,0 +1,62 @@
+/*-----------------------------------------*\
+|  hid_pacer.h                              |
+|                                           |
+|  Adaptive inter-report pacing for HID     |
+|  transports.  Reports are scheduled on a  |
+|  per-frame deadline and the interval is   |
+|  tuned from device status responses       |
+\*-----------------------------------------*/
+
+#pragma once
+
+#include <chrono>
+
+enum
+{
+    HID_PACER_STATUS_UNKNOWN    = 0,    /* Device gave no usable status         */
+    HID_PACER_STATUS_OK         = 1,    /* Device accepted the report           */
+    HID_PACER_STATUS_BUSY       = 2,    /* Device asked the host to slow down   */
+    HID_PACER_STATUS_FAILED     = 3,    /* Device rejected or dropped a report  */
+};
+
+class hid_pacer
+{
+public:
+    hid_pacer();
+    hid_pacer(std::chrono::microseconds initial_interval, std::chrono::microseconds min_interval, std::chrono::microseconds max_interval);
+
+    /*-----------------------------------------------------*\
+    | Configured limits.  The learned interval never goes   |
+    | below min_interval or above max_interval.  Setting    |
+    | all three equal gives fixed, deadline-based pacing    |
+    \*-----------------------------------------------------*/
+    void                        set_limits(std::chrono::microseconds initial_interval, std::chrono::microseconds min_interval, std::chrono::microseconds max_interval);
+
+    /*-----------------------------------------------------*\
+    | Call begin_frame() once before the reports of a frame |
+    | and wait() immediately before sending each report.    |
+    | Time spent building or transferring reports counts    |
+    | toward the interval, so only the remainder is slept   |
+    \*-----------------------------------------------------*/
+    void                        begin_frame();
+    void                        wait();
+
+    /*-----------------------------------------------------*\
+    | Feed back the device's ack/status response, if any    |
+    \*-----------------------------------------------------*/
+    void                        report_status(int status);
+
+    std::chrono::microseconds   get_interval();
+    std::chrono::microseconds   get_frame_delay();
+
+private:
+    std::chrono::microseconds               interval;
+    std::chrono::microseconds               min_interval;
+    std::chrono::microseconds               max_interval;
+    std::chrono::microseconds               safe_interval;
+
+    std::chrono::steady_clock::time_point   next_slot;
+    std::chrono::microseconds               frame_delay;
+
+    unsigned int                            ok_count;
+};
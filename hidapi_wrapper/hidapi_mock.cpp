@@ -0,0 +1,702 @@
+/*-----------------------------------------*\
+|  hidapi_mock.cpp                          |
+|                                           |
+|  Simulated hidapi backend for exercising  |
+|  HID controllers without real hardware.   |
+|  Devices are enumerated from a JSON       |
+|  fixture, reads are answered from canned  |
+|  replies and all written reports are      |
+|  captured with timestamps                 |
+\*-----------------------------------------*/
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "hidapi_mock.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+
+struct hidapi_mock_reply
+{
+    std::vector<unsigned char>                          match;
+    std::vector<unsigned char>                          data;
+};
+
+struct hidapi_mock_device
+{
+    std::string                                         path;
+    unsigned short                                      vendor_id;
+    unsigned short                                      product_id;
+    int                                                 interface_number;
+    unsigned short                                      usage_page;
+    unsigned short                                      usage;
+    std::wstring                                        manufacturer;
+    std::wstring                                        product;
+    std::wstring                                        serial;
+
+    std::chrono::microseconds                           write_latency;
+    std::chrono::microseconds                           read_latency;
+
+    std::vector<hidapi_mock_reply>                      matched_replies;
+    std::vector<std::vector<unsigned char>>             read_replies;
+    std::size_t                                         read_reply_idx;
+    std::deque<std::vector<unsigned char>>              pending_replies;
+    std::map<unsigned char, std::vector<unsigned char>> feature_replies;
+
+    hidapi_mock_device_stats                            stats;
+};
+
+static std::mutex                                       mock_mutex;
+static std::vector<std::unique_ptr<hidapi_mock_device>> mock_devices;
+static std::vector<hidapi_mock_report>                  mock_reports;
+static std::chrono::steady_clock::time_point            mock_start_time;
+static unsigned int                                     mock_reports_dropped = 0;
+static bool                                             mock_loaded = false;
+
+/*-----------------------------------------------------*\
+| Helpers                                               |
+\*-----------------------------------------------------*/
+static std::vector<unsigned char> json_to_bytes(const json& array)
+{
+    std::vector<unsigned char> bytes;
+
+    for(const json& value : array)
+    {
+        bytes.push_back((unsigned char)value.get<unsigned int>());
+    }
+
+    return bytes;
+}
+
+static wchar_t* wstring_dup(const std::wstring& str)
+{
+    wchar_t* dup = new wchar_t[str.size() + 1];
+
+    wcscpy(dup, str.c_str());
+
+    return(dup);
+}
+
+static hidapi_mock_device* to_mock(hid_device* dev)
+{
+    return(reinterpret_cast<hidapi_mock_device*>(dev));
+}
+
+/*-----------------------------------------------------*\
+| Captured reports are kept until they are read out or  |
+| saved.  Once HIDAPI_MOCK_MAX_REPORTS are pending,     |
+| further reports are only counted so that long runs    |
+| do not grow without bound                             |
+\*-----------------------------------------------------*/
+static void capture_report(hidapi_mock_device* mock, unsigned char type, const unsigned char* data, size_t length)
+{
+    if(mock_reports.size() < HIDAPI_MOCK_MAX_REPORTS)
+    {
+        hidapi_mock_report report;
+
+        report.timestamp    = std::chrono::steady_clock::now();
+        report.path         = mock->path;
+        report.type         = type;
+        report.data.assign(data, data + length);
+
+        mock_reports.push_back(report);
+    }
+    else
+    {
+        mock_reports_dropped++;
+    }
+}
+
+/*-----------------------------------------------------*| Written reports are captured and queue every matched  |
+| reply whose match bytes start the report, so that the |
+| next reads see the recorded response                  |
+\*-----------------------------------------------------*/
+static void capture_write(hidapi_mock_device* mock, unsigned char type, const unsigned char* data, size_t length)
+{
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    capture_report(mock, type, data, length);
+
+    for(const hidapi_mock_reply& reply : mock->matched_replies)
+    {
+        if(reply.match.size() <= length && std::equal(reply.match.begin(), reply.match.end(), data))
+        {
+            if(mock->pending_replies.size() >= HIDAPI_MOCK_MAX_PENDING)
+            {
+                mock->pending_replies.pop_front();
+            }
+
+            mock->pending_replies.push_back(reply.data);
+        }
+    }
+
+    mock->stats.reports_written++;
+    mock->stats.bytes_written  += (unsigned int)length;
+}
+
+/*-----------------------------------------------------*\
+| Emulated transfers sleep for the configured latency   |
+| so that controllers see realistic pacing, and the     |
+| time is accounted to the device statistics            |
+\*-----------------------------------------------------*/
+static void emulate_write(hidapi_mock_device* mock)
+{
+    if(mock->write_latency.count() > 0)
+    {
+        std::this_thread::sleep_for(mock->write_latency);
+    }
+
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    mock->stats.time_in_writes += mock->write_latency;
+}
+
+/*-----------------------------------------------------*\
+| hidapi function implementations                       |
+\*-----------------------------------------------------*/
+static int mock_hid_write(hid_device* dev, const unsigned char* data, size_t length)
+{
+    hidapi_mock_device* mock = to_mock(dev);
+
+    capture_write(mock, HIDAPI_MOCK_REPORT_OUTPUT, data, length);
+    emulate_write(mock);
+
+    return((int)length);
+}
+
+/*-----------------------------------------------------*| Reads return the oldest queued matched reply, then    |
+| the unmatched replies in order.  The timeout is not   |
+| waited out when nothing is available so that replays  |
+| of probing detectors stay fast                        |
+\*-----------------------------------------------------*/
+static int mock_hid_read_timeout(hid_device* dev, unsigned char* data, size_t length, int /*milliseconds*/)
+{
+    hidapi_mock_device* mock = to_mock(dev);
+
+    if(mock->read_latency.count() > 0)
+    {
+        std::this_thread::sleep_for(mock->read_latency);
+    }
+
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    std::vector<unsigned char> reply;
+
+    if(!mock->pending_replies.empty())
+    {
+        reply = mock->pending_replies.front();
+        mock->pending_replies.pop_front();
+    }
+    else if(!mock->read_replies.empty())
+    {
+        reply = mock->read_replies[mock->read_reply_idx];
+
+        if(mock->read_reply_idx + 1 < mock->read_replies.size())
+        {
+            mock->read_reply_idx++;
+        }
+    }
+    else
+    {
+        return(0);
+    }
+
+    size_t copy_length = std::min(length, reply.size());
+
+    memcpy(data, reply.data(), copy_length);
+
+    capture_report(mock, HIDAPI_MOCK_REPORT_INPUT, data, copy_length);
+
+    mock->stats.reports_read++;
+
+    return((int)copy_length);
+}
+
+static int mock_hid_read(hid_device* dev, unsigned char* data, size_t length)
+{
+    return(mock_hid_read_timeout(dev, data, length, -1));
+}
+
+static int mock_hid_send_feature_report(hid_device* dev, const unsigned char* data, size_t length)
+{
+    hidapi_mock_device* mock = to_mock(dev);
+
+    capture_write(mock, HIDAPI_MOCK_REPORT_FEATURE, data, length);
+    emulate_write(mock);
+
+    return((int)length);
+}
+
+static int mock_hid_get_feature_report(hid_device* dev, unsigned char* data, size_t length)
+{
+    hidapi_mock_device* mock = to_mock(dev);
+
+    if(length == 0)
+    {
+        return(-1);
+    }
+
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    std::map<unsigned char, std::vector<unsigned char>>::iterator it = mock->feature_replies.find(data[0]);
+
+    if(it == mock->feature_replies.end())
+    {
+        return(-1);
+    }
+
+    size_t copy_length = std::min(length, it->second.size());
+
+    memcpy(data, it->second.data(), copy_length);
+
+    mock->stats.reports_read++;
+
+    return((int)copy_length);
+}
+
+static int mock_hid_get_serial_number_string(hid_device* dev, wchar_t* string, size_t maxlen)
+{
+    hidapi_mock_device* mock = to_mock(dev);
+
+    if(maxlen == 0)
+    {
+        return(-1);
+    }
+
+    wcsncpy(string, mock->serial.c_str(), maxlen);
+    string[maxlen - 1] = L'\0';
+
+    return(0);
+}
+
+static hid_device* mock_hid_open_path(const char* path)
+{
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    for(std::unique_ptr<hidapi_mock_device>& mock : mock_devices)
+    {
+        if(mock->path == path)
+        {
+            return(reinterpret_cast<hid_device*>(mock.get()));
+        }
+    }
+
+    return(NULL);
+}
+
+static hid_device_info* mock_hid_enumerate(unsigned short vendor_id, unsigned short product_id)
+{
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    hid_device_info*  head = NULL;
+    hid_device_info** tail = &head;
+
+    for(std::unique_ptr<hidapi_mock_device>& mock : mock_devices)
+    {
+        if((vendor_id  != 0 && vendor_id  != mock->vendor_id)
+        || (product_id != 0 && product_id != mock->product_id))
+        {
+            continue;
+        }
+
+        hid_device_info* info       = new hid_device_info();
+
+        info->path                  = new char[mock->path.size() + 1];
+        strcpy(info->path, mock->path.c_str());
+
+        info->vendor_id             = mock->vendor_id;
+        info->product_id            = mock->product_id;
+        info->serial_number         = wstring_dup(mock->serial);
+        info->release_number        = 0;
+        info->manufacturer_string   = wstring_dup(mock->manufacturer);
+        info->product_string        = wstring_dup(mock->product);
+        info->usage_page            = mock->usage_page;
+        info->usage                 = mock->usage;
+        info->interface_number      = mock->interface_number;
+        info->next                  = NULL;
+
+        *tail                       = info;
+        tail                        = &info->next;
+    }
+
+    return(head);
+}
+
+static void mock_hid_free_enumeration(hid_device_info* devs)
+{
+    while(devs)
+    {
+        hid_device_info* next = devs->next;
+
+        delete[] devs->path;
+        delete[] devs->serial_number;
+        delete[] devs->manufacturer_string;
+        delete[] devs->product_string;
+        delete devs;
+
+        devs = next;
+    }
+}
+
+static void mock_hid_close(hid_device* /*dev*/)
+{
+    /*-------------------------------------------------*\
+    | Mock devices live for the lifetime of the fixture |
+    | so that statistics survive controller teardown    |
+    \*-------------------------------------------------*/
+}
+
+static const wchar_t* mock_hid_error(hid_device* /*dev*/)
+{
+    return(L"hidapi mock backend");
+}
+
+/*-----------------------------------------------------*\
+| Public interface                                      |
+\*-----------------------------------------------------*/
+bool hidapi_mock_load_fixture(const std::string& filename)
+{
+    std::ifstream   fixture_file(filename, std::ios::in);
+    json            fixture;
+
+    if(!fixture_file)
+    {
+        return(false);
+    }
+
+    try
+    {
+        fixture_file >> fixture;
+    }
+    catch(const std::exception&)
+    {
+        return(false);
+    }
+
+    if(!fixture.contains("devices"))
+    {
+        return(false);
+    }
+
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    mock_devices.clear();
+    mock_reports.clear();
+    mock_reports_dropped = 0;
+
+    for(const json& entry : fixture["devices"])
+    {
+        std::unique_ptr<hidapi_mock_device> mock(new hidapi_mock_device());
+
+        std::string manufacturer    = entry.value("manufacturer", "OpenRGB");
+        std::string product         = entry.value("product", "Mock HID Device");
+        std::string serial          = entry.value("serial", "");
+
+        mock->path                  = entry.value("path", "mock-" + std::to_string(mock_devices.size()));
+        mock->vendor_id             = entry.value("vendor_id", 0);
+        mock->product_id            = entry.value("product_id", 0);
+        mock->interface_number      = entry.value("interface_number", 0);
+        mock->usage_page            = entry.value("usage_page", 0);
+        mock->usage                 = entry.value("usage", 0);
+        mock->manufacturer          = std::wstring(manufacturer.begin(), manufacturer.end());
+        mock->product               = std::wstring(product.begin(), product.end());
+        mock->serial                = std::wstring(serial.begin(), serial.end());
+        mock->write_latency         = std::chrono::microseconds(entry.value("write_latency_us", 0));
+        mock->read_latency          = std::chrono::microseconds(entry.value("read_latency_us", 0));
+        mock->read_reply_idx        = 0;
+
+        if(entry.contains("read_replies"))
+        {
+            for(const json& reply : entry["read_replies"])
+            {
+                if(reply.contains("match"))
+                {
+                    hidapi_mock_reply matched_reply;
+
+                    matched_reply.match = json_to_bytes(reply["match"]);
+                    matched_reply.data  = json_to_bytes(reply["data"]);
+
+                    mock->matched_replies.push_back(matched_reply);
+                }
+                else
+                {
+                    mock->read_replies.push_back(json_to_bytes(reply["data"]));
+                }
+            }
+        }
+
+        if(entry.contains("feature_replies"))
+        {
+            for(const json& reply : entry["feature_replies"])
+            {
+                mock->feature_replies[(unsigned char)reply.value("report_id", 0)] = json_to_bytes(reply["data"]);
+            }
+        }
+
+        mock->stats.path            = mock->path;
+        mock->stats.reports_written = 0;
+        mock->stats.bytes_written   = 0;
+        mock->stats.reports_read    = 0;
+        mock->stats.time_in_writes  = std::chrono::microseconds(0);
+
+        mock_devices.push_back(std::move(mock));
+    }
+
+    mock_start_time = std::chrono::steady_clock::now();
+    mock_loaded     = true;
+
+    return(true);
+}
+
+bool hidapi_mock_is_loaded()
+{
+    return(mock_loaded);
+}
+
+hidapi_wrapper hidapi_mock_get_wrapper()
+{
+    hidapi_wrapper wrapper;
+
+    wrapper.dyn_handle                      = NULL;
+    wrapper.hid_write                       = mock_hid_write;
+    wrapper.hid_read                        = mock_hid_read;
+    wrapper.hid_read_timeout                = mock_hid_read_timeout;
+    wrapper.hid_send_feature_report         = mock_hid_send_feature_report;
+    wrapper.hid_get_feature_report          = mock_hid_get_feature_report;
+    wrapper.hid_get_serial_number_string    = mock_hid_get_serial_number_string;
+    wrapper.hid_open_path                   = mock_hid_open_path;
+    wrapper.hid_enumerate                   = mock_hid_enumerate;
+    wrapper.hid_free_enumeration            = mock_hid_free_enumeration;
+    wrapper.hid_close                       = mock_hid_close;
+    wrapper.hid_error                       = mock_hid_error;
+
+    return(wrapper);
+}
+
+std::vector<hidapi_mock_report> hidapi_mock_take_reports()
+{
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    std::vector<hidapi_mock_report> reports;
+
+    reports.swap(mock_reports);
+
+    return(reports);
+}
+
+std::vector<hidapi_mock_device_stats> hidapi_mock_get_stats()
+{
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    std::vector<hidapi_mock_device_stats> stats;
+
+    for(std::unique_ptr<hidapi_mock_device>& mock : mock_devices)
+    {
+        stats.push_back(mock->stats);
+    }
+
+    return(stats);
+}
+
+void hidapi_mock_clear_reports()
+{
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    mock_reports.clear();
+    mock_reports_dropped = 0;
+
+    for(std::unique_ptr<hidapi_mock_device>& mock : mock_devices)
+    {
+        mock->stats.reports_written = 0;
+        mock->stats.bytes_written   = 0;
+        mock->stats.reports_read    = 0;
+        mock->stats.time_in_writes  = std::chrono::microseconds(0);
+    }
+
+    mock_start_time = std::chrono::steady_clock::now();
+}
+
+bool hidapi_mock_save_reports(const std::string& filename)
+{
+    std::ofstream   capture_file(filename, std::ios::out | std::ios::trunc);
+    json            capture;
+
+    if(!capture_file)
+    {
+        return(false);
+    }
+
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    for(const hidapi_mock_report& report : mock_reports)
+    {
+        json entry;
+
+        entry["timestamp_us"]   = std::chrono::duration_cast<std::chrono::microseconds>(report.timestamp - mock_start_time).count();
+        entry["path"]           = report.path;
+        entry["type"]           = (report.type == HIDAPI_MOCK_REPORT_INPUT) ? "input" : (report.type == HIDAPI_MOCK_REPORT_FEATURE) ? "feature" : "output";
+        entry["data"]           = report.data;
+
+        capture["reports"].push_back(entry);
+    }
+
+    for(std::unique_ptr<hidapi_mock_device>& mock : mock_devices)
+    {
+        json entry;
+
+        entry["path"]               = mock->stats.path;
+        entry["reports_written"]    = mock->stats.reports_written;
+        entry["bytes_written"]      = mock->stats.bytes_written;
+        entry["reports_read"]       = mock->stats.reports_read;
+        entry["time_in_writes_us"]  = mock->stats.time_in_writes.count();
+
+        capture["devices"].push_back(entry);
+    }
+
+    capture["reports_dropped"] = mock_reports_dropped;
+
+    capture_file << capture.dump(4);
+
+    /*-------------------------------------------------*\
+    | Saved reports are released so that periodic saves |
+    | keep memory bounded                               |
+    \*-------------------------------------------------*/
+    mock_reports.clear();
+    mock_reports_dropped = 0;
+
+    return(true);
+}
+
+#ifdef HIDAPI_MOCK_BACKEND
+/*-----------------------------------------------------*\
+| Link-time backend                                     |
+|                                                       |
+| Built with CONFIG+=hid_mock, the hidapi library is    |
+| not linked and these definitions serve every hidapi   |
+| call in the tree from the fixture, so that plain HID  |
+| detectors and controllers run against it as well as   |
+| the wrapped ones                                      |
+\*-----------------------------------------------------*/
+static int mock_hid_get_string(const std::wstring& str, wchar_t* string, size_t maxlen)
+{
+    if(maxlen == 0)
+    {
+        return(-1);
+    }
+
+    wcsncpy(string, str.c_str(), maxlen);
+    string[maxlen - 1] = L'\0';
+
+    return(0);
+}
+
+int HID_API_EXPORT HID_API_CALL hid_init(void)
+{
+    return(0);
+}
+
+int HID_API_EXPORT HID_API_CALL hid_exit(void)
+{
+    return(0);
+}
+
+struct hid_device_info HID_API_EXPORT * HID_API_CALL hid_enumerate(unsigned short vendor_id, unsigned short product_id)
+{
+    return(mock_hid_enumerate(vendor_id, product_id));
+}
+
+void HID_API_EXPORT HID_API_CALL hid_free_enumeration(struct hid_device_info* devs)
+{
+    mock_hid_free_enumeration(devs);
+}
+
+HID_API_EXPORT hid_device* HID_API_CALL hid_open(unsigned short vendor_id, unsigned short product_id, const wchar_t* serial_number)
+{
+    std::lock_guard<std::mutex> lock(mock_mutex);
+
+    for(std::unique_ptr<hidapi_mock_device>& mock : mock_devices)
+    {
+        if(mock->vendor_id == vendor_id && mock->product_id == product_id
+        && (serial_number == NULL || mock->serial == serial_number))
+        {
+            return(reinterpret_cast<hid_device*>(mock.get()));
+        }
+    }
+
+    return(NULL);
+}
+
+HID_API_EXPORT hid_device* HID_API_CALL hid_open_path(const char* path)
+{
+    return(mock_hid_open_path(path));
+}
+
+int HID_API_EXPORT HID_API_CALL hid_write(hid_device* dev, const unsigned char* data, size_t length)
+{
+    return(mock_hid_write(dev, data, length));
+}
+
+int HID_API_EXPORT HID_API_CALL hid_read_timeout(hid_device* dev, unsigned char* data, size_t length, int milliseconds)
+{
+    return(mock_hid_read_timeout(dev, data, length, milliseconds));
+}
+
+int HID_API_EXPORT HID_API_CALL hid_read(hid_device* dev, unsigned char* data, size_t length)
+{
+    return(mock_hid_read(dev, data, length));
+}
+
+int HID_API_EXPORT HID_API_CALL hid_set_nonblocking(hid_device* /*dev*/, int /*nonblock*/)
+{
+    /*-------------------------------------------------*\
+    | Mock reads never block                            |
+    \*-------------------------------------------------*/
+    return(0);
+}
+
+int HID_API_EXPORT HID_API_CALL hid_send_feature_report(hid_device* dev, const unsigned char* data, size_t length)
+{
+    return(mock_hid_send_feature_report(dev, data, length));
+}
+
+int HID_API_EXPORT HID_API_CALL hid_get_feature_report(hid_device* dev, unsigned char* data, size_t length)
+{
+    return(mock_hid_get_feature_report(dev, data, length));
+}
+
+void HID_API_EXPORT HID_API_CALL hid_close(hid_device* dev)
+{
+    mock_hid_close(dev);
+}
+
+int HID_API_EXPORT_CALL hid_get_manufacturer_string(hid_device* dev, wchar_t* string, size_t maxlen)
+{
+    return(mock_hid_get_string(to_mock(dev)->manufacturer, string, maxlen));
+}
+
+int HID_API_EXPORT_CALL hid_get_product_string(hid_device* dev, wchar_t* string, size_t maxlen)
+{
+    return(mock_hid_get_string(to_mock(dev)->product, string, maxlen));
+}
+
+int HID_API_EXPORT_CALL hid_get_serial_number_string(hid_device* dev, wchar_t* string, size_t maxlen)
+{
+    return(mock_hid_get_serial_number_string(dev, string, maxlen));
+}
+
+int HID_API_EXPORT_CALL hid_get_indexed_string(hid_device* /*dev*/, int /*string_index*/, wchar_t* /*string*/, size_t /*maxlen*/)
+{
+    return(-1);
+}
+
+HID_API_EXPORT const wchar_t* HID_API_CALL hid_error(hid_device* dev)
+{
+    return(mock_hid_error(dev));
+}
+#endif
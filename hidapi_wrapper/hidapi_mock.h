@@ -0,0 +1,96 @@
+/*-----------------------------------------*\
+|  hidapi_mock.h                            |
+|                                           |
+|  Simulated hidapi backend for exercising  |
+|  HID controllers without real hardware.   |
+|  Devices are enumerated from a JSON       |
+|  fixture, reads are answered from canned  |
+|  replies and all written reports are      |
+|  captured with timestamps                 |
+\*-----------------------------------------*/
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "hidapi_wrapper.h"
+
+#define HIDAPI_MOCK_MAX_REPORTS     65536
+#define HIDAPI_MOCK_MAX_PENDING     256
+
+enum
+{
+    HIDAPI_MOCK_REPORT_OUTPUT       = 0,    /* Report sent with hid_write                   */
+    HIDAPI_MOCK_REPORT_FEATURE      = 1,    /* Report sent with hid_send_feature_report     */
+    HIDAPI_MOCK_REPORT_INPUT        = 2,    /* Reply returned by hid_read(_timeout)         */
+};
+
+struct hidapi_mock_report
+{
+    std::chrono::steady_clock::time_point   timestamp;
+    std::string                             path;
+    unsigned char                           type;
+    std::vector<unsigned char>              data;
+};
+
+struct hidapi_mock_device_stats
+{
+    std::string                             path;
+    unsigned int                            reports_written;
+    unsigned int                            bytes_written;
+    unsigned int                            reports_read;
+    std::chrono::microseconds               time_in_writes;
+};
+
+/*-----------------------------------------------------*\
+| Fixture format:                                       |
+|                                                       |
+| {                                                     |
+|   "devices":                                          |
+|   [                                                   |
+|     {                                                 |
+|       "path"              : "mock-0",                 |
+|       "vendor_id"         : 5426,                     |
+|       "product_id"        : 599,                      |
+|       "interface_number"  : 0,                        |
+|       "usage_page"        : 12,                       |
+|       "usage"             : 1,                        |
+|       "manufacturer"      : "Mock",                   |
+|       "product"           : "Mock Keyboard",          |
+|       "serial"            : "0000",                   |
+|       "write_latency_us"  : 1000,                     |
+|       "read_latency_us"   : 200,                      |
+|       "read_replies"      :                           |
+|       [                                               |
+|         { "match" : [ 0, 8 ], "data" : [ 0, 8, 1 ] }, |
+|         { "data" : [ 0, 1, 2 ] }                      |
+|       ],                                              |
+|       "feature_replies"   :                           |
+|       [                                               |
+|         { "report_id" : 0, "data" : [ 0, 2, 0 ] }     |
+|       ]                                               |
+|     }                                                 |
+|   ]                                                   |
+| }                                                     |
+|                                                       |
+| A read_replies entry with a match is queued each time |
+| a report starting with the match bytes is written,    |
+| so recorded request/response exchanges replay in      |
+| order.  Entries without a match are returned when     |
+| nothing is queued, repeating the last one once the    |
+| list is exhausted.  With no reply available, reads    |
+| return 0 after read_latency_us.                       |
+|                                                       |
+| feature_replies are matched on the report ID in the   |
+| first byte of the buffer.  Captured reports are       |
+| released when they are taken or saved                 |
+\*-----------------------------------------------------*/
+bool                                    hidapi_mock_load_fixture(const std::string& filename);
+bool                                    hidapi_mock_is_loaded();
+hidapi_wrapper                          hidapi_mock_get_wrapper();
+
+std::vector<hidapi_mock_report>         hidapi_mock_take_reports();
+std::vector<hidapi_mock_device_stats>   hidapi_mock_get_stats();
+void                                    hidapi_mock_clear_reports();
+bool                                    hidapi_mock_save_reports(const std::string& filename);
@@ -19,6 +19,9 @@
 /*-----------------------------------------------------*\
 | Type definitions for libhidapi function pointers      |
 \*-----------------------------------------------------*/
+typedef int                 (*hidapi_wrapper_write)                 (hid_device*, const unsigned char*, size_t);
+typedef int                 (*hidapi_wrapper_read)                  (hid_device*, unsigned char*, size_t);
+typedef int                 (*hidapi_wrapper_read_timeout)          (hid_device*, unsigned char*, size_t, int);
 typedef int                 (*hidapi_wrapper_send_feature_report)   (hid_device*, const unsigned char*, size_t);
 typedef int                 (*hidapi_wrapper_get_feature_report)    (hid_device*, unsigned char*, size_t);
 typedef int                 (*hidapi_wrapper_get_serial_number_string) (hid_device*, wchar_t*, size_t);
@@ -35,6 +38,9 @@ typedef const wchar_t*      (*hidapi_wrapper_error)                 (hid_device*
 struct hidapi_wrapper
 {
     void*                                   dyn_handle;
+    hidapi_wrapper_write                    hid_write;
+    hidapi_wrapper_read                     hid_read;
+    hidapi_wrapper_read_timeout             hid_read_timeout;
     hidapi_wrapper_send_feature_report      hid_send_feature_report;
     hidapi_wrapper_get_feature_report       hid_get_feature_report;
     hidapi_wrapper_get_serial_number_string hid_get_serial_number_string;
@@ -7,6 +7,7 @@
 \******************************************************************************************/
 
 #include "i2c_smbus.h"
+#include "i2c_smbus_scheduler.h"
 #include <string.h>
 
 #ifdef WIN32
@@ -24,12 +25,24 @@ i2c_smbus_interface::i2c_smbus_interface()
     this->pci_vendor           = -1;
     this->pci_subsystem_device = -1;
     this->pci_subsystem_vendor = -1;
+    stats_transfers            = 0;
+    stats_address_switches     = 0;
+    stats_busy                 = std::chrono::microseconds(0);
+    stats_start                = std::chrono::steady_clock::now();
+    stats_last_addr            = -1;
+    scheduler                  = nullptr;
     i2c_smbus_thread_running   = true;
     i2c_smbus_thread           = new std::thread(&i2c_smbus_interface::i2c_smbus_thread_function, this);
 }
 
 i2c_smbus_interface::~i2c_smbus_interface()
 {
+    /*-----------------------------------------------------*\
+    | Stop the scheduler first, it issues transfers through |
+    | the bus thread                                        |
+    \*-----------------------------------------------------*/
+    delete scheduler;
+
     i2c_smbus_thread_running = false;
     i2c_smbus_start = true;
     i2c_smbus_start_cv.notify_all();
@@ -157,6 +170,16 @@ s32 i2c_smbus_interface::i2c_smbus_write_i2c_block_data(u8 addr, u8 command, u8
     return i2c_smbus_xfer_call(addr, I2C_SMBUS_WRITE, command, I2C_SMBUS_I2C_BLOCK_DATA, &data);
 }
 
+s32 i2c_smbus_interface::i2c_smbus_write_batch(u8 addr, int count, i2c_smbus_write_msg* writes, bool repeated_start)
+{
+    if(count <= 0)
+    {
+        return 0;
+    }
+
+    return i2c_smbus_batch_xfer_call(addr, count, writes, repeated_start);
+}
+
 s32 i2c_smbus_interface::i2c_smbus_xfer_call(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data)
 {
     i2c_smbus_xfer_mutex.lock();
@@ -166,7 +189,7 @@ s32 i2c_smbus_interface::i2c_smbus_xfer_call(u8 addr, char read_write, u8 comman
     i2c_command     = command;
     i2c_size_smbus  = size;
     i2c_data_smbus  = data;
-    smbus_xfer      = true;
+    xfer_type       = I2C_XFER_TYPE_SMBUS;
 
     std::unique_lock<std::mutex> start_lock(i2c_smbus_start_mutex);
     i2c_smbus_start = true;
@@ -191,7 +214,7 @@ s32 i2c_smbus_interface::i2c_xfer_call(u8 addr, char read_write, int* size, u8 *
     i2c_read_write  = read_write;
     i2c_size        = size;
     i2c_data        = data;
-    smbus_xfer      = false;
+    xfer_type       = I2C_XFER_TYPE_I2C;
 
     std::unique_lock<std::mutex> start_lock(i2c_smbus_start_mutex);
     i2c_smbus_start = true;
@@ -208,6 +231,50 @@ s32 i2c_smbus_interface::i2c_xfer_call(u8 addr, char read_write, int* size, u8 *
     return(i2c_ret);
 }
 
+s32 i2c_smbus_interface::i2c_smbus_batch_xfer_call(u8 addr, int count, i2c_smbus_write_msg* writes, bool repeated_start)
+{
+    i2c_smbus_xfer_mutex.lock();
+
+    i2c_addr                    = addr;
+    i2c_batch_count             = count;
+    i2c_batch                   = writes;
+    i2c_batch_repeated_start    = repeated_start;
+    xfer_type                   = I2C_XFER_TYPE_SMBUS_BATCH;
+
+    std::unique_lock<std::mutex> start_lock(i2c_smbus_start_mutex);
+    i2c_smbus_start = true;
+    i2c_smbus_start_cv.notify_all();
+    start_lock.unlock();
+
+    std::unique_lock<std::mutex> done_lock(i2c_smbus_done_mutex);
+
+    i2c_smbus_done_cv.wait(done_lock, [this]{ return i2c_smbus_done.load(); });
+    i2c_smbus_done  = false;
+
+    i2c_smbus_xfer_mutex.unlock();
+
+    return(i2c_ret);
+}
+
+/*-----------------------------------------------------*\
+| Drivers without a native batch transfer issue the     |
+| writes one at a time, stopping at the first error     |
+\*-----------------------------------------------------*/
+s32 i2c_smbus_interface::i2c_smbus_batch_xfer(u8 addr, int count, i2c_smbus_write_msg* writes, bool /*repeated_start*/)
+{
+    for(int write_idx = 0; write_idx < count; write_idx++)
+    {
+        s32 ret = i2c_smbus_xfer(addr, I2C_SMBUS_WRITE, writes[write_idx].command, writes[write_idx].size, &writes[write_idx].data);
+
+        if(ret < 0)
+        {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
 s32 i2c_smbus_interface::i2c_read_block(u8 addr, int* size, u8* data)
 {
     return i2c_xfer_call(addr, I2C_SMBUS_READ, size, data);
@@ -232,18 +299,77 @@ void i2c_smbus_interface::i2c_smbus_thread_function()
             break;
         }
 
-        if(smbus_xfer)
+        std::chrono::steady_clock::time_point xfer_start = std::chrono::steady_clock::now();
+
+        switch(xfer_type)
         {
-            i2c_ret = i2c_smbus_xfer(i2c_addr, i2c_read_write, i2c_command, i2c_size_smbus, i2c_data_smbus);
+            case I2C_XFER_TYPE_SMBUS:
+                i2c_ret = i2c_smbus_xfer(i2c_addr, i2c_read_write, i2c_command, i2c_size_smbus, i2c_data_smbus);
+                break;
+
+            case I2C_XFER_TYPE_I2C:
+                i2c_ret = i2c_xfer(i2c_addr, i2c_read_write, i2c_size, i2c_data);
+                break;
+
+            case I2C_XFER_TYPE_SMBUS_BATCH:
+                i2c_ret = i2c_smbus_batch_xfer(i2c_addr, i2c_batch_count, i2c_batch, i2c_batch_repeated_start);
+                break;
         }
-        else
+
+        /*-----------------------------------------------------*\
+        | Account the transfer in the bus statistics            |
+        \*-----------------------------------------------------*/
+        std::chrono::steady_clock::time_point xfer_end = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> stats_lock(i2c_smbus_stats_mutex);
+        stats_transfers += (xfer_type == I2C_XFER_TYPE_SMBUS_BATCH) ? i2c_batch_count : 1;
+        stats_busy += std::chrono::duration_cast<std::chrono::microseconds>(xfer_end - xfer_start);
+
+        if(stats_last_addr != i2c_addr)
         {
-            i2c_ret = i2c_xfer(i2c_addr, i2c_read_write, i2c_size, i2c_data);
+            stats_address_switches++;
+            stats_last_addr = i2c_addr;
         }
+        stats_lock.unlock();
 
         std::unique_lock<std::mutex> done_lock(i2c_smbus_done_mutex);
         i2c_smbus_done  = true;
         i2c_smbus_done_cv.notify_all();
         done_lock.unlock();
     }
-}
\ No newline at end of file
+}
+
+void i2c_smbus_interface::i2c_smbus_get_stats(i2c_smbus_stats* stats, bool reset)
+{
+    std::lock_guard<std::mutex> stats_lock(i2c_smbus_stats_mutex);
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::microseconds elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - stats_start);
+
+    stats->transfers        = stats_transfers;
+    stats->address_switches = stats_address_switches;
+    stats->busy_us          = (unsigned int)stats_busy.count();
+    stats->elapsed_us       = (unsigned int)elapsed.count();
+    stats->utilization      = (elapsed.count() > 0) ? ((float)stats_busy.count() / (float)elapsed.count()) : 0.0f;
+
+    if(reset)
+    {
+        stats_transfers        = 0;
+        stats_address_switches = 0;
+        stats_busy             = std::chrono::microseconds(0);
+        stats_start            = now;
+    }
+}
+
+void i2c_smbus_interface::i2c_smbus_enable_scheduler(unsigned int fps)
+{
+    if(scheduler == nullptr)
+    {
+        scheduler = new i2c_smbus_scheduler(this, fps);
+    }
+}
+
+i2c_smbus_scheduler* i2c_smbus_interface::i2c_smbus_get_scheduler()
+{
+    return(scheduler);
+}
@@ -15,6 +15,7 @@
 #include <thread>
 #include <condition_variable>
 #include <mutex>
+#include <chrono>
 
 typedef unsigned char   u8;
 typedef unsigned short  u16;
@@ -55,6 +56,14 @@ union i2c_smbus_data
 
 #endif /* __APPLE__ or __FreeBSD__ */
 
+// Transfer types handled by the bus thread
+enum
+{
+    I2C_XFER_TYPE_SMBUS         = 0,
+    I2C_XFER_TYPE_I2C           = 1,
+    I2C_XFER_TYPE_SMBUS_BATCH   = 2,
+};
+
 // i2c_smbus_xfer read or write markers
 #define I2C_SMBUS_READ  1
 #define I2C_SMBUS_WRITE 0
@@ -70,6 +79,32 @@ union i2c_smbus_data
 #define I2C_SMBUS_BLOCK_PROC_CALL   7           /* SMBus 2.0 */
 #define I2C_SMBUS_I2C_BLOCK_DATA    8
 
+class i2c_smbus_scheduler;
+
+/*-----------------------------------------------------*\
+| One SMBus write of a batch.  size is one of the       |
+| I2C_SMBUS_* transaction types, for I2C_SMBUS_BYTE the |
+| value is passed in command                            |
+\*-----------------------------------------------------*/
+struct i2c_smbus_write_msg
+{
+    u8              command;
+    int             size;
+    i2c_smbus_data  data;
+};
+
+/*-----------------------------------------------------*\
+| Bus usage counters, accumulated by the bus thread     |
+| since the last reset                                  |
+\*-----------------------------------------------------*/
+struct i2c_smbus_stats
+{
+    unsigned int    transfers;
+    unsigned int    address_switches;
+    unsigned int    busy_us;
+    unsigned int    elapsed_us;
+    float           utilization;
+};
 
 class i2c_smbus_interface
 {
@@ -100,6 +135,11 @@ public:
     s32 i2c_smbus_read_i2c_block_data(u8 addr, u8 command, u8 length, u8 *values);
     s32 i2c_smbus_write_i2c_block_data(u8 addr, u8 command, u8 length, const u8 *values);
 
+    //Write a sequence of SMBus transactions to one address in a single call.  Set
+    //repeated_start only for devices known to accept the writes joined by repeated
+    //starts instead of a STOP after each one
+    s32 i2c_smbus_write_batch(u8 addr, int count, i2c_smbus_write_msg* writes, bool repeated_start = false);
+
     //Addtional functions added for pure I2C block operations
     s32 i2c_read_block(u8 addr, int* size, u8* data);
     s32 i2c_write_block(u8 addr, int size, u8* data);
@@ -107,9 +147,16 @@ public:
     //Handle SMBus and I2C transfer calls in a single thread
     s32 i2c_smbus_xfer_call(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
     s32 i2c_xfer_call(u8 addr, char read_write, int* size, u8 *data);
+    s32 i2c_smbus_batch_xfer_call(u8 addr, int count, i2c_smbus_write_msg* writes, bool repeated_start);
 
     virtual s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data) = 0;
     virtual s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data) = 0;
+    virtual s32 i2c_smbus_batch_xfer(u8 addr, int count, i2c_smbus_write_msg* writes, bool repeated_start);
+
+    //Bus usage statistics and optional frame scheduler
+    void i2c_smbus_get_stats(i2c_smbus_stats* stats, bool reset);
+    void i2c_smbus_enable_scheduler(unsigned int fps);
+    i2c_smbus_scheduler* i2c_smbus_get_scheduler();
 
 private:
     std::thread *           i2c_smbus_thread;
@@ -133,7 +180,19 @@ private:
     i2c_smbus_data*     i2c_data_smbus;
     u8*                 i2c_data;
     s32                 i2c_ret;
-    bool                smbus_xfer;
+    int                 i2c_batch_count;
+    i2c_smbus_write_msg* i2c_batch;
+    bool                i2c_batch_repeated_start;
+    int                 xfer_type;
+
+    std::mutex                              i2c_smbus_stats_mutex;
+    unsigned int                            stats_transfers;
+    unsigned int                            stats_address_switches;
+    std::chrono::microseconds               stats_busy;
+    std::chrono::steady_clock::time_point   stats_start;
+    int                                     stats_last_addr;
+
+    i2c_smbus_scheduler *   scheduler;
 };
 
 #endif /* I2C_SMBUS_H */
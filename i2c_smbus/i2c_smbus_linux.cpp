@@ -16,13 +16,38 @@
 #include <sys/ioctl.h>
 #include <cstring>
 
+i2c_smbus_linux::i2c_smbus_linux()
+{
+    handle      = -1;
+    funcs       = 0;
+    slave_addr  = -1;
+}
+
+s32 i2c_smbus_linux::set_slave_addr(u8 addr)
+{
+    /*-----------------------------------------------------*\
+    | The slave address stays set on the file descriptor,   |
+    | so only tell the host when it changes                 |
+    \*-----------------------------------------------------*/
+    if(slave_addr == addr)
+    {
+        return 0;
+    }
+
+    s32 ret = ioctl(handle, I2C_SLAVE, addr);
+
+    slave_addr = (ret < 0) ? -1 : addr;
+
+    return ret;
+}
+
 s32 i2c_smbus_linux::i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, union i2c_smbus_data* data)
 {
 
     struct i2c_smbus_ioctl_data args;
 
     //Tell I2C host which slave address to transfer to
-    ioctl(handle, I2C_SLAVE, addr);
+    set_slave_addr(addr);
 
     args.read_write = read_write;
     args.command = command;
@@ -63,6 +88,129 @@ s32 i2c_smbus_linux::i2c_xfer(u8 addr, char read_write, int* size, u8* data)
     return ret_val;
 }
 
+s32 i2c_smbus_linux::i2c_smbus_batch_xfer(u8 addr, int count, i2c_smbus_write_msg* writes, bool repeated_start)
+{
+    /*-----------------------------------------------------*\
+    | Without plain I2C support the writes have to be sent  |
+    | as individual SMBus transactions                      |
+    \*-----------------------------------------------------*/
+    if(!(funcs & I2C_FUNC_I2C))
+    {
+        return i2c_smbus_interface::i2c_smbus_batch_xfer(addr, count, writes, repeated_start);
+    }
+
+    i2c_msg                 msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+    u8                      bufs[I2C_RDWR_IOCTL_MAX_MSGS][I2C_SMBUS_BLOCK_MAX + 2];
+    i2c_rdwr_ioctl_data     rdwr;
+
+    /*-----------------------------------------------------*\
+    | Only writes with a fixed wire format can be packed,   |
+    | fall back for anything else                           |
+    \*-----------------------------------------------------*/
+    for(int write_idx = 0; write_idx < count; write_idx++)
+    {
+        switch(writes[write_idx].size)
+        {
+            case I2C_SMBUS_BYTE:
+            case I2C_SMBUS_BYTE_DATA:
+            case I2C_SMBUS_WORD_DATA:
+            case I2C_SMBUS_BLOCK_DATA:
+            case I2C_SMBUS_I2C_BLOCK_DATA:
+                break;
+
+            default:
+                return i2c_smbus_interface::i2c_smbus_batch_xfer(addr, count, writes, repeated_start);
+        }
+    }
+
+    /*-----------------------------------------------------*\
+    | Encode each SMBus write as it appears on the wire.    |
+    | Messages of one I2C_RDWR ioctl are joined by repeated |
+    | starts, which not every SMBus device accepts, so each |
+    | write gets its own ioctl and STOP unless the caller   |
+    | opted in.  Opted in batches send up to                |
+    | I2C_RDWR_IOCTL_MAX_MSGS writes per ioctl              |
+    \*-----------------------------------------------------*/
+    int chunk_max = repeated_start ? I2C_RDWR_IOCTL_MAX_MSGS : 1;
+
+    for(int chunk_start = 0; chunk_start < count; chunk_start += chunk_max)
+    {
+        int chunk_count = count - chunk_start;
+
+        if(chunk_count > chunk_max)
+        {
+            chunk_count = chunk_max;
+        }
+
+        for(int msg_idx = 0; msg_idx < chunk_count; msg_idx++)
+        {
+            i2c_smbus_write_msg*    write   = &writes[chunk_start + msg_idx];
+            u8*                     buf     = bufs[msg_idx];
+            u16                     len     = 0;
+
+            buf[len++] = write->command;
+
+            switch(write->size)
+            {
+                case I2C_SMBUS_BYTE_DATA:
+                    buf[len++] = write->data.byte;
+                    break;
+
+                case I2C_SMBUS_WORD_DATA:
+                    buf[len++] = write->data.word & 0xFF;
+                    buf[len++] = write->data.word >> 8;
+                    break;
+
+                case I2C_SMBUS_BLOCK_DATA:
+                    {
+                        u8 block_len = write->data.block[0];
+
+                        if(block_len > I2C_SMBUS_BLOCK_MAX)
+                        {
+                            block_len = I2C_SMBUS_BLOCK_MAX;
+                        }
+
+                        buf[len++] = block_len;
+                        memcpy(&buf[len], &write->data.block[1], block_len);
+                        len += block_len;
+                    }
+                    break;
+
+                case I2C_SMBUS_I2C_BLOCK_DATA:
+                    {
+                        u8 block_len = write->data.block[0];
+
+                        if(block_len > I2C_SMBUS_BLOCK_MAX)
+                        {
+                            block_len = I2C_SMBUS_BLOCK_MAX;
+                        }
+
+                        memcpy(&buf[len], &write->data.block[1], block_len);
+                        len += block_len;
+                    }
+                    break;
+            }
+
+            msgs[msg_idx].addr  = addr;
+            msgs[msg_idx].flags = 0;
+            msgs[msg_idx].len   = len;
+            msgs[msg_idx].buf   = buf;
+        }
+
+        rdwr.msgs  = msgs;
+        rdwr.nmsgs = chunk_count;
+
+        s32 ret_val = ioctl(handle, I2C_RDWR, &rdwr);
+
+        if(ret_val < 0)
+        {
+            return ret_val;
+        }
+    }
+
+    return 0;
+}
+
 #include "Detector.h"
 #include <fcntl.h>
 #include <unistd.h>
@@ -236,6 +384,12 @@ bool i2c_smbus_linux_detect()
                     bus = new i2c_smbus_linux();
                     strcpy(bus->device_name, device_string);
                     bus->handle               = test_fd;
+
+                    if(test_fd < 0 || ioctl(test_fd, I2C_FUNCS, &bus->funcs) < 0)
+                    {
+                        bus->funcs            = 0;
+                    }
+
                     bus->pci_device           = pci_device;
                     bus->pci_vendor           = pci_vendor;
                     bus->pci_subsystem_device = pci_subsystem_device;
@@ -12,9 +12,24 @@
 class i2c_smbus_linux : public i2c_smbus_interface
 {
 public:
+    i2c_smbus_linux();
+
     int handle;
 
+    /*-----------------------------------------------------*\
+    | Adapter functionality mask from I2C_FUNCS             |
+    \*-----------------------------------------------------*/
+    unsigned long funcs;
+
 private:
+    /*-----------------------------------------------------*\
+    | Slave address last set with I2C_SLAVE, -1 if unknown |
+    \*-----------------------------------------------------*/
+    int slave_addr;
+
+    s32 set_slave_addr(u8 addr);
+
     s32 i2c_smbus_xfer(u8 addr, char read_write, u8 command, int size, i2c_smbus_data* data);
     s32 i2c_xfer(u8 addr, char read_write, int* size, u8* data);
+    s32 i2c_smbus_batch_xfer(u8 addr, int count, i2c_smbus_write_msg* writes, bool repeated_start);
 };
@@ -0,0 +1,262 @@
+/*-----------------------------------------*\
+|  i2c_smbus_scheduler.cpp                  |
+|                                           |
+|  Frame scheduler for RGB devices sharing  |
+|  one i2c/SMBus adapter                    |
+\*-----------------------------------------*/
+
+#include "i2c_smbus_scheduler.h"
+#include "LogManager.h"
+
+i2c_smbus_scheduler::i2c_smbus_scheduler(i2c_smbus_interface* bus, unsigned int fps)
+{
+    if(fps == 0)
+    {
+        fps = I2C_SMBUS_SCHEDULER_DEFAULT_FPS;
+    }
+
+    this->bus           = bus;
+    frame_period        = std::chrono::microseconds(1000000 / fps);
+    next_device         = 0;
+    stats               = {};
+
+    scheduler_running   = true;
+    scheduler_thread    = new std::thread(&i2c_smbus_scheduler::scheduler_thread_function, this);
+}
+
+i2c_smbus_scheduler::~i2c_smbus_scheduler()
+{
+    std::unique_lock<std::mutex> lock(scheduler_mutex);
+    scheduler_running = false;
+    scheduler_cv.notify_all();
+    lock.unlock();
+
+    scheduler_thread->join();
+    delete scheduler_thread;
+}
+
+void i2c_smbus_scheduler::add_device(void* owner, u8 addr, std::function<void()> update)
+{
+    std::lock_guard<std::mutex> update_lock(update_mutex);
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+
+    scheduled_device new_device;
+
+    new_device.owner    = owner;
+    new_device.addr     = addr;
+    new_device.pending  = false;
+    new_device.update   = update;
+
+    /*-----------------------------------------------------*\
+    | Keep the device list sorted by address                |
+    \*-----------------------------------------------------*/
+    std::vector<scheduled_device>::iterator it = devices.begin();
+
+    while(it != devices.end() && it->addr <= addr)
+    {
+        it++;
+    }
+
+    devices.insert(it, new_device);
+    next_device = 0;
+}
+
+void i2c_smbus_scheduler::remove_device(void* owner)
+{
+    std::lock_guard<std::mutex> update_lock(update_mutex);
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+
+    for(std::size_t device_idx = 0; device_idx < devices.size(); device_idx++)
+    {
+        if(devices[device_idx].owner == owner)
+        {
+            devices.erase(devices.begin() + device_idx);
+            break;
+        }
+    }
+
+    next_device = 0;
+}
+
+void i2c_smbus_scheduler::request_update(void* owner)
+{
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+
+    for(std::size_t device_idx = 0; device_idx < devices.size(); device_idx++)
+    {
+        if(devices[device_idx].owner == owner)
+        {
+            devices[device_idx].pending = true;
+            break;
+        }
+    }
+}
+
+unsigned int i2c_smbus_scheduler::get_frame_rate()
+{
+    return((unsigned int)(1000000 / frame_period.count()));
+}
+
+void i2c_smbus_scheduler::get_stats(i2c_smbus_scheduler_stats* stats, bool reset)
+{
+    std::lock_guard<std::mutex> lock(scheduler_mutex);
+
+    *stats = this->stats;
+
+    if(reset)
+    {
+        this->stats = {};
+    }
+}
+
+void i2c_smbus_scheduler::scheduler_thread_function()
+{
+    std::chrono::steady_clock::time_point next_frame = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point next_stats = next_frame + std::chrono::milliseconds(I2C_SMBUS_SCHEDULER_STATS_INTERVAL_MS);
+
+    std::unique_lock<std::mutex> lock(scheduler_mutex);
+
+    while(scheduler_running)
+    {
+        next_frame += frame_period;
+
+        scheduler_cv.wait_until(lock, next_frame, [this]{ return !scheduler_running; });
+
+        if(!scheduler_running)
+        {
+            break;
+        }
+
+        /*-----------------------------------------------------*\
+        | If the previous frame ran long, start the next frame  |
+        | from now rather than trying to catch up               |
+        \*-----------------------------------------------------*/
+        std::chrono::steady_clock::time_point frame_start = std::chrono::steady_clock::now();
+
+        if(frame_start > next_frame + frame_period)
+        {
+            next_frame = frame_start;
+        }
+
+        stats.frames++;
+
+        if(devices.empty())
+        {
+            continue;
+        }
+
+        /*-----------------------------------------------------*\
+        | Service pending devices in address order, starting   |
+        | with the first device deferred from the last frame    |
+        \*-----------------------------------------------------*/
+        std::chrono::microseconds   slice           = frame_period / (int)devices.size();
+        std::size_t                 device_count    = devices.size();
+        std::size_t                 start_device    = next_device % device_count;
+
+        next_device = 0;
+
+        for(std::size_t count = 0; count < device_count; count++)
+        {
+            std::size_t device_idx = (start_device + count) % device_count;
+
+            if(!devices[device_idx].pending)
+            {
+                continue;
+            }
+
+            std::chrono::steady_clock::time_point update_start = std::chrono::steady_clock::now();
+
+            if(update_start - frame_start >= frame_period)
+            {
+                next_device = device_idx;
+
+                for(std::size_t deferred_idx = count; deferred_idx < device_count; deferred_idx++)
+                {
+                    if(devices[(start_device + deferred_idx) % device_count].pending)
+                    {
+                        stats.deferred++;
+                    }
+                }
+                break;
+            }
+
+            devices[device_idx].pending = false;
+
+            void* owner = devices[device_idx].owner;
+
+            /*-----------------------------------------------------*\
+            | Run the update without the scheduler lock held so     |
+            | devices can request their next update meanwhile.      |
+            | The device may be removed while update_mutex is taken |
+            | so look it up again once it is held                   |
+            \*-----------------------------------------------------*/
+            lock.unlock();
+            update_mutex.lock();
+            lock.lock();
+
+            std::function<void()> update;
+
+            for(std::size_t check_idx = 0; check_idx < devices.size(); check_idx++)
+            {
+                if(devices[check_idx].owner == owner)
+                {
+                    update = devices[check_idx].update;
+                    break;
+                }
+            }
+
+            lock.unlock();
+
+            if(update)
+            {
+                update();
+            }
+
+            update_mutex.unlock();
+            lock.lock();
+
+            stats.updates++;
+
+            if(std::chrono::steady_clock::now() - update_start > slice)
+            {
+                stats.overruns++;
+            }
+
+            /*-----------------------------------------------------*\
+            | Stop if the device list changed during the update     |
+            \*-----------------------------------------------------*/
+            if(devices.size() != device_count)
+            {
+                break;
+            }
+        }
+
+        if(std::chrono::steady_clock::now() >= next_stats)
+        {
+            next_stats += std::chrono::milliseconds(I2C_SMBUS_SCHEDULER_STATS_INTERVAL_MS);
+
+            lock.unlock();
+            log_stats();
+            lock.lock();
+        }
+    }
+}
+
+void i2c_smbus_scheduler::log_stats()
+{
+    i2c_smbus_stats             bus_stats;
+    i2c_smbus_scheduler_stats   frame_stats;
+
+    bus->i2c_smbus_get_stats(&bus_stats, true);
+    get_stats(&frame_stats, true);
+
+    LOG_TRACE("[i2c_smbus_scheduler] %s: %u frames, %u updates, %u deferred, %u overruns, %u transfers, %u address switches, %.1f%% utilization",
+              bus->device_name,
+              frame_stats.frames,
+              frame_stats.updates,
+              frame_stats.deferred,
+              frame_stats.overruns,
+              bus_stats.transfers,
+              bus_stats.address_switches,
+              bus_stats.utilization * 100.0f);
+}
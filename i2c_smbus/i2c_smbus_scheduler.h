@@ -0,0 +1,86 @@
+/*-----------------------------------------*\
+|  i2c_smbus_scheduler.h                    |
+|                                           |
+|  Frame scheduler for RGB devices sharing  |
+|  one i2c/SMBus adapter                    |
+\*-----------------------------------------*/
+
+#pragma once
+
+#include "i2c_smbus.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define I2C_SMBUS_SCHEDULER_DEFAULT_FPS         30
+#define I2C_SMBUS_SCHEDULER_STATS_INTERVAL_MS   10000
+
+/*-----------------------------------------------------*\
+| Scheduler counters since the last reset               |
+\*-----------------------------------------------------*/
+struct i2c_smbus_scheduler_stats
+{
+    unsigned int    frames;
+    unsigned int    updates;
+    unsigned int    deferred;
+    unsigned int    overruns;
+};
+
+/*-----------------------------------------------------*\
+| Devices on the bus register an update function and    |
+| request updates instead of writing from their own     |
+| threads.  Once per frame the scheduler runs every     |
+| pending update in device address order, so the slave  |
+| address changes once per device per frame.  Each      |
+| device is allotted an equal slice of the frame; a     |
+| device that runs past its slice is counted as an      |
+| overrun, and devices that do not fit in the frame are |
+| deferred to the start of the next one                 |
+\*-----------------------------------------------------*/
+class i2c_smbus_scheduler
+{
+public:
+    i2c_smbus_scheduler(i2c_smbus_interface* bus, unsigned int fps);
+    ~i2c_smbus_scheduler();
+
+    void            add_device(void* owner, u8 addr, std::function<void()> update);
+    void            remove_device(void* owner);
+    void            request_update(void* owner);
+
+    unsigned int    get_frame_rate();
+    void            get_stats(i2c_smbus_scheduler_stats* stats, bool reset);
+
+private:
+    struct scheduled_device
+    {
+        void*                   owner;
+        u8                      addr;
+        bool                    pending;
+        std::function<void()>   update;
+    };
+
+    i2c_smbus_interface*                    bus;
+    std::chrono::microseconds               frame_period;
+
+    std::thread *                           scheduler_thread;
+    bool                                    scheduler_running;
+    std::mutex                              scheduler_mutex;
+    std::condition_variable                 scheduler_cv;
+
+    /*-----------------------------------------------------*\
+    | Devices sorted by address.  The update function of a  |
+    | device is only called with update_mutex held, so      |
+    | remove_device waits for a running update to finish    |
+    \*-----------------------------------------------------*/
+    std::vector<scheduled_device>           devices;
+    std::mutex                              update_mutex;
+    std::size_t                             next_device;
+
+    i2c_smbus_scheduler_stats               stats;
+
+    void            scheduler_thread_function();
+    void            log_stats();
+};
@@ -13,13 +13,20 @@
 #include <sys/ioctl.h>
 #include <netinet/tcp.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #endif
 #include <memory.h>
+#include <string.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <iostream>
 
-const char yes = 1;
+const int yes = 1;
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
 
 net_port::net_port()
 {
@@ -118,6 +125,304 @@ int net_port::udp_write(char * buffer, int length)
     return(sendto(sock, buffer, length, 0, (sockaddr *)&addrDest, sizeof(addrDest)));
 }
 
+/*---------------------------------------------------------*\
+| Maximum number of messages handed to one sendmmsg call    |
+\*---------------------------------------------------------*/
+#define NET_PORT_BATCH_MAX  1024
+
+/*---------------------------------------------------------*\
+| Send a list of datagrams, returning the number that were  |
+| handed to the network stack.  On Linux the whole list is  |
+| sent with sendmmsg in as few system calls as possible,    |
+| other platforms use one sendto per datagram.  If sendmmsg |
+| fails, the datagram it stopped at is sent on its own with |
+| sendto so one bad call does not drop it                   |
+\*---------------------------------------------------------*/
+int net_port::udp_send_batch(SOCKET sock, const std::vector<net_port_datagram>& datagrams)
+{
+    int sent = 0;
+
+#ifdef __linux__
+    std::size_t     count = std::min(datagrams.size(), (std::size_t)NET_PORT_BATCH_MAX);
+    std::vector<mmsghdr> msgs(count);
+    std::vector<iovec>   iovs(count);
+
+    std::size_t datagram_idx = 0;
+
+    while(datagram_idx < datagrams.size())
+    {
+        std::size_t chunk = std::min(datagrams.size() - datagram_idx, count);
+
+        for(std::size_t msg_idx = 0; msg_idx < chunk; msg_idx++)
+        {
+            const net_port_datagram& datagram = datagrams[datagram_idx + msg_idx];
+
+            iovs[msg_idx].iov_base          = (void *)datagram.buffer;
+            iovs[msg_idx].iov_len           = datagram.length;
+
+            memset(&msgs[msg_idx], 0, sizeof(mmsghdr));
+            msgs[msg_idx].msg_hdr.msg_name      = (void *)datagram.addr;
+            msgs[msg_idx].msg_hdr.msg_namelen   = datagram.addr_len;
+            msgs[msg_idx].msg_hdr.msg_iov       = &iovs[msg_idx];
+            msgs[msg_idx].msg_hdr.msg_iovlen    = 1;
+        }
+
+        int ret = sendmmsg(sock, msgs.data(), (unsigned int)chunk, 0);
+
+        if(ret < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            ret = 0;
+        }
+
+        if(ret == 0)
+        {
+            /*---------------------------------------------*\
+            | Fall back to a single send for the datagram   |
+            | the batch stopped at, then carry on with the  |
+            | rest of the batch so one bad destination does |
+            | not stall the whole frame                     |
+            \*---------------------------------------------*/
+            const net_port_datagram& datagram = datagrams[datagram_idx];
+
+            if(sendto(sock, datagram.buffer, datagram.length, 0, datagram.addr, datagram.addr_len) != SOCKET_ERROR)
+            {
+                sent++;
+            }
+
+            datagram_idx++;
+            continue;
+        }
+
+        sent         += ret;
+        datagram_idx += ret;
+    }
+#else
+    for(std::size_t datagram_idx = 0; datagram_idx < datagrams.size(); datagram_idx++)
+    {
+        const net_port_datagram& datagram = datagrams[datagram_idx];
+
+        if(sendto(sock, datagram.buffer, datagram.length, 0, datagram.addr, datagram.addr_len) != SOCKET_ERROR)
+        {
+            sent++;
+        }
+    }
+#endif
+
+    return(sent);
+}
+
+/*---------------------------------------------------------*\
+| Send a list of buffers on a stream socket as one message, |
+| using sendmsg or WSASend so the buffers go out in a       |
+| single system call.  Partial writes are continued until   |
+| everything is sent.  Returns the number of bytes sent, or |
+| SOCKET_ERROR                                              |
+\*---------------------------------------------------------*/
+int net_port::tcp_send_buffers(SOCKET sock, const net_port_buffer * buffers, int count)
+{
+#ifdef WIN32
+    std::vector<WSABUF> bufs(count);
+#else
+    std::vector<iovec>  bufs(count);
+#endif
+    int total = 0;
+
+    for(int buffer_idx = 0; buffer_idx < count; buffer_idx++)
+    {
+#ifdef WIN32
+        bufs[buffer_idx].buf        = (char *)buffers[buffer_idx].buffer;
+        bufs[buffer_idx].len        = buffers[buffer_idx].length;
+#else
+        bufs[buffer_idx].iov_base   = (void *)buffers[buffer_idx].buffer;
+        bufs[buffer_idx].iov_len    = buffers[buffer_idx].length;
+#endif
+        total += buffers[buffer_idx].length;
+    }
+
+    int first = 0;
+    int sent  = 0;
+
+    while(sent < total)
+    {
+#ifdef WIN32
+        DWORD   bytes_sent = 0;
+
+        if(WSASend(sock, &bufs[first], count - first, &bytes_sent, 0, NULL, NULL) == SOCKET_ERROR)
+        {
+            return(SOCKET_ERROR);
+        }
+
+        int     ret = (int)bytes_sent;
+#else
+        msghdr  msg = {};
+
+        msg.msg_iov     = &bufs[first];
+        msg.msg_iovlen  = count - first;
+
+        int     ret = sendmsg(sock, &msg, MSG_NOSIGNAL);
+
+        if(ret < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+
+            return(SOCKET_ERROR);
+        }
+#endif
+        sent += ret;
+
+        /*-----------------------------------------------------*\
+        | Skip the buffers that were sent completely and trim   |
+        | the one that was sent in part                         |
+        \*-----------------------------------------------------*/
+        while(first < count && ret > 0)
+        {
+#ifdef WIN32
+            int length = (int)bufs[first].len;
+#else
+            int length = (int)bufs[first].iov_len;
+#endif
+            if(ret < length)
+            {
+#ifdef WIN32
+                bufs[first].buf         += ret;
+                bufs[first].len         -= ret;
+#else
+                bufs[first].iov_base     = (char *)bufs[first].iov_base + ret;
+                bufs[first].iov_len     -= ret;
+#endif
+                break;
+            }
+
+            ret -= length;
+            first++;
+        }
+    }
+
+    return(sent);
+}
+
+net_port_writer::net_port_writer()
+{
+    sock                = INVALID_SOCKET;
+    flushing            = false;
+    queued_generation   = 0;
+    flushed_generation  = 0;
+    sent_generation     = 0;
+}
+
+void net_port_writer::set_socket(SOCKET new_sock)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    flushed.wait(lock, [this]{ return(!flushing); });
+
+    sock = new_sock;
+}
+
+int net_port_writer::write(const net_port_buffer * buffers, int count)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if(sock == INVALID_SOCKET)
+    {
+        return(SOCKET_ERROR);
+    }
+
+    /*-----------------------------------------------------*\
+    | Another thread is writing, queue this message and     |
+    | wait until it has gone out with the rest of the queue |
+    \*-----------------------------------------------------*/
+    if(flushing)
+    {
+        int length = 0;
+
+        for(int buffer_idx = 0; buffer_idx < count; buffer_idx++)
+        {
+            pending.insert(pending.end(), buffers[buffer_idx].buffer, buffers[buffer_idx].buffer + buffers[buffer_idx].length);
+            length += buffers[buffer_idx].length;
+        }
+
+        unsigned long long generation = ++queued_generation;
+
+        flushed.wait(lock, [this, generation]{ return(flushed_generation >= generation); });
+
+        if(sent_generation < generation)
+        {
+            return(SOCKET_ERROR);
+        }
+
+        return(length);
+    }
+
+    /*-----------------------------------------------------*\
+    | Nothing in flight, send this message directly from    |
+    | the caller's buffers                                  |
+    \*-----------------------------------------------------*/
+    SOCKET write_sock = sock;
+
+    flushing = true;
+    lock.unlock();
+
+    int result = net_port::tcp_send_buffers(write_sock, buffers, count);
+
+    lock.lock();
+
+    /*-----------------------------------------------------*\
+    | Send whatever was queued in the meantime, one write   |
+    | per batch, until the queue is empty.  After a failed  |
+    | send the stream is broken, so the rest of the queue   |
+    | is dropped rather than sent                           |
+    \*-----------------------------------------------------*/
+    bool failed = (result < 0);
+
+    while(!pending.empty())
+    {
+        unsigned long long generation = queued_generation;
+
+        if(failed)
+        {
+            pending.clear();
+        }
+        else
+        {
+            sending.swap(pending);
+            lock.unlock();
+
+            net_port_buffer batch = { sending.data(), (int)sending.size() };
+
+            int batch_result = net_port::tcp_send_buffers(write_sock, &batch, 1);
+
+            lock.lock();
+            sending.clear();
+
+            if(batch_result < 0)
+            {
+                failed = true;
+            }
+            else
+            {
+                sent_generation = generation;
+            }
+        }
+
+        flushed_generation = generation;
+        flushed.notify_all();
+    }
+
+    flushing = false;
+    flushed.notify_all();
+
+    return(result);
+}
+
 bool net_port::tcp_client(const char * client_name, const char * port)
 {
     addrinfo    hints = {};
@@ -184,7 +489,7 @@ bool net_port::tcp_client_connect()
         /*-------------------------------------------------*\
         | Set socket options - no delay                     |
         \*-------------------------------------------------*/
-        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&yes, sizeof(yes));
 
         if(select(sock + 1, NULL, &fdset, NULL, &tv) == 1)
         {
@@ -214,6 +519,63 @@ bool net_port::tcp_client_connect()
     return(connected);
 }
 
+bool net_port::unix_client(const char * path)
+{
+    connected = false;
+
+#ifdef WIN32
+    (void)path;
+
+    return(false);
+#else
+    sockaddr_un addr;
+
+    if(strlen(path) >= sizeof(addr.sun_path))
+    {
+        return(false);
+    }
+
+    unix_path = path;
+
+    return(true);
+#endif
+}
+
+bool net_port::unix_client_connect()
+{
+    connected = false;
+
+#ifdef WIN32
+    return(false);
+#else
+    sockaddr_un addr = {};
+
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, unix_path.c_str(), sizeof(addr.sun_path) - 1);
+
+    sock = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if(sock == INVALID_SOCKET)
+    {
+        return(false);
+    }
+
+    /*-------------------------------------------------*\
+    | Connecting to a local socket does not block on    |
+    | the network, so no connect timeout is needed      |
+    \*-------------------------------------------------*/
+    if(connect(sock, (sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR)
+    {
+        closesocket(sock);
+        return(false);
+    }
+
+    connected = true;
+
+    return(connected);
+#endif
+}
+
 bool net_port::tcp_server(const char * port)
 {
     sockaddr_in myAddress;
@@ -260,7 +622,7 @@ bool net_port::tcp_server(const char * port)
     /*-------------------------------------------------*\
     | Set socket options - no delay                     |
     \*-------------------------------------------------*/
-    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (const char *)&yes, sizeof(yes));
 
     return(true);
 }
@@ -290,7 +652,7 @@ SOCKET * net_port::tcp_server_listen()
     \*-------------------------------------------------*/
     u_long arg = 0;
     ioctlsocket(*client, FIONBIO, &arg);
-    setsockopt(*client, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+    setsockopt(*client, IPPROTO_TCP, TCP_NODELAY, (const char *)&yes, sizeof(yes));
     clients.push_back(client);
 
     return client;
@@ -10,6 +10,9 @@
 #ifndef NET_PORT_H
 #define NET_PORT_H
 
+#include <condition_variable>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #ifdef WIN32
@@ -28,6 +31,7 @@
 #include <netdb.h>
 #include <ifaddrs.h>
 #include <net/if.h>
+#include <sys/un.h>
 #endif
 
 #ifndef WIN32
@@ -38,8 +42,29 @@
 #define INVALID_SOCKET -1
 #define SOCKET_ERROR -1
 #define SD_RECEIVE SHUT_RD
+#define SD_BOTH SHUT_RDWR
 #endif
 
+/*---------------------------------------------------------*\
+| Datagram descriptor for batched UDP transmit              |
+\*---------------------------------------------------------*/
+struct net_port_datagram
+{
+    const char *        buffer;
+    int                 length;
+    const sockaddr *    addr;
+    int                 addr_len;
+};
+
+/*---------------------------------------------------------*\
+| Buffer descriptor for gathered stream writes              |
+\*---------------------------------------------------------*/
+struct net_port_buffer
+{
+    const char *        buffer;
+    int                 length;
+};
+
 //Network Port Class
 //The reason for this class is that network ports are treated differently
 //on Windows and Linux.  By creating a class, those differences can be
@@ -58,6 +83,10 @@ public:
     bool tcp_client(const char* client_name, const char * port);
     bool tcp_client_connect();
 
+    //Function to open a Unix domain stream socket (not available on Windows)
+    bool unix_client(const char* path);
+    bool unix_client_connect();
+
     //Function to open a server
     bool        tcp_server(const char * port);
     std::size_t tcp_server_num_clients();
@@ -73,6 +102,12 @@ public:
     int tcp_write(char * buffer, int length);
     int tcp_client_write(char * buffer, int length);
 
+    //Function to send a batch of datagrams, using sendmmsg where available
+    static int udp_send_batch(SOCKET sock, const std::vector<net_port_datagram>& datagrams);
+
+    //Function to write a list of buffers to a stream socket with one gathered write
+    static int tcp_send_buffers(SOCKET sock, const net_port_buffer * buffers, int count);
+
     void tcp_close();
 
     bool connected;
@@ -87,6 +122,40 @@ private:
 
     sockaddr addrDest;
     addrinfo*   result_list;
+
+    std::string unix_path;
+};
+
+/*---------------------------------------------------------*\
+| Stream writer shared by all threads sending on a socket.  |
+| Each message is sent with one gathered write.  Messages   |
+| written while another thread's write is in progress are   |
+| queued and sent together in a single write once it        |
+| finishes, and their writers wait until that is done.      |
+| Once a send fails nothing more is flushed and the writers |
+| of the failed and dropped batches get SOCKET_ERROR.       |
+| set_socket waits for a write in progress to finish, so    |
+| setting INVALID_SOCKET before closing the socket ensures  |
+| no thread is still sending on it                          |
+\*---------------------------------------------------------*/
+class net_port_writer
+{
+public:
+    net_port_writer();
+
+    void set_socket(SOCKET new_sock);
+    int  write(const net_port_buffer * buffers, int count);
+
+private:
+    SOCKET                  sock;
+    std::mutex              mutex;
+    std::condition_variable flushed;
+    bool                    flushing;
+    std::vector<char>       pending;
+    std::vector<char>       sending;
+    unsigned long long      queued_generation;
+    unsigned long long      flushed_generation;
+    unsigned long long      sent_generation;
 };
 
 #endif
@@ -17,6 +17,7 @@
 #include <QtCore/qmath.h>
 #include <QDebug>
 #include <QMouseEvent>
+#include <QPaintEvent>
 
 #define MAX_COLS    20
 #define PAD_LED     0.1
@@ -36,6 +37,14 @@ DeviceView::DeviceView(QWidget *parent) :
     setMouseTracking(1);
 
     size = width();
+
+    /*-----------------------------------------------------*\
+    | Deferred refresh used when color updates arrive       |
+    | faster than the refresh cap                           |
+    \*-----------------------------------------------------*/
+    refresh_timer = new QTimer(this);
+    refresh_timer->setSingleShot(true);
+    connect(refresh_timer, &QTimer::timeout, this, &DeviceView::updateColors);
 }
 
 DeviceView::~DeviceView()
@@ -550,6 +559,75 @@ void DeviceView::InitDeviceView()
         size     = height() / matrix_h;
         offset_x = (width() - size) / 2;
     }
+
+    updateLedRects();
+}
+
+void DeviceView::updateLedRects()
+{
+    /*-----------------------------------------------------*\
+    | Cache the pixel rectangle of each LED for the current |
+    | size so repaints and dirty checks skip the math       |
+    \*-----------------------------------------------------*/
+    led_rects.resize(led_pos.size());
+
+    for(std::size_t led_idx = 0; led_idx < led_pos.size(); led_idx++)
+    {
+        int posx = led_pos[led_idx].matrix_x * size + offset_x;
+        int posy = led_pos[led_idx].matrix_y * size;
+        int posw = led_pos[led_idx].matrix_w * size;
+        int posh = led_pos[led_idx].matrix_h * size;
+
+        led_rects[led_idx] = {posx, posy, posw, posh};
+    }
+}
+
+void DeviceView::updateColors()
+{
+    /*-----------------------------------------------------*\
+    | Skip all work while the view cannot be seen, a full   |
+    | repaint happens when it is shown again                |
+    \*-----------------------------------------------------*/
+    if(controller == NULL || !per_led || !isVisible() || window()->isMinimized())
+    {
+        return;
+    }
+
+    /*-----------------------------------------------------*\
+    | Cap the refresh rate, deferring to the timer if the   |
+    | last refresh was too recent                           |
+    \*-----------------------------------------------------*/
+    if(last_refresh.isValid() && last_refresh.elapsed() < DEVICE_VIEW_MIN_REFRESH_MS)
+    {
+        if(!refresh_timer->isActive())
+        {
+            refresh_timer->start(DEVICE_VIEW_MIN_REFRESH_MS - last_refresh.elapsed());
+        }
+        return;
+    }
+
+    last_refresh.start();
+
+    /*-----------------------------------------------------*\
+    | If the LED layout changed, repaint everything         |
+    \*-----------------------------------------------------*/
+    if(controller->leds.size() != led_pos.size() || controller->colors.size() != drawn_colors.size())
+    {
+        update();
+        return;
+    }
+
+    /*-----------------------------------------------------*\
+    | Only invalidate LEDs whose color changed since they   |
+    | were last drawn                                       |
+    \*-----------------------------------------------------*/
+    for(std::size_t led_idx = 0; led_idx < led_rects.size(); led_idx++)
+    {
+        if(controller->colors[led_idx] != drawn_colors[led_idx])
+        {
+            update(led_rects[led_idx]);
+        }
+    }
 }
 
 void DeviceView::setNumericalLabels(bool enable)
@@ -697,10 +775,17 @@ void DeviceView::resizeEvent(QResizeEvent* /*event*/)
         size     = height() / matrix_h;
         offset_x = (width() - size) / 2;
     }
+
+    updateLedRects();
     update();
 }
 
-void DeviceView::paintEvent(QPaintEvent* /* event */)
+void DeviceView::showEvent(QShowEvent* /*event*/)
+{
+    update();
+}
+
+void DeviceView::paintEvent(QPaintEvent* event)
 {
     QPainter painter(this);
     QFont font = painter.font();
@@ -721,17 +806,25 @@ void DeviceView::paintEvent(QPaintEvent* /* event */)
         InitDeviceView();
     }
 
+    drawn_colors.resize(controller->colors.size());
+
+    const QRegion& dirty = event->region();
+
     /*-----------------------------------------------------*\
-    | LED rectangles                                        |
+    | LED rectangles, skipping those outside the region     |
+    | being repainted                                       |
     \*-----------------------------------------------------*/
     for(std::size_t led_idx = 0; led_idx < controller->leds.size(); led_idx++)
     {
-        int posx = led_pos[led_idx].matrix_x * size + offset_x;
-        int posy = led_pos[led_idx].matrix_y * size;
-        int posw = led_pos[led_idx].matrix_w * size;
-        int posh = led_pos[led_idx].matrix_h * size;
+        const QRect& rect = led_rects[led_idx];
+        int          posh = rect.height();
 
-        QRect rect = {posx, posy, posw, posh};
+        if(!dirty.intersects(rect))
+        {
+            continue;
+        }
+
+        drawn_colors[led_idx] = controller->colors[led_idx];
 
         /*-----------------------------------------------------*\
         | Fill color                                            |
@@ -792,15 +885,18 @@ void DeviceView::paintEvent(QPaintEvent* /* event */)
 
         QRect rect = {posx, posy, posw, posh};
 
-        if(rect.contains(lastMousePos) && (!mouseDown || !mouseMoved))
-        {
-            painter.setPen(palette().highlight().color());
-        }
-        else
+        if(dirty.intersects(rect))
         {
-            painter.setPen(palette().windowText().color());
+            if(rect.contains(lastMousePos) && (!mouseDown || !mouseMoved))
+            {
+                painter.setPen(palette().highlight().color());
+            }
+            else
+            {
+                painter.setPen(palette().windowText().color());
+            }
+            painter.drawText(posx, posy + posh, QString(controller->zones[zone_idx].name.c_str()));
         }
-        painter.drawText(posx, posy + posh, QString(controller->zones[zone_idx].name.c_str()));
 
         for(std::size_t segment_idx = 0; segment_idx < controller->zones[zone_idx].segments.size(); segment_idx++)
         {
@@ -813,6 +909,11 @@ void DeviceView::paintEvent(QPaintEvent* /* event */)
 
             rect = {posx, posy, posw, posh};
 
+            if(!dirty.intersects(rect))
+            {
+                continue;
+            }
+
             if(rect.contains(lastMousePos) && (!mouseDown || !mouseMoved))
             {
                 painter.setPen(palette().highlight().color());
@@ -1,9 +1,17 @@
 #ifndef DEVICEVIEW_H
 #define DEVICEVIEW_H
 
+#include <QElapsedTimer>
+#include <QTimer>
 #include <QWidget>
 #include "RGBController.h"
 
+/*-----------------------------------------------------*\
+| Minimum interval between color refreshes, caps the    |
+| view at about 30 FPS regardless of effect frame rate  |
+\*-----------------------------------------------------*/
+#define DEVICE_VIEW_MIN_REFRESH_MS  33
+
 typedef struct
 {
     float matrix_x;
@@ -31,7 +39,8 @@ protected:
     void mouseMoveEvent(QMouseEvent *event);
     void mouseReleaseEvent(QMouseEvent *);
     void resizeEvent(QResizeEvent *event);
-    void paintEvent(QPaintEvent *);
+    void showEvent(QShowEvent *event);
+    void paintEvent(QPaintEvent *event);
 
 private:
     QSize initSize;
@@ -53,14 +62,21 @@ private:
     std::vector<matrix_pos_size_type>   led_pos;
     std::vector<QString>                led_labels;
 
+    std::vector<QRect>                  led_rects;
+    std::vector<RGBColor>               drawn_colors;
+
     float                               matrix_h;
 
+    QTimer*                             refresh_timer;
+    QElapsedTimer                       last_refresh;
+
     bool                                numerical_labels;
 
     RGBController* controller;
 
     QColor posColor(const QPoint &point);
     void InitDeviceView();
+    void updateLedRects();
     void updateSelection();
 
 signals:
@@ -73,6 +89,7 @@ public slots:
     bool selectZone(int zone, bool add = false);
     void clearSelection(); // Same as selecting the entire device
     void setSelectionColor(RGBColor);
+    void updateColors();
 };
 
 #endif // DEVICEVIEW_H
@@ -763,7 +763,7 @@ void Ui::OpenRGBDevicePage::on_DirectionBox_currentIndexChanged(int /*index*/)
 void Ui::OpenRGBDevicePage::UpdateInterface()
 {
     //UpdateModeUi();
-    ui->DeviceViewBox->repaint();
+    ui->DeviceViewBox->updateColors();
 }
 
 void Ui::OpenRGBDevicePage::UpdateModeUi()
@@ -1241,7 +1241,7 @@ void Ui::OpenRGBDevicePage::SetDevice(unsigned char red, unsigned char green, un
 void Ui::OpenRGBDevicePage::UpdateDevice()
 {
     ui->ModeBox->blockSignals(true);
-    ui->ModeBox->setCurrentIndex(device->active_mode);
+    ui->ModeBox->setCurrentIndex(device->GetMode());
     ui->ModeBox->blockSignals(false);
     UpdateModeUi();
     UpdateMode();
@@ -1255,7 +1255,7 @@ void Ui::OpenRGBDevicePage::SetCustomMode(unsigned char red, unsigned char green
     \*-----------------------------------------------------*/
     device->SetCustomMode();
     ui->ModeBox->blockSignals(true);
-    ui->ModeBox->setCurrentIndex(device->active_mode);
+    ui->ModeBox->setCurrentIndex(device->GetMode());
     ui->ModeBox->blockSignals(false);
     UpdateModeUi();
 
@@ -1308,7 +1308,7 @@ void Ui::OpenRGBDevicePage::on_ColorWheelBox_colorChanged(const QColor color)
 
 bool Ui::OpenRGBDevicePage::autoUpdateEnabled()
 {
-    return !(device->modes[device->active_mode].flags & MODE_FLAG_AUTOMATIC_SAVE);
+    return !(device->modes[device->GetMode()].flags & MODE_FLAG_AUTOMATIC_SAVE);
 }
 
 void Ui::OpenRGBDevicePage::on_RedSpinBox_valueChanged(int red)
@@ -1358,7 +1358,7 @@ void Ui::OpenRGBDevicePage::on_ValSpinBox_valueChanged(int val)
 
 void Ui::OpenRGBDevicePage::on_DeviceViewBox_selectionChanged(QVector<int> indices)
 {
-    if(device->modes[device->active_mode].color_mode == MODE_COLORS_PER_LED)
+    if(device->modes[device->GetMode()].color_mode == MODE_COLORS_PER_LED)
     {
         ui->ZoneBox->blockSignals(true);
         ui->LEDBox->blockSignals(true);
@@ -1408,7 +1408,7 @@ void Ui::OpenRGBDevicePage::on_SetAllButton_clicked()
 
 void Ui::OpenRGBDevicePage::on_EditZoneButton_clicked()
 {
-    switch(device->modes[device->active_mode].color_mode)
+    switch(device->modes[device->GetMode()].color_mode)
     {
     case MODE_COLORS_PER_LED:
         {
@@ -1519,15 +1519,15 @@ void Ui::OpenRGBDevicePage::on_EditZoneButton_clicked()
 
     case MODE_COLORS_MODE_SPECIFIC:
         {
-            OpenRGBZoneResizeDialog dlg(device->modes[device->active_mode].colors_min,
-                                        device->modes[device->active_mode].colors_max,
-                                        (int)device->modes[device->active_mode].colors.size());
+            OpenRGBZoneResizeDialog dlg(device->modes[device->GetMode()].colors_min,
+                                        device->modes[device->GetMode()].colors_max,
+                                        (int)device->modes[device->GetMode()].colors.size());
 
             int new_size = dlg.show();
 
             if(new_size > 0)
             {
-                device->modes[device->active_mode].colors.resize(new_size);
+                device->modes[device->GetMode()].colors.resize(new_size);
             }
 
             UpdateModeUi();
@@ -1602,7 +1602,7 @@ void Ui::OpenRGBDevicePage::on_ApplyColorsButton_clicked()
 
 void Ui::OpenRGBDevicePage::on_SelectAllLEDsButton_clicked()
 {
-    if(device->modes[device->active_mode].color_mode == MODE_COLORS_PER_LED)
+    if(device->modes[device->GetMode()].color_mode == MODE_COLORS_PER_LED)
     {
         ui->LEDBox->setCurrentIndex(0);
         on_LEDBox_currentIndexChanged(0);
@@ -1612,7 +1612,7 @@ void Ui::OpenRGBDevicePage::on_SelectAllLEDsButton_clicked()
 
 void Ui::OpenRGBDevicePage::on_DeviceSaveButton_clicked()
 {
-    if(device->modes[device->active_mode].flags & MODE_FLAG_MANUAL_SAVE)
+    if(device->modes[device->GetMode()].flags & MODE_FLAG_MANUAL_SAVE)
     {
         device->SaveMode();
     }
@@ -1320,191 +1320,250 @@ void OpenRGBDialog2::AddServerTab()
 
 void OpenRGBDialog2::ClearDevicesList()
 {
-    for(int tab_idx = 0; tab_idx < ui->DevicesTabBar->count(); tab_idx++)
+    std::vector<RGBController*> controllers;
+
+    for(std::unordered_map<RGBController*, QWidget*>::iterator it = device_tabs.begin(); it != device_tabs.end(); it++)
     {
-        if(dynamic_cast<OpenRGBPluginContainer*>(ui->DevicesTabBar->widget(tab_idx)) == nullptr)
-        {
-            delete ui->DevicesTabBar->widget(tab_idx);
-            ui->DevicesTabBar->removeTab(tab_idx);
-        }
+        controllers.push_back(it->first);
     }
 
-    for(int tab_idx = 0; tab_idx < ui->InformationTabBar->count(); tab_idx++)
+    for(std::size_t controller_idx = 0; controller_idx < controllers.size(); controller_idx++)
     {
-        if(dynamic_cast<OpenRGBPluginContainer*>(ui->InformationTabBar->widget(tab_idx)) == nullptr)
-        {
-            delete ui->InformationTabBar->widget(tab_idx);
-            ui->InformationTabBar->removeTab(tab_idx);
-        }
+        RemoveDeviceTabs(controllers[controller_idx]);
     }
 }
 
 void OpenRGBDialog2::UpdateDevicesList()
 {
-    std::vector<RGBController *> controllers = ResourceManager::get()->GetRGBControllers();
+    std::vector<RGBController *>& controllers = ResourceManager::get()->GetRGBControllers();
 
     /*-----------------------------------------------------*\
-    | Loop through each controller in the list.             |
+    | Index the current controller list                     |
     \*-----------------------------------------------------*/
+    std::unordered_map<RGBController*, unsigned int> controller_indices;
+
     for(unsigned int controller_idx = 0; controller_idx < controllers.size(); controller_idx++)
     {
-        /*-----------------------------------------------------*\
-        | Loop through each tab in the devices tab bar          |
-        \*-----------------------------------------------------*/
-        bool found = false;
+        controller_indices[controllers[controller_idx]] = controller_idx;
+    }
 
-        for(int tab_idx = 0; tab_idx < ui->DevicesTabBar->count(); tab_idx++)
+    /*-----------------------------------------------------*\
+    | Remove tabs of controllers no longer in the list      |
+    \*-----------------------------------------------------*/
+    std::vector<RGBController*> removed_controllers;
+
+    for(std::unordered_map<RGBController*, QWidget*>::iterator it = device_tabs.begin(); it != device_tabs.end(); it++)
+    {
+        if(controller_indices.find(it->first) == controller_indices.end())
         {
-            QWidget* page = ui->DevicesTabBar->widget(tab_idx);
+            removed_controllers.push_back(it->first);
+        }
+    }
 
-            if(dynamic_cast<OpenRGBDevicePage*>(page) != nullptr)
-            {
-                /*-----------------------------------------------------*\
-                | If the current tab matches the current controller,    |
-                | move the tab to the correct position                  |
-                \*-----------------------------------------------------*/
-                if(controllers[controller_idx] == ((OpenRGBDevicePage*)page)->GetController())
-                {
-                    found = true;
-                    ui->DevicesTabBar->tabBar()->moveTab(tab_idx, controller_idx);
-                    break;
-                }
-            }
+    for(std::size_t removed_idx = 0; removed_idx < removed_controllers.size(); removed_idx++)
+    {
+        RemoveDeviceTabs(removed_controllers[removed_idx]);
+    }
+
+    /*-----------------------------------------------------*\
+    | Add tabs for new controllers, then move each device   |
+    | tab to its controller's position                      |
+    \*-----------------------------------------------------*/
+    for(unsigned int controller_idx = 0; controller_idx < controllers.size(); controller_idx++)
+    {
+        if(device_tabs.find(controllers[controller_idx]) == device_tabs.end())
+        {
+            AddDeviceTabs(controllers[controller_idx]);
         }
 
-        if(!found)
+        int device_tab_idx = ui->DevicesTabBar->indexOf(device_tabs[controllers[controller_idx]]);
+
+        if(device_tab_idx != (int)controller_idx)
         {
-            /*-----------------------------------------------------*\
-            | The controller does not have a tab already created    |
-            | Create a new tab and move it to the correct position  |
-            \*-----------------------------------------------------*/
-            OpenRGBDevicePage *NewPage = new OpenRGBDevicePage(controllers[controller_idx]);
-            ui->DevicesTabBar->addTab(NewPage, "");
+            ui->DevicesTabBar->tabBar()->moveTab(device_tab_idx, controller_idx);
+        }
 
-            /*-----------------------------------------------------*\
-            | Connect the page's Set All button to the Set All slot |
-            \*-----------------------------------------------------*/
-            connect(NewPage,
-                    SIGNAL(SetAllDevices(unsigned char, unsigned char, unsigned char)),
-                    this,
-                    SLOT(on_SetAllDevices(unsigned char, unsigned char, unsigned char)));
+        int info_tab_idx = ui->InformationTabBar->indexOf(information_tabs[controllers[controller_idx]]);
 
-            /*-----------------------------------------------------*\
-            | Connect the page's Resize signal to the Save Size slot|
-            \*-----------------------------------------------------*/
-            connect(NewPage,
-                    SIGNAL(SaveSizeProfile()),
-                    this,
-                    SLOT(on_SaveSizeProfile()));
+        if(info_tab_idx != (int)controller_idx)
+        {
+            ui->InformationTabBar->tabBar()->moveTab(info_tab_idx, controller_idx);
+        }
+    }
 
-            /*-----------------------------------------------------*\
-            | Create the tab label                                  |
-            \*-----------------------------------------------------*/
-            TabLabel* NewTabLabel = new TabLabel(GetIconString(controllers[controller_idx]->type, OpenRGBThemeManager::IsDarkTheme()), QString::fromStdString(controllers[controller_idx]->name), (char *)controllers[controller_idx]->name.c_str(), (char *)context);
+    /*-----------------------------------------------------*\
+    | Build the pages of the tabs currently shown           |
+    \*-----------------------------------------------------*/
+    MaterializeDeviceTab(ui->DevicesTabBar, ui->DevicesTabBar->currentIndex());
+    MaterializeDeviceTab(ui->InformationTabBar, ui->InformationTabBar->currentIndex());
+}
 
-            ui->DevicesTabBar->tabBar()->setTabButton(ui->DevicesTabBar->count() - 1, QTabBar::LeftSide, NewTabLabel);
-            ui->DevicesTabBar->tabBar()->setTabToolTip(ui->DevicesTabBar->count() - 1, QString::fromStdString(controllers[controller_idx]->name));
+void OpenRGBDialog2::AddDeviceTabs(RGBController* controller)
+{
+    /*-----------------------------------------------------*\
+    | Add placeholder tabs to the devices and information   |
+    | tab bars, the pages are created when first shown      |
+    \*-----------------------------------------------------*/
+    QTabWidget*                                     tab_bars[2] = { ui->DevicesTabBar, ui->InformationTabBar };
+    std::unordered_map<RGBController*, QWidget*>*   tab_maps[2] = { &device_tabs, &information_tabs };
 
-            /*-----------------------------------------------------*\
-            | Now move the new tab to the correct position          |
-            \*-----------------------------------------------------*/
-            ui->DevicesTabBar->tabBar()->moveTab(ui->DevicesTabBar->count() - 1, controller_idx);
-        }
+    for(unsigned int bar_idx = 0; bar_idx < 2; bar_idx++)
+    {
+        QWidget* placeholder = new QWidget();
+
+        tab_bars[bar_idx]->blockSignals(true);
+        tab_bars[bar_idx]->addTab(placeholder, "");
+        tab_bars[bar_idx]->blockSignals(false);
 
         /*-----------------------------------------------------*\
-        | Loop through each tab in the information tab bar      |
+        | Create the tab label                                  |
         \*-----------------------------------------------------*/
-        found = false;
+        TabLabel* NewTabLabel = new TabLabel(GetIconString(controller->type, OpenRGBThemeManager::IsDarkTheme()), QString::fromStdString(controller->name), (char *)controller->name.c_str(), (char *)context);
 
-        for(int tab_idx = 0; tab_idx < ui->InformationTabBar->count(); tab_idx++)
-        {
-            /*-----------------------------------------------------*\
-            | If type is a device info page, check it               |
-            \*-----------------------------------------------------*/
-            std::string type_str = ui->InformationTabBar->widget(tab_idx)->metaObject()->className();
-            if(type_str == "Ui::OpenRGBDeviceInfoPage")
-            {
-                OpenRGBDeviceInfoPage* page = (OpenRGBDeviceInfoPage*) ui->InformationTabBar->widget(tab_idx);
+        tab_bars[bar_idx]->tabBar()->setTabButton(tab_bars[bar_idx]->count() - 1, QTabBar::LeftSide, NewTabLabel);
+        tab_bars[bar_idx]->tabBar()->setTabToolTip(tab_bars[bar_idx]->count() - 1, QString::fromStdString(controller->name));
 
-                /*-----------------------------------------------------*\
-                | If the current tab matches the current controller,    |
-                | move the tab to the correct position                  |
-                \*-----------------------------------------------------*/
-                if(controllers[controller_idx] == page->GetController())
-                {
-                    found = true;
-                    ui->InformationTabBar->tabBar()->moveTab(tab_idx, controller_idx);
-                    break;
-                }
-            }
-        }
+        (*tab_maps[bar_idx])[controller]    = placeholder;
+        placeholder_tabs[placeholder]       = controller;
+    }
+}
+
+void OpenRGBDialog2::RemoveDeviceTabs(RGBController* controller)
+{
+    QTabWidget*                                     tab_bars[2] = { ui->DevicesTabBar, ui->InformationTabBar };
+    std::unordered_map<RGBController*, QWidget*>*   tab_maps[2] = { &device_tabs, &information_tabs };
+
+    for(unsigned int bar_idx = 0; bar_idx < 2; bar_idx++)
+    {
+        std::unordered_map<RGBController*, QWidget*>::iterator it = tab_maps[bar_idx]->find(controller);
 
-        if(!found)
+        if(it == tab_maps[bar_idx]->end())
         {
-            /*-----------------------------------------------------*\
-            | The controller does not have a tab already created    |
-            | Create a new tab and move it to the correct position  |
-            \*-----------------------------------------------------*/
-            OpenRGBDeviceInfoPage *NewPage = new OpenRGBDeviceInfoPage(controllers[controller_idx]);
-            ui->InformationTabBar->addTab(NewPage, "");
+            continue;
+        }
 
-            /*-----------------------------------------------------*\
-            | Create the tab label                                  |
-            \*-----------------------------------------------------*/
-            TabLabel* NewTabLabel = new TabLabel(GetIconString(controllers[controller_idx]->type, OpenRGBThemeManager::IsDarkTheme()), QString::fromStdString(controllers[controller_idx]->name), (char *)controllers[controller_idx]->name.c_str(), (char *)context);
+        QWidget* tab_widget = it->second;
 
-            ui->InformationTabBar->tabBar()->setTabButton(ui->InformationTabBar->count() - 1, QTabBar::LeftSide, NewTabLabel);
-            ui->InformationTabBar->tabBar()->setTabToolTip(ui->InformationTabBar->count() - 1, QString::fromStdString(controllers[controller_idx]->name));
+        tab_bars[bar_idx]->removeTab(tab_bars[bar_idx]->indexOf(tab_widget));
 
-            /*-----------------------------------------------------*\
-            | Now move the new tab to the correct position          |
-            \*-----------------------------------------------------*/
-            ui->InformationTabBar->tabBar()->moveTab(ui->InformationTabBar->count() - 1, controller_idx);
-        }
+        placeholder_tabs.erase(tab_widget);
+        tab_maps[bar_idx]->erase(it);
+
+        delete tab_widget;
     }
+}
 
-    /*-----------------------------------------------------*\
-    | Remove all remaining device tabs                      |
-    \*-----------------------------------------------------*/
-    unsigned int tab_count = ui->DevicesTabBar->count();
-    unsigned int base_tab = (unsigned int)controllers.size();
+RGBController* OpenRGBDialog2::GetPlaceholderController(QWidget* tab_widget)
+{
+    std::unordered_map<QWidget*, RGBController*>::iterator it = placeholder_tabs.find(tab_widget);
 
-    for(std::size_t tab_idx = controllers.size(); tab_idx < tab_count; tab_idx++)
+    if(it == placeholder_tabs.end())
     {
-        QWidget* tab_widget = ui->DevicesTabBar->widget(base_tab);
+        return(nullptr);
+    }
 
-        if(dynamic_cast<OpenRGBPluginContainer*>(tab_widget) == nullptr)
-        {
-            ui->DevicesTabBar->removeTab(base_tab);
-            delete tab_widget;
-        }
+    return(it->second);
+}
+
+void OpenRGBDialog2::MaterializeDeviceTab(QTabWidget* tab_bar, int tab_idx)
+{
+    if(tab_idx < 0)
+    {
+        return;
     }
 
-    bool found = true;
+    QWidget*        placeholder = tab_bar->widget(tab_idx);
+    RGBController*  controller  = GetPlaceholderController(placeholder);
 
-    while(found)
+    if(controller == nullptr)
     {
-        found = false;
+        return;
+    }
+
+    /*-----------------------------------------------------*\
+    | Create the real page for this tab                     |
+    \*-----------------------------------------------------*/
+    QWidget* page;
+
+    if(tab_bar == ui->DevicesTabBar)
+    {
+        OpenRGBDevicePage *NewPage = new OpenRGBDevicePage(controller);
 
         /*-----------------------------------------------------*\
-        | Remove all remaining device information tabs, leaving |
-        | other information tabs alone                          |
+        | Connect the page's Set All button to the Set All slot |
         \*-----------------------------------------------------*/
-        for(int tab_idx = controllers.size(); tab_idx < ui->InformationTabBar->count(); tab_idx++)
-        {
-            std::string type_str = ui->InformationTabBar->widget(base_tab)->metaObject()->className();
-            if(type_str == "Ui::OpenRGBDeviceInfoPage")
-            {
-                found = true;
-                QWidget* tab_widget = ui->InformationTabBar->widget(base_tab);
+        connect(NewPage,
+                SIGNAL(SetAllDevices(unsigned char, unsigned char, unsigned char)),
+                this,
+                SLOT(on_SetAllDevices(unsigned char, unsigned char, unsigned char)));
 
-                ui->InformationTabBar->removeTab(base_tab);
+        /*-----------------------------------------------------*\
+        | Connect the page's Resize signal to the Save Size slot|
+        \*-----------------------------------------------------*/
+        connect(NewPage,
+                SIGNAL(SaveSizeProfile()),
+                this,
+                SLOT(on_SaveSizeProfile()));
 
-                delete tab_widget;
-                break;
-            }
-            base_tab += 1;
-        }
+        device_tabs[controller]         = NewPage;
+        page                            = NewPage;
+    }
+    else
+    {
+        OpenRGBDeviceInfoPage *NewPage  = new OpenRGBDeviceInfoPage(controller);
+
+        information_tabs[controller]    = NewPage;
+        page                            = NewPage;
+    }
+
+    /*-----------------------------------------------------*\
+    | Swap the page in for the placeholder at the same      |
+    | position, keeping the current tab selected            |
+    \*-----------------------------------------------------*/
+    bool current = (tab_bar->currentIndex() == tab_idx);
+
+    tab_bar->blockSignals(true);
+    tab_bar->insertTab(tab_idx, page, "");
+
+    /*-----------------------------------------------------*\
+    | Create the tab label                                  |
+    \*-----------------------------------------------------*/
+    TabLabel* NewTabLabel = new TabLabel(GetIconString(controller->type, OpenRGBThemeManager::IsDarkTheme()), QString::fromStdString(controller->name), (char *)controller->name.c_str(), (char *)context);
+
+    tab_bar->tabBar()->setTabButton(tab_idx, QTabBar::LeftSide, NewTabLabel);
+    tab_bar->tabBar()->setTabToolTip(tab_idx, QString::fromStdString(controller->name));
+
+    tab_bar->removeTab(tab_idx + 1);
+
+    if(current)
+    {
+        tab_bar->setCurrentIndex(tab_idx);
+    }
+
+    tab_bar->blockSignals(false);
+
+    placeholder_tabs.erase(placeholder);
+    delete placeholder;
+}
+
+void OpenRGBDialog2::UpdateDeviceTab(int tab_idx)
+{
+    /*-----------------------------------------------------*\
+    | Pages that have not been built yet have no UI state   |
+    | to refresh, so apply the device's mode directly       |
+    \*-----------------------------------------------------*/
+    RGBController* controller = GetPlaceholderController(ui->DevicesTabBar->widget(tab_idx));
+
+    if(controller != nullptr)
+    {
+        controller->UpdateMode();
+        return;
+    }
+
+    OpenRGBDevicePage* device_page = qobject_cast<OpenRGBDevicePage *>(ui->DevicesTabBar->widget(tab_idx));
+    if(device_page) // Check the cast to make sure it is a device and not plugin
+    {
+        device_page->UpdateDevice();
     }
 }
 
@@ -1631,7 +1690,13 @@ void OpenRGBDialog2::on_SetAllDevices(unsigned char red, unsigned char green, un
 {
     for(int device = 0; device < ui->DevicesTabBar->count(); device++)
     {
-        qobject_cast<OpenRGBDevicePage *>(ui->DevicesTabBar->widget(device))->SetCustomMode(red, green, blue);
+        MaterializeDeviceTab(ui->DevicesTabBar, device);
+
+        OpenRGBDevicePage* device_page = qobject_cast<OpenRGBDevicePage *>(ui->DevicesTabBar->widget(device));
+        if(device_page) // Check the cast to make sure it is a device and not plugin
+        {
+            device_page->SetCustomMode(red, green, blue);
+        }
     }
 }
 
@@ -1764,7 +1829,7 @@ void Ui::OpenRGBDialog2::on_ProfileSelected()
         {
             for(int device = 0; device < ui->DevicesTabBar->count(); device++)
             {
-                qobject_cast<OpenRGBDevicePage *>(ui->DevicesTabBar->widget(device))->UpdateDevice();
+                UpdateDeviceTab(device);
             }
         }
 
@@ -1790,7 +1855,7 @@ void Ui::OpenRGBDialog2::on_ButtonLoadProfile_clicked()
         {
             for(int device = 0; device < ui->DevicesTabBar->count(); device++)
             {
-                qobject_cast<OpenRGBDevicePage *>(ui->DevicesTabBar->widget(device))->UpdateDevice();
+                UpdateDeviceTab(device);
             }
         }
     }
@@ -1831,7 +1896,11 @@ void Ui::OpenRGBDialog2::on_ButtonToggleDeviceView_clicked()
     {
         for(int device = 0; device < ui->DevicesTabBar->count(); device++)
         {
-            qobject_cast<OpenRGBDevicePage *>(ui->DevicesTabBar->widget(device))->HideDeviceView();
+            OpenRGBDevicePage* device_page = qobject_cast<OpenRGBDevicePage *>(ui->DevicesTabBar->widget(device));
+            if(device_page) // Check the cast to make sure it is a device and not plugin
+            {
+                device_page->HideDeviceView();
+            }
         }
         device_view_showing = false;
     }
@@ -2009,11 +2078,13 @@ void Ui::OpenRGBDialog2::on_ActionSaveProfileAs_triggered()
 
 void Ui::OpenRGBDialog2::on_InformationTabBar_currentChanged(int tab_idx)
 {
+    MaterializeDeviceTab(ui->InformationTabBar, tab_idx);
     TogglePluginsVisibility(tab_idx, ui->InformationTabBar);
 }
 
 void Ui::OpenRGBDialog2::on_DevicesTabBar_currentChanged(int tab_idx)
 {
+    MaterializeDeviceTab(ui->DevicesTabBar, tab_idx);
     TogglePluginsVisibility(tab_idx, ui->DevicesTabBar);
 }
 
@@ -22,6 +22,7 @@
 #include "OpenRGBNanoleafSettingsPage/OpenRGBNanoleafSettingsPage.h"
 #include "PluginManager.h"
 
+#include <unordered_map>
 #include <vector>
 #include "i2c_smbus.h"
 #include "LogManager.h"
@@ -130,6 +131,11 @@ private:
 
     void ClearDevicesList();
     void UpdateDevicesList();
+    void AddDeviceTabs(RGBController* controller);
+    void RemoveDeviceTabs(RGBController* controller);
+    void MaterializeDeviceTab(QTabWidget* tab_bar, int tab_idx);
+    void UpdateDeviceTab(int tab_idx);
+    RGBController* GetPlaceholderController(QWidget* tab_widget);
     void UpdateProfileList();
     void closeEvent(QCloseEvent *event);
     void LoadExitProfile();
@@ -142,6 +148,16 @@ private:
 
     bool device_view_showing = false;
 
+    /*-------------------------------------*\
+    | Device tabs by controller.  Entries   |
+    | point to a lightweight placeholder    |
+    | until the tab is first shown, when    |
+    | the real page replaces it             |
+    \*-------------------------------------*/
+    std::unordered_map<RGBController*, QWidget*>    device_tabs;
+    std::unordered_map<RGBController*, QWidget*>    information_tabs;
+    std::unordered_map<QWidget*, RGBController*>    placeholder_tabs;
+
     PluginManager* plugin_manager = nullptr;
 
     QAction* actionExit;
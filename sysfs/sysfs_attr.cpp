@@ -0,0 +1,76 @@
+/*---------------------------------------------------------*\
+|  sysfs_attr.cpp                                           |
+|                                                           |
+|  Persistent file descriptor for a Linux sysfs attribute.  |
+|  Each write is issued as a single syscall at offset zero  |
+|  so that one store() call in the driver receives the      |
+|  whole buffer                                             |
+\*---------------------------------------------------------*/
+
+#include "sysfs_attr.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+sysfs_attr::sysfs_attr()
+{
+    fd = -1;
+}
+
+sysfs_attr::~sysfs_attr()
+{
+    close();
+}
+
+bool sysfs_attr::open(const std::string& path)
+{
+    close();
+
+    fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+
+    return(fd >= 0);
+}
+
+void sysfs_attr::close()
+{
+    if(fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool sysfs_attr::is_open() const
+{
+    return(fd >= 0);
+}
+
+sysfs_attr::operator bool() const
+{
+    return(fd >= 0);
+}
+
+int sysfs_attr::write(const char* buffer, std::size_t length)
+{
+    if(fd < 0)
+    {
+        return(-1);
+    }
+
+    /*-----------------------------------------------------*\
+    | sysfs ignores the file offset, but pwrite at zero     |
+    | keeps regular files (e.g. a fake tree on tmpfs) from  |
+    | growing with every frame                              |
+    \*-----------------------------------------------------*/
+    return((int)pwrite(fd, buffer, length, 0));
+}
+
+int sysfs_attr::writev(const struct iovec* iov, int iovcnt)
+{
+    if(fd < 0)
+    {
+        return(-1);
+    }
+
+    return((int)pwritev(fd, iov, iovcnt, 0));
+}
@@ -0,0 +1,44 @@
+/*---------------------------------------------------------*\
+|  sysfs_attr.h                                             |
+|                                                           |
+|  Persistent file descriptor for a Linux sysfs attribute.  |
+|  Each write is issued as a single syscall at offset zero  |
+|  so that one store() call in the driver receives the      |
+|  whole buffer                                             |
+\*---------------------------------------------------------*/
+
+#pragma once
+
+#include <string>
+#include <sys/uio.h>
+
+class sysfs_attr
+{
+public:
+    sysfs_attr();
+    ~sysfs_attr();
+
+    sysfs_attr(const sysfs_attr&)               = delete;
+    sysfs_attr& operator=(const sysfs_attr&)    = delete;
+
+    bool            open(const std::string& path);
+    void            close();
+    bool            is_open() const;
+
+    explicit        operator bool() const;
+
+    /*-----------------------------------------------------*\
+    | Write a buffer in a single syscall                    |
+    \*-----------------------------------------------------*/
+    int             write(const char* buffer, std::size_t length);
+
+    /*-----------------------------------------------------*\
+    | Gather-write several buffers in a single syscall, for |
+    | attributes that accept a concatenated payload but     |
+    | whose pieces are built separately                     |
+    \*-----------------------------------------------------*/
+    int             writev(const struct iovec* iov, int iovcnt);
+
+private:
+    int             fd;
+};